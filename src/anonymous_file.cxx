@@ -0,0 +1,52 @@
+/*
+ * anonymous_file.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "anonymous_file.hxx"
+
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <cstdlib>
+#include <cerrno>
+
+#include <string>
+#include <vector>
+
+namespace page {
+
+using namespace std;
+
+int create_anonymous_file(char const * prefix, off_t size) {
+	char const * path = getenv("XDG_RUNTIME_DIR");
+	if(path == nullptr) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	string name = string{path} + "/" + prefix + "-XXXXXX";
+	vector<char> tmp{name.begin(), name.end()};
+	tmp.push_back(0);
+
+	int fd = mkstemp(&tmp[0]);
+	if(fd < 0)
+		return -1;
+	unlink(&tmp[0]);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+	if(ftruncate(fd, size) < 0) {
+		int err = errno;
+		close(fd);
+		errno = err;
+		return -1;
+	}
+
+	return fd;
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+ * anonymous_file.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Shm backing files for the client tools, page-replay and page-loadgen.
+ *
+ */
+
+#ifndef SRC_ANONYMOUS_FILE_HXX_
+#define SRC_ANONYMOUS_FILE_HXX_
+
+#include <sys/types.h>
+
+namespace page {
+
+/* create an unlinked close-on-exec file of size bytes in XDG_RUNTIME_DIR,
+ * named after prefix while it exists. return -1 and set errno on failure */
+int create_anonymous_file(char const * prefix, off_t size);
+
+}
+
+#endif /* SRC_ANONYMOUS_FILE_HXX_ */
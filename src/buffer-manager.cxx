@@ -26,7 +26,6 @@
 #include <sys/mman.h>
 #include <wayland-client.h>
 #include <compositor.h>
-#include <cairo.h>
 #include <wayland-cursor.h>
 #include <cstdlib>
 
@@ -158,6 +157,62 @@ static const struct cursor_alternatives cursors[] = {
 	{forbidden_draggings, ARRAY_LENGTH(forbidden_draggings)},
 };
 
+static_assert(ARRAY_LENGTH(cursors) == CURSOR_COUNT,
+		"the cursors table must follow cursor_shape_e");
+
+static void cursor_frame_done(void *data, struct wl_callback *callback,
+		uint32_t time);
+
+static const struct wl_callback_listener cursor_frame_listener = {
+	cursor_frame_done
+};
+
+static void
+cursor_request_frame(cursor_data_t *c)
+{
+	c->frame = wl_surface_frame(c->surface);
+	wl_callback_add_listener(c->frame, &cursor_frame_listener, c);
+}
+
+/*
+ * The compositor only send frame callbacks while the cursor is shown, hidden
+ * animated cursors do not wake up this thread.
+ */
+static void
+cursor_frame_done(void *data, struct wl_callback *callback, uint32_t time)
+{
+	cursor_data_t * c = reinterpret_cast<cursor_data_t*>(data);
+
+	wl_callback_destroy(callback);
+	c->frame = NULL;
+
+	if (!c->has_start_time) {
+		c->start_time = time;
+		c->has_start_time = true;
+	}
+
+	unsigned i = wl_cursor_frame(c->cursor, time - c->start_time);
+	cursor_request_frame(c);
+
+	if (i != c->current_image && c->buffers[i]) {
+		auto prev = c->cursor->images[c->current_image];
+		auto next = c->cursor->images[i];
+		/* the offset move the hotspot of the compositor */
+		wl_surface_attach(c->surface, c->buffers[i],
+				  prev->hotspot_x - next->hotspot_x,
+				  prev->hotspot_y - next->hotspot_y);
+		wl_surface_damage(c->surface, 0, 0, next->width, next->height);
+		c->current_image = i;
+	}
+
+	wl_surface_commit(c->surface);
+}
+
+/*
+ * Create the buffers of all images and one surface per shape, then commit
+ * the first image once. The compositor switch shapes by swapping the pointer
+ * sprite, without any attach nor damage.
+ */
 static void
 create_cursors(buffer_manager_t *bm)
 {
@@ -169,33 +224,65 @@ create_cursors(buffer_manager_t *bm)
 		fprintf(stderr, "could not load theme '%s'\n", "null");
 		return;
 	}
-	bm->cursors = reinterpret_cast<wl_cursor **>(
-		malloc(ARRAY_LENGTH(cursors) * sizeof(bm->cursors[0])));
 
-	for (i = 0; i < ARRAY_LENGTH(cursors); i++) {
-		bm->cursors[i] = NULL;
+	for (i = 0; i < CURSOR_COUNT; i++) {
+		cursor_data_t & c = bm->cursors[i];
+		c.bm = bm;
+		c.cursor = NULL;
+		c.surface = NULL;
+		c.frame = NULL;
+		c.current_image = 0;
+		c.has_start_time = false;
+
 		cursor = NULL;
 		for (j = 0; !cursor && j < cursors[i].count; ++j)
 			cursor = wl_cursor_theme_get_cursor(
 			    bm->cursor_theme, cursors[i].names[j]);
 
-		if (!cursor)
+		if (!cursor) {
 			fprintf(stderr, "could not load cursor '%s'\n",
 				cursors[i].names[0]);
+			continue;
+		}
 
-		bm->cursors[i] = cursor;
+		c.cursor = cursor;
+		c.buffers.resize(cursor->image_count);
+		for (j = 0; j < cursor->image_count; ++j)
+			c.buffers[j] = wl_cursor_image_get_buffer(cursor->images[j]);
+
+		if (!c.buffers[0] || !bm->buffer_manager)
+			continue;
+
+		auto image = cursor->images[0];
+		c.surface = wl_compositor_create_surface(bm->compositor);
+		wl_surface_attach(c.surface, c.buffers[0], 0, 0);
+		wl_surface_damage(c.surface, 0, 0, image->width, image->height);
+		if (cursor->image_count > 1)
+			cursor_request_frame(&c);
+		wl_surface_commit(c.surface);
+
+		zzz_buffer_manager_ack_cursor(bm->buffer_manager, i, c.surface,
+				image->hotspot_x, image->hotspot_y);
 	}
 }
 
 static void
 destroy_cursors(buffer_manager_t *bm)
 {
-	wl_cursor_theme_destroy(bm->cursor_theme);
-	free(bm->cursors);
+	for (auto & c: bm->cursors) {
+		if (c.frame)
+			wl_callback_destroy(c.frame);
+		if (c.surface)
+			wl_surface_destroy(c.surface);
+	}
+
+	if (bm->cursor_theme)
+		wl_cursor_theme_destroy(bm->cursor_theme);
 }
 
 
 
+/* the compositor show the cursor of its own surfaces */
 static
 void pointer_enter(void *data,
 	      struct wl_pointer *wl_pointer,
@@ -203,23 +290,7 @@ void pointer_enter(void *data,
 	      struct wl_surface *surface,
 	      wl_fixed_t surface_x,
 	      wl_fixed_t surface_y) {
-	buffer_manager_t * bm = reinterpret_cast<buffer_manager_t*>(data);
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-
-	auto cursor = bm->cursors[4];
-	auto image = cursor->images[0];
-	auto buffer = wl_cursor_image_get_buffer(image);
-	if (!buffer)
-		return;
-
-	wl_surface_attach(bm->pointer_data.surface, buffer, 0, 0);
-	wl_surface_damage(bm->pointer_data.surface, 0, 0,
-			  image->width, image->height);
-	wl_surface_commit(bm->pointer_data.surface);
-	wl_pointer_set_cursor(wl_pointer, serial,
-				  bm->pointer_data.surface,
-			      image->hotspot_x, image->hotspot_y);
-
 }
 
 static
@@ -532,7 +603,9 @@ static void zzz_buffer_manager_get_buffer(void *data,
 		   struct zzz_buffer_manager *zzz_buffer_manager,
 		   uint32_t serial,
 		   uint32_t width,
-		   uint32_t height) {
+		   uint32_t height,
+		   uint32_t format,
+		   uint32_t scale) {
 
 	buffer_manager_t * bm = reinterpret_cast<buffer_manager_t*>(data);
 
@@ -543,7 +616,7 @@ static void zzz_buffer_manager_get_buffer(void *data,
 
 
 	ret = create_shm_buffer(bm, buffer,
-					width, height, WL_SHM_FORMAT_ARGB8888);
+					width, height, format);
 	if(ret) {
 		weston_log("cannot create buffer\n");
 	}
@@ -557,10 +630,14 @@ static void zzz_buffer_manager_get_buffer(void *data,
 	wl_surface_add_listener(buffer->surface, &surface_listener, bm);
 
 
+	wl_surface_set_buffer_scale(buffer->surface, scale);
 	wl_surface_attach(buffer->surface, buffer->buffer, 0, 0);
+	/* regions are in surface coordinates */
 	auto region = wl_compositor_create_region(bm->compositor);
-	wl_region_add(region, 0, 0, width, height);
-	wl_surface_set_opaque_region(buffer->surface, region);
+	wl_region_add(region, 0, 0, width / scale, height / scale);
+	/* the compositor set the accurate opaque region of argb buffers */
+	if(format == WL_SHM_FORMAT_XRGB8888)
+		wl_surface_set_opaque_region(buffer->surface, region);
 	wl_surface_set_input_region(buffer->surface, region);
 	wl_region_destroy(region);
 	wl_surface_commit(buffer->surface);
@@ -584,33 +661,20 @@ buffer_manager_global(void *data, struct wl_registry *registry, uint32_t id,
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 
     if (strcmp(interface, "zzz_buffer_manager") == 0
-    		&& version >= 1) {
+    		&& version >= 4) {
     	bm->buffer_manager = reinterpret_cast<zzz_buffer_manager*>(wl_registry_bind(registry, id,
-    			&zzz_buffer_manager_interface, 1));
+    			&zzz_buffer_manager_interface, 4));
     	zzz_buffer_manager_add_listener(bm->buffer_manager,
     			&_zzz_buffer_manager_listener, bm);
     } else if (strcmp(interface, "wl_shm") == 0) {
     	bm->shm = reinterpret_cast<wl_shm*>(wl_registry_bind(registry,
 					  id, &wl_shm_interface, 1));
 		wl_shm_add_listener(bm->shm, &buffer_manager_shm_listener, bm);
-		create_shm_buffer(bm, &bm->pointer_data,
-						16, 16, WL_SHM_FORMAT_ARGB8888);
-
-		cairo_surface_t * surf = cairo_image_surface_create_for_data(
-				(uint8_t*)bm->pointer_data.shm_data, CAIRO_FORMAT_ARGB32, 16, 16, 16*4);
-
-		cairo_t * cr = cairo_create(surf);
-		cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-		cairo_paint(cr);
-		cairo_destroy(cr);
-		cairo_surface_destroy(surf);
-
 	} else if (strcmp(interface, "wl_compositor") == 0) {
+		/* version 3 for wl_surface.set_buffer_scale */
 		bm->compositor =
 				reinterpret_cast<wl_compositor*>(wl_registry_bind(registry,
-					 id, &wl_compositor_interface, 1));
-
-		bm->pointer_data.surface = wl_compositor_create_surface(bm->compositor);
+					 id, &wl_compositor_interface, 3));
 
 	} else if (strcmp(interface, "wl_seat") == 0) {
 		bm->seat =
@@ -635,7 +699,7 @@ static const struct wl_registry_listener buffer_manager_global_listener = {
 };
 
 void buffer_manager_main(int fd) {
-	buffer_manager_t mgr;
+	buffer_manager_t mgr{};
 
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 
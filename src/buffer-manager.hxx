@@ -22,12 +22,16 @@
 #define SRC_BUFFER_MANAGER_HXX_
 
 #include <map>
+#include <vector>
 #include <wayland-client.h>
 #include <wayland-cursor.h>
 #include "buffer-manager-client-protocol.h"
+#include "cursor_shape.hxx"
 
 namespace page {
 
+struct buffer_manager_t;
+
 struct buffer_t {
 	wl_buffer * buffer;
 	void *shm_data;
@@ -35,6 +39,20 @@ struct buffer_t {
 	wl_surface * surface;
 };
 
+/* a cursor shape, committed once and shown by the compositor */
+struct cursor_data_t {
+	buffer_manager_t * bm;
+	wl_cursor * cursor;
+	wl_surface * surface;
+	/* one buffer per image, created at load */
+	std::vector<wl_buffer *> buffers;
+	/* animated cursors only */
+	wl_callback * frame;
+	unsigned current_image;
+	uint32_t start_time;
+	bool has_start_time;
+};
+
 struct buffer_manager_t {
 	wl_display * display;
 	wl_registry * registry;
@@ -46,12 +64,10 @@ struct buffer_manager_t {
 	zzz_buffer_manager * buffer_manager;
 
 	wl_cursor_theme * cursor_theme;
-	wl_cursor **cursors;
+	cursor_data_t cursors[CURSOR_COUNT];
 
 	bool has_argb;
 
-	buffer_t pointer_data;
-
 	std::map<uint32_t, buffer_t *> buffers;
 };
 
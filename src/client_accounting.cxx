@@ -0,0 +1,249 @@
+/*
+ * client_accounting.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "client_accounting.hxx"
+
+#include <wayland-server.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace page {
+
+using namespace std;
+
+static int64_t _buffer_size(weston_buffer * buffer) {
+	if(buffer == nullptr or buffer->resource == nullptr)
+		return 0;
+
+	auto shm = wl_shm_buffer_get(buffer->resource);
+	if(shm) {
+		return static_cast<int64_t>(wl_shm_buffer_get_stride(shm))
+				* wl_shm_buffer_get_height(shm);
+	}
+
+	/* assume 32 bits per pixels for non-shm buffers */
+	return static_cast<int64_t>(buffer->width) * buffer->height * 4;
+}
+
+client_usage_t::client_usage_t(wl_client * client) :
+	client{client},
+	pid{0},
+	internal{false},
+	shell_objects{0},
+	surfaces{0},
+	views{0},
+	pixmaps{0},
+	pixmap_bytes{0},
+	buffer_bytes{0},
+	over_limit{false}
+{
+	wl_client_get_credentials(client, &pid, nullptr, nullptr);
+}
+
+client_accounting_t::_surface_usage_t::_surface_usage_t(
+		client_accounting_t * owner,
+		wl_client * client,
+		weston_surface * surface) :
+	_owner{owner},
+	_client{client},
+	_surface{surface},
+	_buffer_bytes{0}
+{
+	on_commit.connect(&surface->commit_signal, this,
+			&_surface_usage_t::surface_commited);
+	on_destroy.connect(&surface->destroy_signal, this,
+			&_surface_usage_t::surface_destroyed);
+}
+
+void client_accounting_t::_surface_usage_t::surface_commited(weston_surface * s) {
+	int64_t bytes = _buffer_bytes;
+	if(s->buffer_ref.buffer) {
+		bytes = _buffer_size(s->buffer_ref.buffer);
+	} else if(not weston_surface_is_mapped(s)) {
+		bytes = 0;
+	}
+
+	if(bytes == _buffer_bytes)
+		return;
+
+	/* the client may already be gone, resources are destroyed after it */
+	auto u = _owner->_find(_client);
+	if(u) {
+		u->buffer_bytes += bytes - _buffer_bytes;
+		_owner->_check_limits(u);
+	}
+	_buffer_bytes = bytes;
+}
+
+void client_accounting_t::_surface_usage_t::surface_destroyed(weston_surface * s) {
+	auto u = _owner->_find(_client);
+	if(u) {
+		u->buffer_bytes -= _buffer_bytes;
+		u->surfaces -= 1;
+		_owner->_check_limits(u);
+	}
+	/* this will delete this, do not use this after */
+	_owner->_surfaces.erase(_surface);
+}
+
+client_accounting_t::client_accounting_t() :
+	_internal_client{nullptr}
+{
+
+}
+
+client_accounting_t::~client_accounting_t() {
+	_surfaces.clear();
+	_clients.clear();
+}
+
+void client_accounting_t::start(weston_compositor * ec) {
+	_on_create_surface.connect(&ec->create_surface_signal, this,
+			&client_accounting_t::_surface_created);
+}
+
+void client_accounting_t::set_internal_client(wl_client * client) {
+	_internal_client = client;
+	_get(client)->internal = true;
+}
+
+auto client_accounting_t::_find(wl_client * client) const -> client_usage_t * {
+	auto x = _clients.find(client);
+	if(x == _clients.end())
+		return nullptr;
+	return x->second.get();
+}
+
+auto client_accounting_t::_get(wl_client * client) -> client_usage_t * {
+	auto u = _find(client);
+	if(u)
+		return u;
+
+	auto x = make_shared<client_usage_t>(client);
+	x->internal = (client == _internal_client);
+	x->on_client_destroy.client_add_destroy_listener(client, this,
+			&client_accounting_t::_client_destroyed);
+	_clients[client] = x;
+	return x.get();
+}
+
+void client_accounting_t::_check_limits(client_usage_t * u) {
+	if(u->internal)
+		return;
+
+	bool over = false;
+	if(limits.max_surfaces > 0 and u->surfaces > limits.max_surfaces)
+		over = true;
+	if(limits.max_buffer_bytes > 0 and u->buffer_bytes > limits.max_buffer_bytes)
+		over = true;
+
+	if(over and not u->over_limit) {
+		weston_log("client %p (pid %d) is over limits: %d surfaces, %ld buffer bytes\n",
+				u->client, u->pid, u->surfaces, static_cast<long>(u->buffer_bytes));
+		if(limits.disconnect) {
+			/* the client will disconnect on the error, do not destroy it here */
+			wl_client_post_no_memory(u->client);
+		}
+	}
+
+	u->over_limit = over;
+}
+
+void client_accounting_t::_surface_created(weston_surface * s) {
+	if(s->resource == nullptr)
+		return;
+
+	auto client = wl_resource_get_client(s->resource);
+	auto u = _get(client);
+	u->surfaces += 1;
+	_surfaces[s] = make_shared<_surface_usage_t>(this, client, s);
+	_check_limits(u);
+}
+
+void client_accounting_t::_client_destroyed(wl_client * c) {
+	on_client_destroy.signal(c);
+	_clients.erase(c);
+}
+
+void client_accounting_t::shell_bound(wl_client * client) {
+	_get(client)->shell_objects += 1;
+}
+
+void client_accounting_t::shell_released(wl_client * client) {
+	auto u = _find(client);
+	if(u)
+		u->shell_objects -= 1;
+}
+
+void client_accounting_t::view_created(wl_client * client) {
+	_get(client)->views += 1;
+}
+
+void client_accounting_t::view_destroyed(wl_client * client) {
+	auto u = _find(client);
+	if(u)
+		u->views -= 1;
+}
+
+void client_accounting_t::pixmap_created(int64_t bytes) {
+	if(_internal_client == nullptr)
+		return;
+	auto u = _get(_internal_client);
+	u->pixmaps += 1;
+	u->pixmap_bytes += bytes;
+}
+
+void client_accounting_t::pixmap_destroyed(int64_t bytes) {
+	auto u = _find(_internal_client);
+	if(u == nullptr)
+		return;
+	u->pixmaps -= 1;
+	u->pixmap_bytes -= bytes;
+}
+
+auto client_accounting_t::find(wl_client * client) const -> client_usage_t const * {
+	return _find(client);
+}
+
+void client_accounting_t::dump() const {
+	int64_t total = 0;
+	weston_log("client accounting: %lu clients\n", _clients.size());
+	for(auto & x: _clients) {
+		auto & u = x.second;
+		weston_log("client %p pid=%d%s shell=%d surfaces=%d views=%d pixmaps=%d (%ld bytes) buffers=%ld bytes%s\n",
+				u->client, u->pid, u->internal?" (page)":"", u->shell_objects,
+				u->surfaces, u->views, u->pixmaps,
+				static_cast<long>(u->pixmap_bytes),
+				static_cast<long>(u->buffer_bytes),
+				u->over_limit?" OVER LIMIT":"");
+		/* pixmaps are backed by the internal client buffers */
+		total += u->buffer_bytes;
+	}
+	weston_log("client accounting: %ld bytes total\n", static_cast<long>(total));
+}
+
+void client_accounting_t::write_summary(FILE * f) const {
+	vector<string> lines;
+	for(auto & x: _clients) {
+		auto & u = x.second;
+		lines.push_back(xformat("client%s shell=%d surfaces=%d views=%d pixmaps=%d (%ld bytes) buffers=%ld bytes%s",
+				u->internal?" (page)":"", u->shell_objects, u->surfaces,
+				u->views, u->pixmaps, static_cast<long>(u->pixmap_bytes),
+				static_cast<long>(u->buffer_bytes),
+				u->over_limit?" OVER LIMIT":""));
+	}
+
+	sort(lines.begin(), lines.end());
+	for(auto & l: lines)
+		fprintf(f, "%s\n", l.c_str());
+}
+
+}
@@ -0,0 +1,134 @@
+/*
+ * client_accounting.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Track what each wayland client cost to the compositor (surfaces, buffers,
+ * views, shell objects) and warn or disconnect clients that go over the
+ * configured soft limits.
+ *
+ */
+
+#ifndef SRC_CLIENT_ACCOUNTING_HXX_
+#define SRC_CLIENT_ACCOUNTING_HXX_
+
+#include <sys/types.h>
+
+#include <cstdio>
+#include <memory>
+#include <map>
+
+#include <compositor.h>
+
+#include "utils.hxx"
+#include "listener.hxx"
+
+namespace page {
+
+using namespace std;
+
+struct client_usage_t {
+	wl_client * client;
+	pid_t pid;
+
+	/* the compositor internal client, i.e. the buffer manager */
+	bool internal;
+
+	int32_t shell_objects;
+	int32_t surfaces;
+	int32_t views;
+	int32_t pixmaps;
+	int64_t pixmap_bytes;
+	int64_t buffer_bytes;
+
+	/* true once the client crossed a limit, avoid warning flood */
+	bool over_limit;
+
+	listener_t<wl_client> on_client_destroy;
+
+	client_usage_t(wl_client * client);
+
+};
+
+/**
+ * Soft limits per client, 0 means unlimited.
+ **/
+struct client_limits_t {
+	int32_t max_surfaces;
+	int64_t max_buffer_bytes;
+	bool disconnect;
+
+	client_limits_t() :
+		max_surfaces{0},
+		max_buffer_bytes{0},
+		disconnect{false}
+	{ }
+
+};
+
+class client_accounting_t {
+
+	struct _surface_usage_t {
+		client_accounting_t * _owner;
+		wl_client * _client;
+		weston_surface * _surface;
+		int64_t _buffer_bytes;
+
+		listener_t<weston_surface> on_commit;
+		listener_t<weston_surface> on_destroy;
+
+		_surface_usage_t(client_accounting_t * owner, wl_client * client, weston_surface * surface);
+
+		void surface_commited(weston_surface * s);
+		void surface_destroyed(weston_surface * s);
+
+	};
+
+	map<wl_client *, shared_ptr<client_usage_t>> _clients;
+	map<weston_surface *, shared_ptr<_surface_usage_t>> _surfaces;
+
+	wl_client * _internal_client;
+
+	listener_t<weston_surface> _on_create_surface;
+
+	auto _get(wl_client * client) -> client_usage_t *;
+	auto _find(wl_client * client) const -> client_usage_t *;
+	void _check_limits(client_usage_t * u);
+
+	void _surface_created(weston_surface * s);
+	void _client_destroyed(wl_client * c);
+
+	client_accounting_t(client_accounting_t const &) = delete;
+	client_accounting_t & operator=(client_accounting_t const &) = delete;
+
+public:
+	client_limits_t limits;
+
+	/* emitted before the client resources are released */
+	signal_t<wl_client *> on_client_destroy;
+
+	client_accounting_t();
+	~client_accounting_t();
+
+	void start(weston_compositor * ec);
+	void set_internal_client(wl_client * client);
+
+	void shell_bound(wl_client * client);
+	void shell_released(wl_client * client);
+	void view_created(wl_client * client);
+	void view_destroyed(wl_client * client);
+	void pixmap_created(int64_t bytes);
+	void pixmap_destroyed(int64_t bytes);
+
+	auto find(wl_client * client) const -> client_usage_t const *;
+	void dump() const;
+	/* like dump without pointers nor pids, sorted, thus runs can be diffed */
+	void write_summary(FILE * f) const;
+
+};
+
+}
+
+#endif /* SRC_CLIENT_ACCOUNTING_HXX_ */
@@ -97,6 +97,17 @@ bool config_handler_t::has_key(char const * group, char const * key) const {
 	return true;
 }
 
+bool config_handler_t::same_group(config_handler_t const & x, char const * group) const {
+	auto a = _data.lower_bound(_key_t(group, ""));
+	auto b = x._data.lower_bound(_key_t(group, ""));
+	while(a != _data.end() and a->first.first == group) {
+		if(b == x._data.end() or b->first != a->first or b->second != a->second)
+			return false;
+		++a; ++b;
+	}
+	return b == x._data.end() or b->first.first != group;
+}
+
 std::string const & config_handler_t::find(char const * group, char const * key) const {
 	auto x = _data.find(_key_t(group, key));
 	if(x == _data.end())
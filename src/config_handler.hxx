@@ -36,6 +36,9 @@ public:
 	long get_long(char const * group, char const * key) const;
 	std::string get_value(char const * group, char const * key) const;
 
+	/* true if both handlers hold the same keys and values for group */
+	bool same_group(config_handler_t const & x, char const * group) const;
+
 };
 
 
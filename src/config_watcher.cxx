@@ -0,0 +1,198 @@
+/*
+ * config_watcher.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "config_watcher.hxx"
+
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <libgen.h>
+
+#include <compositor.h>
+
+#include <cstring>
+#include <cerrno>
+
+namespace page {
+
+using namespace std;
+
+/* editors often write a file in several steps, wait them to settle */
+static int const _settle_delay = 200;
+
+static uint32_t const _inotify_mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE
+		| IN_DELETE | IN_MOVED_FROM;
+
+config_watcher_t::config_watcher_t() :
+	_inotify_fd{-1},
+	_notify_fd{-1},
+	_stop_fd{-1},
+	_source{nullptr}
+{
+
+}
+
+config_watcher_t::~config_watcher_t() {
+	stop();
+}
+
+void config_watcher_t::start(wl_event_loop * loop, vector<string> const & files) {
+	stop();
+
+	_files = files;
+	_inotify_fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+	if(_inotify_fd < 0) {
+		weston_log("config watcher: inotify not available, hot reload disabled\n");
+		return;
+	}
+
+	_notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	_stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	/* watch directories, files may not exist yet or be replaced by rename */
+	_watches.clear();
+	for(auto & f: _files) {
+		vector<char> dir{f.begin(), f.end()};
+		dir.push_back(0);
+		vector<char> base{dir};
+		int wd = inotify_add_watch(_inotify_fd, dirname(&dir[0]), _inotify_mask);
+		if(wd < 0)
+			continue;
+		_watches.push_back(_watch_t{wd, basename(&base[0])});
+	}
+
+	_source = wl_event_loop_add_fd(loop, _notify_fd, WL_EVENT_READABLE,
+			[](int fd, uint32_t mask, void * data) -> int {
+		reinterpret_cast<config_watcher_t *>(data)->_dispatch();
+		return 0;
+	}, this);
+
+	_thread = thread{&config_watcher_t::_run, this};
+}
+
+void config_watcher_t::stop() {
+	if(_thread.joinable()) {
+		if(not eventfd_notify(_stop_fd))
+			weston_log("config watcher: cannot wake up the watcher thread: %m\n");
+		_thread.join();
+	}
+
+	if(_source) {
+		wl_event_source_remove(_source);
+		_source = nullptr;
+	}
+
+	for(auto fd: {&_inotify_fd, &_notify_fd, &_stop_fd}) {
+		if(*fd >= 0)
+			close(*fd);
+		*fd = -1;
+	}
+
+	_watches.clear();
+}
+
+/**
+ * Wait for inotify events, return 1 if one of the configuration files
+ * changed, 0 on timeout and -1 if the watcher must stop.
+ **/
+int config_watcher_t::_wait_changes(int timeout) {
+	pollfd fds[2] = {
+		{_inotify_fd, POLLIN, 0},
+		{_stop_fd, POLLIN, 0}
+	};
+
+	int n = poll(fds, 2, timeout);
+	if(n < 0)
+		return (errno == EINTR)?0:-1;
+	if(fds[1].revents)
+		return -1;
+	if(n == 0)
+		return 0;
+
+	/* inotify_event are aligned within the buffer */
+	alignas(inotify_event) char buf[4096];
+	bool changed = false;
+	ssize_t len;
+	while((len = read(_inotify_fd, buf, sizeof(buf))) > 0) {
+		for(char * p = buf; p < buf + len;) {
+			auto ev = reinterpret_cast<inotify_event *>(p);
+			p += sizeof(inotify_event) + ev->len;
+			if(ev->len == 0)
+				continue;
+			for(auto & w: _watches) {
+				if(w.wd == ev->wd and w.name == ev->name)
+					changed = true;
+			}
+		}
+	}
+
+	return changed?1:0;
+}
+
+void config_watcher_t::_run() {
+	for(;;) {
+		int r;
+		while((r = _wait_changes(-1)) == 0)
+			continue;
+		if(r < 0)
+			return;
+
+		while((r = _wait_changes(_settle_delay)) > 0)
+			continue;
+		if(r < 0)
+			return;
+
+		_reload();
+	}
+}
+
+void config_watcher_t::_reload() {
+	page_config_p c;
+	string error;
+
+	try {
+		c = page_config_t::load(_files);
+	} catch(exception & e) {
+		error = e.what();
+	}
+
+	{
+		lock_guard<mutex> lock{_pending_lock};
+		_pending = c;
+		_pending_error = error;
+	}
+
+	/* the main loop drain the eventfd, only overflow may fail */
+	eventfd_notify(_notify_fd);
+}
+
+void config_watcher_t::_dispatch() {
+	if(not eventfd_drain(_notify_fd))
+		weston_log("config watcher: cannot read notification: %m\n");
+
+	page_config_p c;
+	string error;
+
+	{
+		lock_guard<mutex> lock{_pending_lock};
+		swap(c, _pending);
+		swap(error, _pending_error);
+	}
+
+	if(not error.empty())
+		weston_log("config watcher: configuration not reloaded: %s\n", error.c_str());
+
+	if(c) {
+		weston_log("config watcher: configuration reloaded\n");
+		on_reload.signal(c);
+	}
+}
+
+}
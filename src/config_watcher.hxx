@@ -0,0 +1,75 @@
+/*
+ * config_watcher.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Watch configuration files with inotify and reparse them in a dedicated
+ * thread. New snapshots are handed to the main loop, that emit on_reload.
+ *
+ */
+
+#ifndef SRC_CONFIG_WATCHER_HXX_
+#define SRC_CONFIG_WATCHER_HXX_
+
+#include <wayland-server.h>
+
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <string>
+
+#include "utils.hxx"
+#include "page_config.hxx"
+
+namespace page {
+
+using namespace std;
+
+class config_watcher_t {
+
+	/* watched directory and the file name within it */
+	struct _watch_t {
+		int wd;
+		string name;
+	};
+
+	vector<string> _files;
+	vector<_watch_t> _watches;
+
+	int _inotify_fd;
+	/* wake the main loop when a snapshot is pending */
+	int _notify_fd;
+	/* wake the watcher thread on stop */
+	int _stop_fd;
+
+	thread _thread;
+	wl_event_source * _source;
+
+	mutex _pending_lock;
+	page_config_p _pending;
+	string _pending_error;
+
+	config_watcher_t(config_watcher_t const &) = delete;
+	config_watcher_t & operator=(config_watcher_t const &) = delete;
+
+	void _run();
+	int _wait_changes(int timeout);
+	void _reload();
+	void _dispatch();
+
+public:
+	signal_t<page_config_p> on_reload;
+
+	config_watcher_t();
+	~config_watcher_t();
+
+	void start(wl_event_loop * loop, vector<string> const & files);
+	void stop();
+
+};
+
+}
+
+#endif /* SRC_CONFIG_WATCHER_HXX_ */
@@ -0,0 +1,136 @@
+/*
+ * cursor.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "cursor.hxx"
+
+namespace page {
+
+/* the sprite handling below mirror the one of wl_pointer.set_cursor */
+
+cursor_manager_t::cursor_manager_t() :
+	_pointer{nullptr}
+{
+	for(auto & x: _shapes) {
+		x.surface = nullptr;
+		x.hotspot_x = 0;
+		x.hotspot_y = 0;
+	}
+}
+
+cursor_manager_t::~cursor_manager_t() {
+	for(auto & x: _shapes)
+		x.on_destroy.disconnect();
+}
+
+auto cursor_manager_t::_find(weston_surface * s) -> _shape_t * {
+	for(auto & x: _shapes) {
+		if(x.surface == s)
+			return &x;
+	}
+	return nullptr;
+}
+
+void cursor_manager_t::_destroyed(weston_surface * s) {
+	auto shape = _find(s);
+	if(shape == nullptr)
+		return;
+	shape->on_destroy.disconnect();
+	shape->surface = nullptr;
+}
+
+void cursor_manager_t::set_shape(cursor_shape_e shape, weston_surface * surface,
+		int32_t hotspot_x, int32_t hotspot_y) {
+	if(shape < 0 or shape >= CURSOR_COUNT)
+		return;
+
+	auto & x = _shapes[shape];
+	x.on_destroy.disconnect();
+	x.surface = surface;
+	x.hotspot_x = hotspot_x;
+	x.hotspot_y = hotspot_y;
+	x.on_destroy.connect(&surface->destroy_signal, this,
+			&cursor_manager_t::_destroyed);
+}
+
+void cursor_manager_t::_unmap_sprite(weston_pointer * pointer) {
+	auto surface = pointer->sprite->surface;
+	if(weston_surface_is_mapped(surface))
+		weston_surface_unmap(surface);
+	wl_list_remove(&pointer->sprite_destroy_listener.link);
+	surface->committed = nullptr;
+	surface->committed_private = nullptr;
+	weston_view_destroy(pointer->sprite);
+	pointer->sprite = nullptr;
+}
+
+void cursor_manager_t::_committed(weston_surface * s, int32_t dx, int32_t dy) {
+	auto ths = reinterpret_cast<cursor_manager_t *>(s->committed_private);
+	auto pointer = ths->_pointer;
+
+	if(s->width == 0 or pointer == nullptr or pointer->sprite == nullptr
+			or pointer->sprite->surface != s)
+		return;
+
+	/* animated cursors may move the hotspot between images */
+	auto shape = ths->_find(s);
+	if(shape) {
+		shape->hotspot_x -= dx;
+		shape->hotspot_y -= dy;
+	}
+
+	pointer->hotspot_x -= dx;
+	pointer->hotspot_y -= dy;
+
+	int x = wl_fixed_to_int(pointer->x) - pointer->hotspot_x;
+	int y = wl_fixed_to_int(pointer->y) - pointer->hotspot_y;
+	weston_view_set_position(pointer->sprite, x, y);
+
+	pixman_region32_fini(&s->pending.input);
+	pixman_region32_init(&s->pending.input);
+	pixman_region32_fini(&s->input);
+	pixman_region32_init(&s->input);
+
+	if(not weston_surface_is_mapped(s)) {
+		weston_layer_entry_insert(&s->compositor->cursor_layer.view_list,
+				&pointer->sprite->layer_link);
+		weston_view_update_transform(pointer->sprite);
+	}
+}
+
+void cursor_manager_t::set_cursor(weston_pointer * pointer, cursor_shape_e shape) {
+	if(shape < 0 or shape >= CURSOR_COUNT)
+		return;
+
+	auto & x = _shapes[shape];
+	/* not yet loaded or missing from the cursor theme */
+	if(x.surface == nullptr)
+		return;
+
+	if(pointer->sprite and pointer->sprite->surface == x.surface)
+		return;
+
+	if(pointer->sprite)
+		_unmap_sprite(pointer);
+
+	_pointer = pointer;
+	wl_signal_add(&x.surface->destroy_signal, &pointer->sprite_destroy_listener);
+	x.surface->committed = &cursor_manager_t::_committed;
+	x.surface->committed_private = this;
+	pointer->sprite = weston_view_create(x.surface);
+	pointer->hotspot_x = x.hotspot_x;
+	pointer->hotspot_y = x.hotspot_y;
+
+	/* the buffer has been committed once by the buffer manager */
+	if(x.surface->buffer_ref.buffer) {
+		_committed(x.surface, 0, 0);
+		weston_view_schedule_repaint(pointer->sprite);
+	}
+}
+
+}
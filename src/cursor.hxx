@@ -0,0 +1,61 @@
+/*
+ * cursor.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Cursors shown by the compositor itself, e.g. during grabs. The buffer
+ * manager create and commit one surface per shape once, switching shape
+ * only swap the pointer sprite, no buffer is attached nor damaged.
+ *
+ */
+
+#ifndef SRC_CURSOR_HXX_
+#define SRC_CURSOR_HXX_
+
+#include <compositor.h>
+
+#include "cursor_shape.hxx"
+#include "listener.hxx"
+
+namespace page {
+
+class cursor_manager_t {
+
+	struct _shape_t {
+		weston_surface * surface;
+		int32_t hotspot_x;
+		int32_t hotspot_y;
+		listener_t<weston_surface> on_destroy;
+	};
+
+	_shape_t _shapes[CURSOR_COUNT];
+	/* pointer showing one of the shapes */
+	weston_pointer * _pointer;
+
+	cursor_manager_t(cursor_manager_t const &) = delete;
+	cursor_manager_t & operator=(cursor_manager_t const &) = delete;
+
+	void _destroyed(weston_surface * s);
+	auto _find(weston_surface * s) -> _shape_t *;
+
+	static void _committed(weston_surface * s, int32_t dx, int32_t dy);
+	static void _unmap_sprite(weston_pointer * pointer);
+
+public:
+	cursor_manager_t();
+	~cursor_manager_t();
+
+	/* called when the buffer manager has committed the surface of a shape */
+	void set_shape(cursor_shape_e shape, weston_surface * surface,
+			int32_t hotspot_x, int32_t hotspot_y);
+
+	/* show shape as pointer sprite, do nothing if already shown */
+	void set_cursor(weston_pointer * pointer, cursor_shape_e shape);
+
+};
+
+}
+
+#endif /* SRC_CURSOR_HXX_ */
@@ -0,0 +1,43 @@
+/*
+ * cursor_shape.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Cursor shapes preloaded by the buffer manager, shared between the buffer
+ * manager and the compositor. The order match the cursor name table of
+ * buffer-manager.cxx.
+ *
+ */
+
+#ifndef SRC_CURSOR_SHAPE_HXX_
+#define SRC_CURSOR_SHAPE_HXX_
+
+namespace page {
+
+enum cursor_shape_e {
+	/* keep the cursor set by the client */
+	CURSOR_NONE = -1,
+	CURSOR_BOTTOM_LEFT_CORNER,
+	CURSOR_BOTTOM_RIGHT_CORNER,
+	CURSOR_BOTTOM_SIDE,
+	CURSOR_GRABBING,
+	CURSOR_LEFT_PTR,
+	CURSOR_LEFT_SIDE,
+	CURSOR_RIGHT_SIDE,
+	CURSOR_TOP_LEFT_CORNER,
+	CURSOR_TOP_RIGHT_CORNER,
+	CURSOR_TOP_SIDE,
+	CURSOR_XTERM,
+	CURSOR_HAND1,
+	CURSOR_WATCH,
+	CURSOR_MOVE_DRAGGING,
+	CURSOR_COPY_DRAGGING,
+	CURSOR_FORBIDDEN_DRAGGING,
+	CURSOR_COUNT
+};
+
+}
+
+#endif /* SRC_CURSOR_SHAPE_HXX_ */
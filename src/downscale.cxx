@@ -0,0 +1,85 @@
+/*
+ * downscale.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "downscale.hxx"
+
+#include <algorithm>
+
+namespace page {
+
+using namespace std;
+
+rect box_downscale(weston_surface * surface, int w, int h,
+		cairo_surface_t * dst, rect const & damaged, vector<uint8_t> & buffer) {
+	int const tw = cairo_image_surface_get_width(dst);
+	int const th = cairo_image_surface_get_height(dst);
+
+	auto src_x = [tw, w](int tx) -> int { return static_cast<int64_t>(tx) * w / tw; };
+	auto src_y = [th, h](int ty) -> int { return static_cast<int64_t>(ty) * h / th; };
+
+	int tx0 = static_cast<int64_t>(damaged.x) * tw / w;
+	int ty0 = static_cast<int64_t>(damaged.y) * th / h;
+	int tx1 = min<int64_t>(tw, (static_cast<int64_t>(damaged.x + damaged.w) * tw + w - 1) / w);
+	int ty1 = min<int64_t>(th, (static_cast<int64_t>(damaged.y + damaged.h) * th + h - 1) / h);
+
+	int sx = src_x(tx0);
+	int sy = src_y(ty0);
+	int sw = src_x(tx1) - sx;
+	int sh = src_y(ty1) - sy;
+	if(sw <= 0 or sh <= 0)
+		return rect{};
+
+	/* source rows, then the column sums of one destination row */
+	size_t const row_size = static_cast<size_t>(sw) * 4;
+	buffer.resize(row_size * sh + row_size * sizeof(uint32_t));
+	if(weston_surface_copy_content(surface, &buffer[0], row_size * sh,
+			sx, sy, sw, sh) < 0)
+		return rect{};
+	uint32_t * sums = reinterpret_cast<uint32_t *>(&buffer[row_size * sh]);
+
+	cairo_surface_flush(dst);
+	uint8_t * data = cairo_image_surface_get_data(dst);
+	int stride = cairo_image_surface_get_stride(dst);
+
+	for(int ty = ty0; ty < ty1; ++ty) {
+		int y0 = src_y(ty) - sy;
+		int y1 = src_y(ty + 1) - sy;
+
+		/* plain loops over bytes, the compiler vectorize them */
+		fill(sums, sums + row_size, 0u);
+		for(int y = y0; y < y1; ++y) {
+			uint8_t const * src = &buffer[static_cast<size_t>(y) * row_size];
+			for(size_t i = 0; i < row_size; ++i)
+				sums[i] += src[i];
+		}
+
+		uint32_t * out = reinterpret_cast<uint32_t *>(data + ty * stride);
+		for(int tx = tx0; tx < tx1; ++tx) {
+			int x0 = src_x(tx) - sx;
+			int x1 = src_x(tx + 1) - sx;
+
+			/* weston give premultiplied RGBA bytes */
+			uint32_t r = 0, g = 0, b = 0, a = 0;
+			for(int x = x0; x < x1; ++x) {
+				r += sums[x * 4 + 0];
+				g += sums[x * 4 + 1];
+				b += sums[x * 4 + 2];
+				a += sums[x * 4 + 3];
+			}
+
+			uint32_t n = max(1, (x1 - x0) * (y1 - y0));
+			out[tx] = ((a/n) << 24) | ((r/n) << 16) | ((g/n) << 8) | (b/n);
+		}
+	}
+
+	cairo_surface_mark_dirty_rectangle(dst, tx0, ty0, tx1 - tx0, ty1 - ty0);
+	return rect{tx0, ty0, tx1 - tx0, ty1 - ty0};
+}
+
+}
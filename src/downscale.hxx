@@ -0,0 +1,36 @@
+/*
+ * downscale.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#ifndef SRC_DOWNSCALE_HXX_
+#define SRC_DOWNSCALE_HXX_
+
+#include <compositor.h>
+#include <cairo/cairo.h>
+
+#include <vector>
+
+#include "box.hxx"
+
+namespace page {
+
+using namespace std;
+
+/**
+ * Box filter the damaged area of the surface content, of size w x h, into
+ * the ARGB32 or RGB24 image dst. Each dst pixel is the mean of the source
+ * pixels it cover, thus the damaged area is grown to whole boxes before
+ * being read back. buffer is reused between calls to avoid allocation.
+ * Return the updated area of dst.
+ **/
+rect box_downscale(weston_surface * surface, int w, int h,
+		cairo_surface_t * dst, rect const & damaged, vector<uint8_t> & buffer);
+
+}
+
+#endif /* SRC_DOWNSCALE_HXX_ */
@@ -6,6 +6,7 @@
  */
 
 #include <iostream>
+#include <algorithm>
 
 #include "grab_handlers.hxx"
 #include "page_context.hxx"
@@ -15,6 +16,113 @@ namespace page {
 
 using namespace std;
 
+grab_motion_throttle_t::grab_motion_throttle_t(page_context_t * ctx,
+		char const * name, function<void()> apply) :
+		_ctx{ctx},
+		_name{name},
+		_apply{apply},
+		_is_waiting_frame{false},
+		_has_pending{false},
+		_has_applied{false},
+		_motion_count{0},
+		_apply_count{0},
+		_latency_count{0},
+		_latency_sum{0},
+		_latency_max{0}
+{
+
+}
+
+grab_motion_throttle_t::~grab_motion_throttle_t() {
+	_on_frame.disconnect();
+	_on_output_destroy.disconnect();
+	if(_motion_count == 0)
+		return;
+	weston_log("%s: %u motions, %u updates, latency avg %ld us max %ld us%s\n",
+			_name, _motion_count, _apply_count,
+			static_cast<long>(_latency_count?_latency_sum / _latency_count / 1000L:0),
+			static_cast<long>(_latency_max / 1000L),
+			_ctx->conf()._coalesce_grab_motion?"":" (not coalesced)");
+}
+
+void grab_motion_throttle_t::_apply_pending() {
+	if(not _has_pending)
+		return;
+	_has_pending = false;
+	if(not _has_applied) {
+		_has_applied = true;
+		_applied_since = _pending_since;
+	}
+	++_apply_count;
+	_apply();
+}
+
+void grab_motion_throttle_t::_wait_frame(weston_pointer * pointer) {
+	if(_is_waiting_frame)
+		return;
+
+	int x = wl_fixed_to_int(pointer->x);
+	int y = wl_fixed_to_int(pointer->y);
+
+	weston_output * output;
+	wl_list_for_each(output, &_ctx->ec->output_list, link) {
+		if(pixman_region32_contains_point(&output->region, x, y, nullptr)) {
+			_on_frame.connect(&output->frame_signal, this,
+					&grab_motion_throttle_t::_frame);
+			_on_output_destroy.connect(&output->destroy_signal, this,
+					&grab_motion_throttle_t::_output_destroyed);
+			_is_waiting_frame = true;
+			weston_output_schedule_repaint(output);
+			return;
+		}
+	}
+}
+
+void grab_motion_throttle_t::_frame(weston_output * output) {
+	if(_has_applied) {
+		int64_t latency = time64_t::now() - _applied_since;
+		_has_applied = false;
+		_latency_sum += latency;
+		_latency_max = max(_latency_max, latency);
+		++_latency_count;
+	}
+
+	if(_has_pending) {
+		_apply_pending();
+		weston_output_schedule_repaint(output);
+	} else {
+		_on_frame.disconnect();
+		_on_output_destroy.disconnect();
+		_is_waiting_frame = false;
+	}
+}
+
+/* the output is unplugged, the next motion wait for the new one */
+void grab_motion_throttle_t::_output_destroyed(weston_output * output) {
+	_on_frame.disconnect();
+	_on_output_destroy.disconnect();
+	_is_waiting_frame = false;
+	_apply_pending();
+}
+
+void grab_motion_throttle_t::motion(weston_pointer * pointer) {
+	++_motion_count;
+	if(not _has_pending) {
+		_has_pending = true;
+		_pending_since = time64_t::now();
+	}
+
+	/* the first motion after an idle frame is applied at once */
+	if(not _is_waiting_frame or not _ctx->conf()._coalesce_grab_motion)
+		_apply_pending();
+
+	_wait_frame(pointer);
+}
+
+void grab_motion_throttle_t::flush() {
+	_apply_pending();
+}
+
 
 grab_popup_t::grab_popup_t(page_context_t * ctx, surface_t * s) :
 		_ctx{ctx},
@@ -71,45 +179,102 @@ void grab_popup_t::cancel() {
 
 grab_split_t::grab_split_t(page_context_t * ctx, split_p s) :
 		_ctx{ctx},
-		_split{s}
+		_split{s},
+		_throttle{ctx, "grab_split", [this]() { _update(); }}
 {
 	_slider_area = s->to_root_position(s->get_split_bar_area());
 	_split_ratio = s->ratio();
 	_split_root_allocation = s->root_location();
-	//_ps = make_shared<popup_split_t>(ctx, s);
-	//_ctx->overlay_add(_ps);
-	//_ps->show();
+	_ps = make_shared<popup_split_t>(ctx, s);
+
+	auto output = s->get_output();
+	if(output) {
+		_on_frame.connect(&output->frame_signal, this,
+				&grab_split_t::_update_outline);
+		_on_output_destroy.connect(&output->destroy_signal, this,
+				&grab_split_t::_output_destroyed);
+	}
 }
 
 grab_split_t::~grab_split_t() {
-	//if(_ps != nullptr)
-	//	_ctx->detach(_ps);
+	_on_frame.disconnect();
+	_on_output_destroy.disconnect();
 }
 
-void grab_split_t::motion(uint32_t time, weston_pointer_motion_event * event) {
-	auto pointer = base.grab.pointer;
-
-	/** update pointer position **/
-	weston_pointer_move(pointer, event);
+auto grab_split_t::cursor() const -> cursor_shape_e {
+	auto split = _split.lock();
+	if(split and split->type() == HORIZONTAL_SPLIT)
+		return CURSOR_TOP_SIDE;
+	return CURSOR_LEFT_SIDE;
+}
 
-	if(_split.expired()) {
-		_ctx->grab_stop(pointer);
+void grab_split_t::_update() {
+	if(_split.expired())
 		return;
-	}
+
+	auto pointer = base.grab.pointer;
+	auto split = _split.lock();
 
 	/** current global position **/
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
 
-	if (_split.lock()->type() == VERTICAL_SPLIT) {
+	if (split->type() == VERTICAL_SPLIT) {
 		_split_ratio = (x - _split_root_allocation.x) / _split_root_allocation.w;
 	} else {
 		_split_ratio = (y - _split_root_allocation.y) / _split_root_allocation.h;
 	}
 
-	_split_ratio = _split.lock()->compute_split_constaint(_split_ratio);
+	_split_ratio = split->compute_split_constaint(_split_ratio);
+
+	if(_split_ratio == split->ratio())
+		return;
 
-	//_ps->set_position(_split_ratio);
+	/* notebooks and clients follow at the next layout update */
+	split->queue_redraw();
+	split->set_split(_split_ratio);
+	_update_outline(nullptr);
+}
+
+/**
+ * Show where the clients are going while one of them has not committed
+ * its new size yet.
+ **/
+void grab_split_t::_update_outline(weston_output * output) {
+	if(_split.expired())
+		return;
+
+	auto views = filter_class<view_t>(_split.lock()->get_all_children());
+	bool is_lagging = any_of(views.begin(), views.end(), [](view_p const & v) {
+		return v->is_configure_pending();
+	});
+
+	if(is_lagging) {
+		_ps->set_position(_split_ratio);
+		_ps->show();
+	} else {
+		_ps->hide();
+	}
+}
+
+/* the outline is still updated on motion */
+void grab_split_t::_output_destroyed(weston_output * output) {
+	_on_frame.disconnect();
+	_on_output_destroy.disconnect();
+}
+
+void grab_split_t::motion(uint32_t time, weston_pointer_motion_event * event) {
+	auto pointer = base.grab.pointer;
+
+	/** update pointer position **/
+	weston_pointer_move(pointer, event);
+
+	if(_split.expired()) {
+		_ctx->grab_stop(pointer);
+		return;
+	}
+
+	_throttle.motion(pointer);
 }
 
 void grab_split_t::button(uint32_t time, uint32_t button, uint32_t state) {
@@ -160,7 +325,8 @@ grab_bind_client_t::grab_bind_client_t(page_context_t * ctx,
 		target_notebook{},
 		zone{NOTEBOOK_AREA_NONE},
 		//pn0{},
-		_button{button}
+		_button{button},
+		_throttle{ctx, "grab_bind_client", [this]() { _update(); }}
 {
 
 
@@ -217,6 +383,14 @@ void grab_bind_client_t::motion(uint32_t time,
 	/** update pointer position **/
 	weston_pointer_move(pointer, event);
 
+	/* the notebook hit test is done once per frame */
+	_throttle.motion(pointer);
+}
+
+void grab_bind_client_t::_update()
+{
+	auto pointer = base.grab.pointer;
+
 	/** current global position **/
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
@@ -367,8 +541,9 @@ grab_floating_move_t::grab_floating_move_t(page_context_t * ctx,
 		x_root{x},
 		y_root{y},
 		_button{button},
-		popup_original_position{f->get_base_position()}
+		popup_original_position{f->get_base_position()},
 		//pfm{}
+		_throttle{ctx, "grab_floating_move", [this]() { _update(); }}
 {
 
 	//f->activate();
@@ -399,14 +574,21 @@ void grab_floating_move_t::motion(uint32_t time,
 		return;
 	}
 
+	_throttle.motion(pointer);
+}
+
+void grab_floating_move_t::_update()
+{
+	if(f.expired())
+		return;
+
+	auto pointer = base.grab.pointer;
 	auto f = this->f.lock();
 
 	/** current global position **/
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
 
-	weston_log("x = %f, y = %f\n", x, y);
-
 	/* compute new window position */
 	rect new_position = original_position;
 	new_position.x += x - x_root;
@@ -447,6 +629,7 @@ void grab_floating_move_t::button(uint32_t time, uint32_t button,
 		//_ctx->dpy()->set_window_cursor(f->base(), XCB_NONE);
 		//_ctx->dpy()->set_window_cursor(f->orig(), XCB_NONE);
 
+		_throttle.flush();
 		f->set_floating_wished_position(final_position);
 		f->reconfigure();
 
@@ -466,8 +649,8 @@ grab_floating_resize_t::grab_floating_resize_t(page_context_t * ctx,
 		y_root{y},
 		original_position{f->get_wished_position()},
 		final_position{f->get_wished_position()},
-		_button{_button}
-
+		_button{_button},
+		_throttle{ctx, "grab_floating_resize", [this]() { _update(); }}
 {
 
 	f->activate();
@@ -485,6 +668,29 @@ grab_floating_resize_t::~grab_floating_resize_t() {
 	//	_ctx->detach(pfm);
 }
 
+auto grab_floating_resize_t::cursor() const -> cursor_shape_e {
+	switch(mode) {
+	case EDGE_TOP:
+		return CURSOR_TOP_SIDE;
+	case EDGE_BOTTOM:
+		return CURSOR_BOTTOM_SIDE;
+	case EDGE_LEFT:
+		return CURSOR_LEFT_SIDE;
+	case EDGE_RIGHT:
+		return CURSOR_RIGHT_SIDE;
+	case EDGE_TOP_LEFT:
+		return CURSOR_TOP_LEFT_CORNER;
+	case EDGE_TOP_RIGHT:
+		return CURSOR_TOP_RIGHT_CORNER;
+	case EDGE_BOTTOM_LEFT:
+		return CURSOR_BOTTOM_LEFT_CORNER;
+	case EDGE_BOTTOM_RIGHT:
+		return CURSOR_BOTTOM_RIGHT_CORNER;
+	default:
+		return CURSOR_NONE;
+	}
+}
+
 void grab_floating_resize_t::motion(uint32_t time,
 		weston_pointer_motion_event * event)
 {
@@ -496,11 +702,16 @@ void grab_floating_resize_t::motion(uint32_t time,
 		return;
 	}
 
-	auto f = this->f.lock();
-
 	/** update pointer position **/
 	weston_pointer_move(pointer, event);
 
+	_throttle.motion(pointer);
+}
+
+void grab_floating_resize_t::_update()
+{
+	auto pointer = base.grab.pointer;
+
 	/** current global position **/
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
@@ -626,6 +837,7 @@ void grab_floating_resize_t::button(uint32_t time, uint32_t _button,
 			and state == WL_POINTER_BUTTON_STATE_RELEASED) {
 		//_ctx->dpy()->set_window_cursor(f->base(), XCB_NONE);
 		//_ctx->dpy()->set_window_cursor(f->orig(), XCB_NONE);
+		_throttle.flush();
 		f->set_floating_wished_position(final_position);
 		f->reconfigure();
 		//_ctx->set_focus(f, time);
@@ -638,7 +850,8 @@ grab_fullscreen_client_t::grab_fullscreen_client_t(page_context_t * ctx,
  _ctx{ctx},
  mw{mw},
  //pn0{nullptr},
- _button{button}
+ _button{button},
+ _throttle{ctx, "grab_fullscreen_client", [this]() { _update(); }}
 {
 	v = _ctx->find_mouse_viewport(x, y);
 //	pn0 = make_shared<popup_notebook0_t>(ctx);
@@ -665,6 +878,12 @@ void grab_fullscreen_client_t::motion(uint32_t time,
 	/** update pointer position **/
 	weston_pointer_move(pointer, event);
 
+	_throttle.motion(pointer);
+}
+
+void grab_fullscreen_client_t::_update() {
+	auto pointer = base.grab.pointer;
+
 	/** current global position **/
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
@@ -10,6 +10,10 @@
 
 #include "xdg-shell-unstable-v5-server-protocol.h"
 
+#include <functional>
+
+#include "time.hxx"
+#include "listener.hxx"
 #include "split.hxx"
 #include "workspace.hxx"
 #include "popup_split.hxx"
@@ -30,6 +34,52 @@ enum notebook_area_e {
 	NOTEBOOK_AREA_CENTER
 };
 
+/**
+ * Apply grab geometry at most once per output frame. The pointer is moved
+ * on every motion event, but the costly update is done with the latest
+ * position when the output under the pointer has finished its frame. The
+ * delay between a motion and the frame that show it is logged at the end
+ * of the grab.
+ **/
+class grab_motion_throttle_t {
+	page_context_t * _ctx;
+	char const * _name;
+	function<void()> _apply;
+
+	listener_t<weston_output> _on_frame;
+	listener_t<weston_output> _on_output_destroy;
+	bool _is_waiting_frame;
+
+	/* oldest motion not yet applied */
+	bool _has_pending;
+	time64_t _pending_since;
+	/* oldest motion applied but not yet shown */
+	bool _has_applied;
+	time64_t _applied_since;
+
+	unsigned _motion_count;
+	unsigned _apply_count;
+	unsigned _latency_count;
+	int64_t _latency_sum;
+	int64_t _latency_max;
+
+	void _apply_pending();
+	void _wait_frame(weston_pointer * pointer);
+	void _frame(weston_output * output);
+	void _output_destroyed(weston_output * output);
+
+public:
+	grab_motion_throttle_t(page_context_t * ctx, char const * name,
+			function<void()> apply);
+	~grab_motion_throttle_t();
+
+	/* call after weston_pointer_move */
+	void motion(weston_pointer * pointer);
+	/* apply the pending motion now, e.g. before button release */
+	void flush();
+
+};
+
 struct grab_popup_t : public pointer_grab_handler_t {
 	page_context_t * _ctx;
 	surface_t * _surface;
@@ -53,7 +103,14 @@ class grab_split_t : public pointer_grab_handler_t {
 	rect _slider_area;
 	rect _split_root_allocation;
 	double _split_ratio;
-	//shared_ptr<popup_split_t> _ps;
+	shared_ptr<popup_split_t> _ps;
+	grab_motion_throttle_t _throttle;
+	listener_t<weston_output> _on_frame;
+	listener_t<weston_output> _on_output_destroy;
+
+	void _update();
+	void _update_outline(weston_output * output);
+	void _output_destroyed(weston_output * output);
 
 public:
 	grab_split_t(page_context_t * ctx, shared_ptr<split_t> s);
@@ -68,6 +125,7 @@ public:
 	virtual void axis_source(uint32_t source) { }
 	virtual void frame() { }
 	virtual void cancel() { }
+	virtual auto cursor() const -> cursor_shape_e;
 
 };
 
@@ -80,6 +138,9 @@ class grab_bind_client_t : public pointer_grab_handler_t {
 	notebook_area_e zone;
 	notebook_w target_notebook;
 	//shared_ptr<popup_notebook0_t> pn0;
+	grab_motion_throttle_t _throttle;
+
+	void _update();
 
 	void _find_target_notebook(int x, int y,
 			shared_ptr<notebook_t> & target, notebook_area_e & zone);
@@ -99,6 +160,7 @@ public:
 	virtual void axis_source(uint32_t source) { }
 	virtual void frame() { }
 	virtual void cancel() { }
+	virtual auto cursor() const -> cursor_shape_e { return CURSOR_MOVE_DRAGGING; }
 
 
 };
@@ -145,6 +207,9 @@ struct grab_floating_move_t : public pointer_grab_handler_t {
 	uint32_t _button;
 
 	//shared_ptr<popup_notebook0_t> pfm;
+	grab_motion_throttle_t _throttle;
+
+	void _update();
 
 	grab_floating_move_t(page_context_t * ctx, view_p f,
 			unsigned int button, int x, int y);
@@ -158,6 +223,7 @@ struct grab_floating_move_t : public pointer_grab_handler_t {
 	virtual void axis_source(uint32_t source) { }
 	virtual void frame() { }
 	virtual void cancel() { }
+	virtual auto cursor() const -> cursor_shape_e { return CURSOR_GRABBING; }
 
 };
 
@@ -173,6 +239,9 @@ struct grab_floating_resize_t : public pointer_grab_handler_t {
 	uint32_t _button;
 
 	//shared_ptr<popup_notebook0_t> pfm;
+	grab_motion_throttle_t _throttle;
+
+	void _update();
 
 public:
 
@@ -188,6 +257,7 @@ public:
 	virtual void axis_source(uint32_t source) { }
 	virtual void frame() { }
 	virtual void cancel() { }
+	virtual auto cursor() const -> cursor_shape_e;
 
 };
 
@@ -197,6 +267,9 @@ struct grab_fullscreen_client_t : public pointer_grab_handler_t {
 	viewport_w v;
 	//shared_ptr<popup_notebook0_t> pn0;
 	uint32_t _button;
+	grab_motion_throttle_t _throttle;
+
+	void _update();
 
 public:
 
@@ -211,6 +284,7 @@ public:
 	virtual void axis_source(uint32_t source) { }
 	virtual void frame() { }
 	virtual void cancel() { }
+	virtual auto cursor() const -> cursor_shape_e { return CURSOR_GRABBING; }
 
 };
 
@@ -23,7 +23,7 @@ struct key_desc_t {
 	xkb_keysym_t ks;
 	uint32_t mod;
 
-	bool operator==(key_desc_t const & x) {
+	bool operator==(key_desc_t const & x) const {
 		return (ks == x.ks) and (mod == x.mod);
 	}
 
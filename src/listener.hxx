@@ -69,6 +69,20 @@ struct listener_t {
 		resource_add_destroy_listener(resource, [ths,f](T * o) -> void { (ths->*f)(o); });
 	}
 
+	template<typename F>
+	void client_add_destroy_listener(struct wl_client * client, F f) {
+		_func = f;
+		_pod._func = &_func;
+		_pod._listener.notify = &listener_t::_call;
+		disconnect();
+		wl_client_add_destroy_listener(client, &_pod._listener);
+	}
+
+	template<typename Z>
+	void client_add_destroy_listener(struct wl_client * client, Z * ths, void(Z::*f)(T*)) {
+		client_add_destroy_listener(client, [ths,f](T * o) -> void { (ths->*f)(o); });
+	}
+
 };
 
 
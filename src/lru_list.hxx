@@ -0,0 +1,143 @@
+/*
+ * lru_list.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Intrusive doubly linked list, the hooks are embedded in the elements
+ * thus moving an element to the front or removing it is O(1) and the
+ * list never allocate. An element is in at most one list per hook, it is
+ * unlinked when it is destroyed.
+ *
+ */
+
+#ifndef SRC_LRU_LIST_HXX_
+#define SRC_LRU_LIST_HXX_
+
+#include <cstddef>
+
+namespace page {
+
+template<typename T>
+class lru_list_t;
+
+template<typename T>
+class lru_hook_t {
+	friend class lru_list_t<T>;
+
+	T * _value;
+	lru_list_t<T> * _owner;
+	lru_hook_t * _prev;
+	lru_hook_t * _next;
+
+	lru_hook_t(lru_hook_t const &) = delete;
+	lru_hook_t & operator=(lru_hook_t const &) = delete;
+
+public:
+	lru_hook_t(T * value) :
+		_value{value},
+		_owner{nullptr},
+		_prev{this},
+		_next{this}
+	{
+
+	}
+
+	~lru_hook_t() {
+		unlink();
+	}
+
+	bool is_linked() const {
+		return _owner != nullptr;
+	}
+
+	void unlink() {
+		if(_owner == nullptr)
+			return;
+		_prev->_next = _next;
+		_next->_prev = _prev;
+		_prev = this;
+		_next = this;
+		_owner->_size -= 1;
+		_owner = nullptr;
+	}
+
+};
+
+template<typename T>
+class lru_list_t {
+	friend class lru_hook_t<T>;
+
+	/* sentinel, _head._next is the most recently used element */
+	lru_hook_t<T> _head;
+	size_t _size;
+
+	lru_list_t(lru_list_t const &) = delete;
+	lru_list_t & operator=(lru_list_t const &) = delete;
+
+public:
+
+	class iterator {
+		lru_hook_t<T> const * _cur;
+	public:
+		iterator(lru_hook_t<T> const * cur) : _cur{cur} { }
+		T * operator*() const { return _cur->_value; }
+		iterator & operator++() { _cur = _cur->_next; return *this; }
+		bool operator==(iterator const & x) const { return _cur == x._cur; }
+		bool operator!=(iterator const & x) const { return _cur != x._cur; }
+	};
+
+	lru_list_t() : _head{nullptr}, _size{0} { }
+
+	~lru_list_t() {
+		clear();
+	}
+
+	/* link h in front, unlinking it from its previous list if any */
+	void move_front(lru_hook_t<T> & h) {
+		h.unlink();
+		h._prev = &_head;
+		h._next = _head._next;
+		_head._next->_prev = &h;
+		_head._next = &h;
+		h._owner = this;
+		_size += 1;
+	}
+
+	/* unlink h if it belongs to this list */
+	void remove(lru_hook_t<T> & h) {
+		if(h._owner == this)
+			h.unlink();
+	}
+
+	bool contains(lru_hook_t<T> const & h) const {
+		return h._owner == this;
+	}
+
+	void clear() {
+		while(_head._next != &_head)
+			_head._next->unlink();
+	}
+
+	auto front() const -> T * {
+		return _head._next->_value;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+	size_t size() const {
+		return _size;
+	}
+
+	/* from the most recently used to the least recently used */
+	iterator begin() const { return iterator{_head._next}; }
+	iterator end() const { return iterator{&_head}; }
+
+};
+
+}
+
+#endif /* SRC_LRU_LIST_HXX_ */
@@ -20,6 +20,13 @@ namespace page {
 
 using namespace std;
 
+/* title change counters, shared by all notebooks */
+static struct {
+	unsigned long received;
+	unsigned long applied;
+	unsigned long unchanged;
+} _title_stats = {0, 0, 0};
+
 notebook_t::notebook_t(page_context_t * ctx) :
 		_ctx{ctx},
 		_is_default{false},
@@ -31,15 +38,20 @@ notebook_t::notebook_t(page_context_t * ctx) :
 		_theme_client_tabs_offset{0},
 		_has_scroll_arrow{false},
 		_layout_is_durty{true},
+		_tabs_is_durty{false},
 		_has_mouse_change{true},
 		_selected_has_focus{false},
 		_selected_is_iconic{false},
+		_is_waiting_title_frame{false},
+		_has_pending_title{false},
 		animation_duration{ctx->conf()._fade_in_time}
 {
 
 }
 
 notebook_t::~notebook_t() {
+	_on_title_frame.disconnect();
+	_clients_index.clear();
 	_clients_tab_order.clear();
 }
 
@@ -48,11 +60,14 @@ bool notebook_t::add_client(view_p x) {
 	assert(x != nullptr);
 
 	x->set_parent(this);
-	x->set_notebook_wished_position(to_root_position(_client_area));
 	x->set_managed_type(MANAGED_NOTEBOOK);
+	/* other clients keep their position, only place the new one */
+	update_client_position(x);
 
-	_client_context_t client_context{this, x};
-	_clients_tab_order.push_front(client_context);
+	/* new tabs are appended, the index of other tabs does not change */
+	_client_context_t client_context{this, x, _clients_tab_order.size()};
+	_clients_tab_order.push_back(client_context);
+	_clients_index[x.get()] = prev(_clients_tab_order.end());
 
 	connect(x->focus_change, this, &notebook_t::_client_focus_change);
 	connect(x->title_change, this, &notebook_t::_client_title_change);
@@ -61,7 +76,7 @@ bool notebook_t::add_client(view_p x) {
 		_set_selected(x);
 	}
 
-	_schedule_repaint();
+	_append_tab(x);
 	_ctx->sync_tree_view();
 	return true;
 
@@ -115,6 +130,12 @@ void notebook_t::_remove_client(view_p x) {
 	disconnect(x->focus_change);
 	x->clear_parent();
 
+	/* only the tabs after the removed one shift */
+	size_t tab = x_client_context->tab;
+	for(auto i = next(x_client_context); i != _clients_tab_order.end(); ++i)
+		--i->tab;
+
+	_clients_index.erase(x.get());
 	_clients_tab_order.erase(x_client_context);
 
 	_mouse_over_reset();
@@ -123,14 +144,14 @@ void notebook_t::_remove_client(view_p x) {
 			and not _clients_tab_order.empty()
 			and _selected == nullptr
 			and not _exposay) {
-		_selected = _clients_tab_order.back().client;
+		_selected = _clients_tab_order.front().client;
 
 		if (_selected != nullptr and _is_visible) {
 			_children.push_back(_selected);
 		}
 	}
 
-	_schedule_repaint();
+	_erase_tab(tab);
 	_ctx->sync_tree_view();
 
 }
@@ -156,7 +177,8 @@ void notebook_t::_set_selected(view_p c) {
 }
 
 void notebook_t::update_client_position(view_p c) {
-	c->set_notebook_wished_position(to_root_position(_client_area));
+	_positioned_client_area = to_root_position(_client_area);
+	c->set_notebook_wished_position(_positioned_client_area);
 	_client_position = _client_area;
 	c->update_view();
 	c->reconfigure();
@@ -278,19 +300,150 @@ void notebook_t::_update_layout() {
 		_client_area.h = 1;
 	}
 
-	for(auto const & c: _clients_tab_order) {
-		/* resize all client properly */
-		update_client_position(c.client);
+	/* resize all client properly, if the client area moved */
+	if(to_root_position(_client_area) != _positioned_client_area) {
+		for(auto const & c: _clients_tab_order)
+			update_client_position(c.client);
 	}
 
+	_update_tabs();
+}
+
+/* rebuild the tabs and the buttons areas, client positions are unchanged */
+void notebook_t::_update_tabs() {
 	_mouse_over_reset();
+	_rebuild_tabs();
+	_update_tabs_geometry();
+}
+
+/* update what depends on the number of tabs, the tabs are unchanged */
+void notebook_t::_update_tabs_geometry() {
 	_update_theme_notebook(_theme_notebook);
 	_update_notebook_areas();
+	_update_exposay();
 
 	queue_redraw();
 
 }
 
+void notebook_t::_rebuild_tabs() {
+	/* clear keep the capacity, the tabs are not reallocated */
+	_theme_client_tabs.clear();
+	_theme_client_tabs.reserve(_clients_tab_order.size());
+	_client_tabs.clear();
+	_client_tabs.reserve(_clients_tab_order.size());
+
+	for (auto const & i : _clients_tab_order) {
+		_theme_client_tabs.push_back(_make_tab(i.client, i.tab));
+		_client_tabs.push_back(i.client);
+	}
+}
+
+/* add the tab of the last added client, other tabs do not move */
+void notebook_t::_append_tab(view_p c) {
+	/* the pending update will rebuild all tabs */
+	if(_layout_is_durty or _tabs_is_durty)
+		return;
+
+	/* _mouse_over.tab may point into _theme_client_tabs */
+	_mouse_over_reset();
+	_theme_client_tabs.push_back(_make_tab(c, _theme_client_tabs.size()));
+	_client_tabs.push_back(c);
+
+	_has_mouse_change = true;
+	_update_tabs_geometry();
+}
+
+/* remove the tab at index, only the following tabs shift left */
+void notebook_t::_erase_tab(size_t index) {
+	if(_layout_is_durty or _tabs_is_durty)
+		return;
+
+	if(index >= _theme_client_tabs.size()) {
+		_schedule_tabs_update();
+		return;
+	}
+
+	_mouse_over_reset();
+	_theme_client_tabs.erase(_theme_client_tabs.begin() + index);
+	_client_tabs.erase(_client_tabs.begin() + index);
+	for(auto i = index; i < _theme_client_tabs.size(); ++i)
+		_theme_client_tabs[i].position.x -= _ctx->theme()->notebook.iconic_tab_width;
+
+	/* the selection may have moved to another client */
+	if(_selected != nullptr) {
+		auto x = _clients_index.find(_selected.get());
+		if(x != _clients_index.end())
+			_theme_client_tabs[x->second->tab].tab_color = _tab_color(_selected);
+	}
+
+	_has_mouse_change = true;
+	_update_tabs_geometry();
+}
+
+auto notebook_t::_tab_color(view_p c) -> color_t {
+	if(_selected_has_focus and _selected == c) {
+		return _ctx->theme()->get_focused_color();
+	} else if (_selected == c) {
+		return _ctx->theme()->get_selected_color();
+	} else {
+		return _ctx->theme()->get_normal_color();
+	}
+}
+
+/* tab of c at index, relative to _theme_client_tabs_area */
+auto notebook_t::_make_tab(view_p c, size_t index) -> theme_tab_t {
+	double offset = index * _ctx->theme()->notebook.iconic_tab_width;
+	theme_tab_t tab;
+	tab.position = rect {
+		(int) floor(offset), 0,
+		(int) (floor(offset + _ctx->theme()->notebook.iconic_tab_width)
+							- floor(offset)),
+		(int) _ctx->theme()->notebook.tab_height };
+	tab.tab_color = _tab_color(c);
+	tab.title = c->title();
+	tab.icon = nullptr;
+	tab.is_iconic = false;
+	return tab;
+}
+
+/* position of the tab at index, in notebook coordinates */
+auto notebook_t::_tab_position(size_t index) const -> rect {
+	rect pos = _theme_client_tabs[index].position;
+	pos.x += _theme_client_tabs_area.x - _theme_client_tabs_offset;
+	pos.y += _theme_client_tabs_area.y;
+	return pos;
+}
+
+/* find the tab under (x, y), tabs have the same width, no need to walk them */
+bool notebook_t::_find_tab(int x, int y, theme_tab_t *& tab, view_p & client, rect & position) {
+	if(_selected != nullptr and _theme_notebook.has_selected_client
+			and _theme_notebook.selected_client.position.is_inside(x, y)) {
+		tab = &_theme_notebook.selected_client;
+		client = _selected;
+		position = _theme_notebook.selected_client.position;
+		return true;
+	}
+
+	int width = _ctx->theme()->notebook.iconic_tab_width;
+	if(width <= 0 or not _theme_client_tabs_area.is_inside(x, y))
+		return false;
+
+	int index = (x - _theme_client_tabs_area.x + _theme_client_tabs_offset) / width;
+	if(index < 0 or index >= static_cast<int>(_theme_client_tabs.size()))
+		return false;
+
+	auto c = _client_tabs[index].lock();
+	rect pos = _tab_position(index);
+	if(c == nullptr or not pos.is_inside(x, y))
+		return false;
+
+	tab = &_theme_client_tabs[index];
+	client = c;
+	position = pos;
+	return true;
+}
+
 rect notebook_t::_compute_client_size(view_p c) {
 //	dimention_t<unsigned> size =
 //			c->compute_size_with_constrain(_client_area.w, _client_area.h);
@@ -357,35 +510,29 @@ string notebook_t::get_node_name() const {
 	return oss.str();
 }
 
-void notebook_t::render_legacy(cairo_t * cr) {
-	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	update_layout();
-	_ctx->theme()->render_notebook(cr, &_theme_notebook);
-
-	if(_theme_client_tabs.size() > 0) {
-		cairo_surface_t * pix = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
-				_theme_client_tabs.back().position.x + 100,
-				_ctx->theme()->notebook.tab_height);
-		cairo_t * xcr = cairo_create(pix);
+string notebook_t::get_dump_name() const {
+	ostringstream oss;
+	oss << _get_dump_name<'N'>() << " " << _allocation.to_string()
+			<< " selected = " << (_selected?_selected->title():string{"none"});
+	return oss.str();
+}
 
-		cairo_set_operator(xcr, CAIRO_OPERATOR_SOURCE);
-		cairo_set_source_rgba(xcr, 0.0, 0.0, 0.0, 0.0);
-		cairo_paint(xcr);
+void notebook_t::render_legacy(cairo_t * cr) {
+	render_worker_t::render_notebook(_ctx->theme(), cr, get_render_state());
 
-		_ctx->theme()->render_iconic_notebook(xcr, _theme_client_tabs);
-		cairo_destroy(xcr);
+	if(_exposay)
+		_render_exposay(cr);
 
-		cairo_save(cr);
-		cairo_set_source_surface(cr, pix,
-				_theme_client_tabs_area.x - _theme_client_tabs_offset,
-				_theme_client_tabs_area.y);
-		cairo_clip(cr, _theme_client_tabs_area);
-		cairo_paint(cr);
+}
 
-		cairo_restore(cr);
-		cairo_surface_destroy(pix);
-	}
+auto notebook_t::get_render_state() -> notebook_render_state_t {
+	update_layout();
+	return notebook_render_state_t{_theme_notebook, _theme_client_tabs,
+		_theme_client_tabs_area, _theme_client_tabs_offset};
+}
 
+bool notebook_t::has_exposay() const {
+	return _exposay;
 }
 
 void notebook_t::update_layout() {
@@ -395,8 +542,13 @@ void notebook_t::update_layout() {
 
 	if(_layout_is_durty) {
 		_layout_is_durty = false;
+		_tabs_is_durty = false;
 		_has_mouse_change = true;
 		_update_layout();
+	} else if(_tabs_is_durty) {
+		_tabs_is_durty = false;
+		_has_mouse_change = true;
+		_update_tabs();
 	}
 
 	if(_has_mouse_change) {
@@ -425,8 +577,13 @@ void notebook_t::update_layout(time64_t const time) {
 
 	if(_layout_is_durty) {
 		_layout_is_durty = false;
+		_tabs_is_durty = false;
 		_has_mouse_change = true;
 		_update_layout();
+	} else if(_tabs_is_durty) {
+		_tabs_is_durty = false;
+		_has_mouse_change = true;
+		_update_tabs();
 	}
 
 	if(_has_mouse_change) {
@@ -504,15 +661,13 @@ rect notebook_t::_compute_notebook_menu_position() const {
 
 void notebook_t::_update_notebook_areas() {
 
-	_client_buttons.clear();
-
 	_area.button_close = _compute_notebook_close_position();
 	_area.button_hsplit = _compute_notebook_hsplit_position();
 	_area.button_vsplit = _compute_notebook_vsplit_position();
 	_area.button_select = _compute_notebook_bookmark_position();
 	_area.button_exposay = _compute_notebook_menu_position();
 
-	if(_clients_tab_order.size() > 0) {
+	if(not _theme_client_tabs.empty()) {
 
 		if(_theme_client_tabs_area.w > _theme_client_tabs.back().position.x + _theme_client_tabs.back().position.w) {
 			_theme_client_tabs_offset = 0;
@@ -546,23 +701,11 @@ void notebook_t::_update_notebook_areas() {
 
 			}
 
-			_client_buttons.push_back(std::make_tuple(b, view_w{_selected}, &_theme_notebook.selected_client));
-
 		} else {
 			_area.close_client = rect{};
 			_area.undck_client = rect{};
 		}
 
-		auto c = _clients_tab_order.begin();
-		for (auto & tab: _theme_client_tabs) {
-			rect pos = tab.position;
-			pos.x += _theme_client_tabs_area.x - _theme_client_tabs_offset;
-			pos.y += _theme_client_tabs_area.y;
-			_client_buttons.push_back(make_tuple(pos,
-					view_w{c->client}, &tab));
-			++c;
-		}
-
 	}
 }
 
@@ -573,9 +716,8 @@ void notebook_t::_update_theme_notebook(theme_notebook_t & theme_notebook) {
 	theme_notebook.can_vsplit = _can_vsplit;
 	theme_notebook.client_count = _children.size();
 
-	_theme_client_tabs.clear();
-
-	if (_clients_tab_order.size() != 0) {
+	/* the tabs are built by _rebuild_tabs or updated in place */
+	if (not _theme_client_tabs.empty()) {
 		double selected_box_width = ((int)_allocation.w
 				- (int)_ctx->theme()->notebook.close_width
 				- (int)_ctx->theme()->notebook.hsplit_width
@@ -628,29 +770,6 @@ void notebook_t::_update_theme_notebook(theme_notebook_t & theme_notebook) {
 			theme_notebook.has_selected_client = false;
 		}
 
-		offset = 0;
-		for (auto const & i : _clients_tab_order) {
-			_theme_client_tabs.push_back(theme_tab_t { });
-			auto & tab = _theme_client_tabs.back();
-			tab.position = rect {
-				(int) floor(offset), 0,
-				(int) (floor(offset + _ctx->theme()->notebook.iconic_tab_width)
-									- floor(offset)),
-				(int) _ctx->theme()->notebook.tab_height };
-
-			if(_selected_has_focus and _selected == i.client) {
-				tab.tab_color = _ctx->theme()->get_focused_color();
-			} if (_selected == i.client) {
-				tab.tab_color = _ctx->theme()->get_selected_color();
-			} else {
-				tab.tab_color = _ctx->theme()->get_normal_color();
-			}
-			tab.title = i.client->title();
-			tab.icon = nullptr;
-			tab.is_iconic = false;
-			offset += _ctx->theme()->notebook.iconic_tab_width;
-		}
-
 		_area.left_scroll_arrow = rect{};
 		_area.right_scroll_arrow = rect{};
 		if(_theme_client_tabs_area.w < _theme_client_tabs.back().position.x + _theme_client_tabs.back().position.w) {
@@ -768,87 +887,81 @@ void notebook_t::_start_fading() {
 }
 
 void notebook_t::start_exposay() {
-//	if(_ctx->cmp() == nullptr)
-//		return;
-//
-//	if(_selected != nullptr) {
-//		iconify_client(_selected);
-//		_selected = nullptr;
-//	}
-//
-//	_exposay = true;
-//	queue_redraw();
+	if(_selected != nullptr) {
+		iconify_client(_selected);
+		_selected = nullptr;
+	}
+
+	/* thumbnails are refreshed asynchronously, redraw when they are ready */
+	connect(_ctx->thumbnails()->on_update, this, &notebook_t::_thumbnail_update);
+
+	_exposay = true;
+	_schedule_repaint();
+	_ctx->sync_tree_view();
 }
 
 void notebook_t::_update_exposay() {
-//	_exposay_buttons.clear();
-//	//_exposay_thumbnail.clear();
-//	_exposay_mouse_over = nullptr;
-//
-//	_theme_notebook.button_mouse_over = NOTEBOOK_BUTTON_NONE;
-//	_mouse_over.tab = nullptr;
-//	_mouse_over.exposay = nullptr;
-//
-//	if(_ctx->cmp() == nullptr)
-//		return;
-//
-//	if(not _exposay)
-//		return;
-//
-//	if(_clients_tab_order.size() <= 0)
-//		return;
-//
-//	unsigned clients_counts = _clients_tab_order.size();
-//
-//	/*
-//	 * n is the number of column and m is the number of line of exposay.
-//	 * Since most window are the size of client_area, we known that n*m will produce n = m
-//	 * thus use square root to get n
-//	 */
-//	int n = static_cast<int>(ceil(sqrt(static_cast<double>(clients_counts))));
-//	/* the square root may produce to much line (or column depend on the point of view
-//	 * We choose to remove the exide of line, but we could prefer to remove column,
-//	 * maybe later we will choose to select this on client_area.h/client_area.w ratio
-//	 *
-//	 *
-//	 * /!\ This equation use the properties of integer division.
-//	 *
-//	 * we want :
-//	 *  if client_counts == Q*n => m = Q
-//	 *  if client_counts == Q*n+R with R != 0 => m = Q + 1
-//	 *
-//	 *  within the equation :
-//	 *   when client_counts == Q*n => (client_counts - 1)/n + 1 == (Q - 1) + 1 == Q
-//	 *   when client_counts == Q*n + R => (client_counts - 1)/n + 1 == (Q*n+R-1)/n + 1
-//	 *     => when R == 1: (Q*n+R-1)/n + 1 == Q*n/n+1 = Q + 1
-//	 *     => when 1 < R <= n-1 => (Q*n+R-1)/n + 1 == Q*n/n + (R-1)/n + 1 with (R-1)/n always == 0
-//	 *        then (client_counts - 1)/n + 1 == Q + 1
-//	 *
-//	 */
-//	int m = ((clients_counts - 1) / n) + 1;
-//
-//	unsigned width = _client_area.w/n;
-//	unsigned heigth = _client_area.h/m;
-//	unsigned xoffset = (_client_area.w-width*n)/2.0 + _client_area.x;
-//	unsigned yoffset = (_client_area.h-heigth*m)/2.0 + _client_area.y;
-//
-//	auto it = _clients_tab_order.begin();
-//	for(int i = 0; i < _clients_tab_order.size(); ++i) {
-//		unsigned y = i / n;
-//		unsigned x = i % n;
-//
-//		if(y == m-1)
-//			xoffset = (_client_area.w-width*n)/2.0 + _client_area.x
-//				+ (n*m - _clients_tab_order.size())*width/2.0;
-//
-//		rect pdst(x*width+1.0+xoffset+8, y*heigth+1.0+yoffset+8, width-2.0-16, heigth-2.0-16);
-//		_exposay_buttons.push_back(make_tuple(pdst, client_managed_w{it->client}, i));
-//		pdst = to_root_position(pdst);
-////		auto thumbnail = make_shared<renderable_thumbnail_t>(_ctx, it->client, pdst, ANCHOR_CENTER);
-////		_exposay_thumbnail.push_back(thumbnail);
-////		thumbnail->show();
-//		++it;
-//	}
+	_exposay_buttons.clear();
+	_exposay_mouse_over = nullptr;
+
+	_theme_notebook.button_mouse_over = NOTEBOOK_BUTTON_NONE;
+	_mouse_over.tab = nullptr;
+	_mouse_over.tab_client.reset();
+	_mouse_over.exposay = nullptr;
+
+	if(not _exposay)
+		return;
+
+	if(_clients_tab_order.size() <= 0)
+		return;
+
+	unsigned clients_counts = _clients_tab_order.size();
+
+	/*
+	 * n is the number of column and m is the number of line of exposay.
+	 * Since most window are the size of client_area, we known that n*m will produce n = m
+	 * thus use square root to get n
+	 */
+	int n = static_cast<int>(ceil(sqrt(static_cast<double>(clients_counts))));
+	/* the square root may produce to much line (or column depend on the point of view
+	 * We choose to remove the exide of line, but we could prefer to remove column,
+	 * maybe later we will choose to select this on client_area.h/client_area.w ratio
+	 *
+	 *
+	 * /!\ This equation use the properties of integer division.
+	 *
+	 * we want :
+	 *  if client_counts == Q*n => m = Q
+	 *  if client_counts == Q*n+R with R != 0 => m = Q + 1
+	 *
+	 *  within the equation :
+	 *   when client_counts == Q*n => (client_counts - 1)/n + 1 == (Q - 1) + 1 == Q
+	 *   when client_counts == Q*n + R => (client_counts - 1)/n + 1 == (Q*n+R-1)/n + 1
+	 *     => when R == 1: (Q*n+R-1)/n + 1 == Q*n/n+1 = Q + 1
+	 *     => when 1 < R <= n-1 => (Q*n+R-1)/n + 1 == Q*n/n + (R-1)/n + 1 with (R-1)/n always == 0
+	 *        then (client_counts - 1)/n + 1 == Q + 1
+	 *
+	 */
+	int m = ((clients_counts - 1) / n) + 1;
+
+	unsigned width = _client_area.w/n;
+	unsigned heigth = _client_area.h/m;
+	unsigned xoffset = (_client_area.w-width*n)/2.0 + _client_area.x;
+	unsigned yoffset = (_client_area.h-heigth*m)/2.0 + _client_area.y;
+
+	auto it = _clients_tab_order.begin();
+	for(int i = 0; i < _clients_tab_order.size(); ++i) {
+		unsigned y = i / n;
+		unsigned x = i % n;
+
+		if(y == m-1)
+			xoffset = (_client_area.w-width*n)/2.0 + _client_area.x
+				+ (n*m - _clients_tab_order.size())*width/2.0;
+
+		rect pdst(x*width+1.0+xoffset+8, y*heigth+1.0+yoffset+8, width-2.0-16, heigth-2.0-16);
+		_exposay_buttons.push_back(make_tuple(pdst, view_w{it->client}, i));
+		++it;
+	}
 
 }
 
@@ -856,10 +969,63 @@ void notebook_t::_stop_exposay() {
 	_exposay = false;
 	_mouse_over.exposay = nullptr;
 	_exposay_buttons.clear();
-//	_exposay_thumbnail.clear();
+	disconnect(_ctx->thumbnails()->on_update);
 	queue_redraw();
 }
 
+/**
+ * Paint the exposay thumbnails, they come from the thumbnail cache and may
+ * be not yet available, in that case only the frame is drawn.
+ **/
+void notebook_t::_render_exposay(cairo_t * cr) {
+	for(auto & i: _exposay_buttons) {
+		auto c = std::get<1>(i).lock();
+		if(c == nullptr)
+			continue;
+
+		rect const & pos = std::get<0>(i);
+		auto thumbnail = _ctx->thumbnails()->get(c->surface());
+
+		cairo_save(cr);
+		if(thumbnail != nullptr) {
+			double w = cairo_image_surface_get_width(thumbnail);
+			double h = cairo_image_surface_get_height(thumbnail);
+			double ratio = min(pos.w / w, pos.h / h);
+			cairo_rectangle(cr, pos.x, pos.y, pos.w, pos.h);
+			cairo_clip(cr);
+			cairo_translate(cr, pos.x + (pos.w - w * ratio) / 2.0,
+					pos.y + (pos.h - h * ratio) / 2.0);
+			cairo_scale(cr, ratio, ratio);
+			cairo_set_source_surface(cr, thumbnail, 0.0, 0.0);
+			cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+			cairo_paint(cr);
+			cairo_identity_matrix(cr);
+		}
+
+		cairo_reset_clip(cr);
+		cairo_set_line_width(cr, 2.0);
+		cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+		cairo_rectangle(cr, pos.x + 1, pos.y + 1, pos.w - 2.0, pos.h - 2.0);
+		if(_mouse_over.exposay == &i) {
+			cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+		} else {
+			cairo_set_source_rgb(cr, 0.5, 0.5, 0.5);
+		}
+		cairo_stroke(cr);
+		cairo_restore(cr);
+	}
+}
+
+void notebook_t::_thumbnail_update(weston_surface * s) {
+	for(auto & i: _exposay_buttons) {
+		auto c = std::get<1>(i).lock();
+		if(c != nullptr and c->surface() == s) {
+			queue_redraw();
+			return;
+		}
+	}
+}
+
 bool notebook_t::button(weston_pointer_grab * grab, uint32_t time,
 		uint32_t button, uint32_t state) {
 	auto pointer = grab->pointer;
@@ -912,13 +1078,13 @@ bool notebook_t::button(weston_pointer_grab * grab, uint32_t time,
 			_scroll_right(30);
 			return true;
 		} else {
-			for(auto & i: _client_buttons) {
-				if(std::get<0>(i).is_inside(x, y)) {
-					auto c = std::get<1>(i).lock();
-					_ctx->grab_start(pointer, new grab_bind_client_t{_ctx, c, BTN_LEFT, to_root_position(std::get<0>(i))});
-					_mouse_over_reset();
-					return true;
-				}
+			theme_tab_t * tab;
+			view_p c;
+			rect position;
+			if(_find_tab(x, y, tab, c, position)) {
+				_ctx->grab_start(pointer, new grab_bind_client_t{_ctx, c, BTN_LEFT, to_root_position(position)});
+				_mouse_over_reset();
+				return true;
 			}
 
 			for(auto & i: _exposay_buttons) {
@@ -1017,7 +1183,9 @@ void notebook_t::_update_mouse_over() {
 	if (_allocation.is_inside(x, y)) {
 
 		notebook_button_e new_button_mouse_over = NOTEBOOK_BUTTON_NONE;
-		tuple<rect, view_w, theme_tab_t *> * tab = nullptr;
+		theme_tab_t * tab = nullptr;
+		view_p tab_client;
+		rect tab_position;
 		tuple<rect, view_w, int> * exposay = nullptr;
 
 		if (_area.button_close.is_inside(x, y)) {
@@ -1039,12 +1207,7 @@ void notebook_t::_update_mouse_over() {
 		} else if (_area.right_scroll_arrow.is_inside(x, y)) {
 			new_button_mouse_over = NOTEBOOK_BUTTON_RIGHT_SCROLL_ARROW;
 		} else {
-			for (auto & i : _client_buttons) {
-				if (std::get<0>(i).is_inside(x, y)) {
-					tab = &i;
-					break;
-				}
-			}
+			_find_tab(x, y, tab, tab_client, tab_position);
 
 			for (auto & i : _exposay_buttons) {
 				if (std::get<0>(i).is_inside(x, y)) {
@@ -1061,6 +1224,8 @@ void notebook_t::_update_mouse_over() {
 		} else if (_mouse_over.tab != tab) {
 			_mouse_over_reset();
 			_mouse_over.tab = tab;
+			_mouse_over.tab_client = tab_client;
+			_mouse_over.tab_position = tab_position;
 			_mouse_over_set();
 			queue_redraw();
 		} else if (_mouse_over.exposay != exposay) {
@@ -1122,15 +1287,15 @@ bool notebook_t::motion(weston_pointer_grab * grab, uint32_t time, weston_pointe
 
 void notebook_t::_mouse_over_reset() {
 	if (_mouse_over.tab != nullptr) {
-		if (std::get<1>(*_mouse_over.tab).lock() == _selected
+		if (_mouse_over.tab_client.lock() == _selected
 				and _selected_has_focus) {
-			std::get<2>(*_mouse_over.tab)->tab_color =
+			_mouse_over.tab->tab_color =
 					_ctx->theme()->get_focused_color();
-		} else if (_selected == std::get<1>(*_mouse_over.tab).lock()) {
-			std::get<2>(*_mouse_over.tab)->tab_color =
+		} else if (_selected == _mouse_over.tab_client.lock()) {
+			_mouse_over.tab->tab_color =
 					_ctx->theme()->get_selected_color();
 		} else {
-			std::get<2>(*_mouse_over.tab)->tab_color =
+			_mouse_over.tab->tab_color =
 					_ctx->theme()->get_normal_color();
 		}
 
@@ -1143,6 +1308,7 @@ void notebook_t::_mouse_over_reset() {
 
 	_theme_notebook.button_mouse_over = NOTEBOOK_BUTTON_NONE;
 	_mouse_over.tab = nullptr;
+	_mouse_over.tab_client.reset();
 	_mouse_over.exposay = nullptr;
 	_exposay_mouse_over = nullptr;
 
@@ -1150,9 +1316,9 @@ void notebook_t::_mouse_over_reset() {
 
 void notebook_t::_mouse_over_set() {
 	if (_mouse_over.tab != nullptr) {
-		std::get<2>(*_mouse_over.tab)->tab_color = _ctx->theme()->get_mouse_over_color();
+		_mouse_over.tab->tab_color = _ctx->theme()->get_mouse_over_color();
 
-		rect tab_pos = to_root_position(std::get<0>(*_mouse_over.tab));
+		rect tab_pos = to_root_position(_mouse_over.tab_position);
 
 		rect pos;
 		pos.x = tab_pos.x + tab_pos.w - 256;
@@ -1160,7 +1326,7 @@ void notebook_t::_mouse_over_set() {
 		pos.w = 256;
 		pos.h = 256;
 
-		if(std::get<1>(*_mouse_over.tab).lock() != _selected) {
+		if(_mouse_over.tab_client.lock() != _selected) {
 //			tooltips = make_shared<renderable_thumbnail_t>(_ctx, std::get<1>(*_mouse_over.tab).lock(), pos, ANCHOR_TOP_RIGHT);
 //			tooltips->set_parent(this);
 //			tooltips->show();
@@ -1177,23 +1343,90 @@ void notebook_t::_mouse_over_set() {
 }
 
 void notebook_t::_client_title_change(view_t * c) {
-	for(auto & x: _client_buttons) {
-		if(c == std::get<1>(x).lock().get()) {
-			std::get<2>(x)->title = c->title();
-		}
+	++_title_stats.received;
+	_has_pending_title = true;
+	if(_pending_titles.empty() or _pending_titles.back() != c)
+		_pending_titles.push_back(c);
+
+	/* the first change after an idle frame is applied at once */
+	if(not _is_waiting_title_frame)
+		_apply_pending_titles();
+
+	_wait_title_frame();
+}
+
+void notebook_t::_apply_pending_titles() {
+	if(not _has_pending_title)
+		return;
+	_has_pending_title = false;
+	++_title_stats.applied;
+
+	/* the pending update will read the new titles */
+	if(_layout_is_durty or _tabs_is_durty) {
+		_pending_titles.clear();
+		return;
 	}
 
-	for(auto & x: _exposay_buttons) {
-		if(c == std::get<1>(x).lock().get()) {
-			//_exposay_thumbnail[std::get<2>(x)]->update_title();
+	/* only the tabs of the changed clients are updated */
+	region damaged;
+	for(auto c: _pending_titles) {
+		auto x = _clients_index.find(c);
+		if(x == _clients_index.end())
+			continue;
+
+		size_t index = x->second->tab;
+		if(index < _theme_client_tabs.size()
+				and _theme_client_tabs[index].title != c->title()) {
+			_theme_client_tabs[index].title = c->title();
+			damaged += _tab_position(index) & _theme_client_tabs_area;
+		}
+
+		auto & selected = _theme_notebook.selected_client;
+		if(c == _selected.get() and _theme_notebook.has_selected_client
+				and selected.title != c->title()) {
+			selected.title = c->title();
+			damaged += selected.position;
 		}
 	}
+	_pending_titles.clear();
 
-	if(c == _selected.get()) {
-		_theme_notebook.selected_client.title = c->title();
+	if(damaged.empty()) {
+		++_title_stats.unchanged;
+		return;
 	}
-	_schedule_repaint();
 
+	queue_redraw_area(damaged);
+}
+
+void notebook_t::_wait_title_frame() {
+	if(_is_waiting_title_frame or not _is_visible)
+		return;
+
+	auto output = get_output();
+	if(output == nullptr)
+		return;
+
+	_on_title_frame.connect(&output->frame_signal, this,
+			&notebook_t::_title_frame);
+	_is_waiting_title_frame = true;
+	weston_output_schedule_repaint(output);
+}
+
+void notebook_t::_title_frame(weston_output * output) {
+	if(_has_pending_title) {
+		_apply_pending_titles();
+		weston_output_schedule_repaint(output);
+	} else {
+		_on_title_frame.disconnect();
+		_is_waiting_title_frame = false;
+	}
+}
+
+void notebook_t::dump_title_stats() {
+	weston_log("notebook titles: %lu changes, %lu applied, %lu coalesced, %lu unchanged\n",
+			_title_stats.received, _title_stats.applied,
+			_title_stats.received - _title_stats.applied,
+			_title_stats.unchanged);
 }
 
 void notebook_t::_client_destroy(view_t * c) {
@@ -1247,19 +1480,15 @@ void notebook_t::show() {
 }
 
 bool notebook_t::_has_client(view_p c) {
-	return _find_client_context(c) != _clients_tab_order.end();
+	return _clients_index.count(c.get()) > 0;
 }
 
 list<notebook_t::_client_context_t>::iterator
 notebook_t::_find_client_context(view_p client) {
-	auto itr = _clients_tab_order.begin();
-	auto end = _clients_tab_order.end();
-	while(itr != end) {
-		if(itr->client == client)
-			return itr;
-		++itr;
-	}
-	return end;
+	auto x = _clients_index.find(client.get());
+	if(x == _clients_index.end())
+		return _clients_tab_order.end();
+	return x->second;
 }
 
 void notebook_t::render(cairo_t * cr, region const & area) {
@@ -1377,8 +1606,13 @@ void notebook_t::_schedule_repaint() {
 	queue_redraw();
 }
 
+void notebook_t::_schedule_tabs_update() {
+	_tabs_is_durty = true;
+	queue_redraw();
+}
+
 notebook_t::_client_context_t::_client_context_t(notebook_t * nbk,
-		view_p client) : client{client} {
+		view_p client, size_t tab) : client{client}, tab{tab} {
 }
 
 notebook_t::_client_context_t::~_client_context_t() {
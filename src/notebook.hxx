@@ -14,8 +14,10 @@
 #include <cmath>
 #include <cassert>
 #include <memory>
+#include <unordered_map>
 
 #include "theme.hxx"
+#include "listener.hxx"
 #include "pixmap.hxx"
 #include "renderable_notebook_fading.hxx"
 #include "renderable_pixmap.hxx"
@@ -24,6 +26,8 @@
 #include "page_context.hxx"
 #include "page_component.hxx"
 #include "renderable_thumbnail.hxx"
+#include "thumbnail_cache.hxx"
+#include "render_worker.hxx"
 #include "renderable_unmanaged_gaussian_shadow.hxx"
 #include "dropdown_menu.hxx"
 #include "xdg-shell-v5-surface-toplevel.hxx"
@@ -61,15 +65,26 @@ class notebook_t : public page_component_t {
 	bool _can_vsplit;
 	bool _has_scroll_arrow;
 	bool _layout_is_durty;
+	/* only the tab list changed, client positions are still valid */
+	bool _tabs_is_durty;
 	bool _has_mouse_change;
 	bool _selected_is_iconic;
 	bool _selected_has_focus;
 
+	/* title changes are applied at most once per frame */
+	listener_t<weston_output> _on_title_frame;
+	bool _is_waiting_title_frame;
+	bool _has_pending_title;
+	/* clients whose title changed since the last applied frame */
+	vector<view_t *> _pending_titles;
+
 	struct {
 		int event_x;
 		int event_y;
-		tuple<rect, view_w, theme_tab_t *> * tab;
+		theme_tab_t * tab;
 		tuple<rect, view_w, int> * exposay;
+		view_w tab_client;
+		rect tab_position;
 	} _mouse_over;
 
 	enum select_e {
@@ -83,10 +98,12 @@ class notebook_t : public page_component_t {
 
 	struct _client_context_t {
 		view_p client;
+		/* index of the client tab in _theme_client_tabs */
+		size_t tab;
 
 		_client_context_t() = delete;
 		_client_context_t(_client_context_t const & x) = default;
-		_client_context_t(notebook_t * nbk, view_p client);
+		_client_context_t(notebook_t * nbk, view_p client, size_t tab);
 		~_client_context_t();
 
 	};
@@ -96,6 +113,11 @@ class notebook_t : public page_component_t {
 
 	// list to maintain the client order
 	list<_client_context_t> _clients_tab_order;
+	/* index of _clients_tab_order, list iterators stay valid on erase */
+	unordered_map<view_t *, list<_client_context_t>::iterator> _clients_index;
+
+	/* client area, in root coordinates, the clients were last placed at */
+	rect _positioned_client_area;
 
 	view_p _selected;
 
@@ -129,8 +151,8 @@ class notebook_t : public page_component_t {
 
 	} _area;
 
-	/* list of tabs and exposay buttons */
-	vector<tuple<rect, view_w, theme_tab_t *>> _client_buttons;
+	/* client of each tab of _theme_client_tabs */
+	vector<view_w> _client_tabs;
 	vector<tuple<rect, view_w, int>> _exposay_buttons;
 	shared_ptr<renderable_unmanaged_gaussian_shadow_t<16>> _exposay_mouse_over;
 
@@ -142,6 +164,15 @@ class notebook_t : public page_component_t {
 	void _update_notebook_areas();
 	void _update_theme_notebook(theme_notebook_t & theme_notebook);
 	void _update_layout();
+	void _update_tabs();
+	void _update_tabs_geometry();
+	void _rebuild_tabs();
+	auto _make_tab(view_p c, size_t index) -> theme_tab_t;
+	auto _tab_color(view_p c) -> color_t;
+	auto _tab_position(size_t index) const -> rect;
+	bool _find_tab(int x, int y, theme_tab_t *& tab, view_p & client, rect & position);
+	void _append_tab(view_p c);
+	void _erase_tab(size_t index);
 	void _update_mouse_over();
 
 	//void _process_notebook_client_menu(dropdown_menu_t<int> * ths, shared_ptr<xdg_surface_toplevel_t> c, int selected);
@@ -158,6 +189,9 @@ class notebook_t : public page_component_t {
 	rect _compute_notebook_menu_position() const;
 
 	void _client_title_change(view_t * c);
+	void _apply_pending_titles();
+	void _wait_title_frame();
+	void _title_frame(weston_output * output);
 	void _client_destroy(view_t * c);
 	void _client_focus_change(view_t * c);
 
@@ -170,8 +204,6 @@ class notebook_t : public page_component_t {
 
 	rect _get_new_client_size();
 
-	void _select_next();
-
 	rect _compute_client_size(view_p c);
 
 	auto clients() const -> list<view_p>;
@@ -183,6 +215,8 @@ class notebook_t : public page_component_t {
 
 	void _update_exposay();
 	void _stop_exposay();
+	void _render_exposay(cairo_t * cr);
+	void _thumbnail_update(weston_surface * s);
 	//void _start_client_menu(shared_ptr<xdg_surface_toplevel_t> c, xcb_button_t button, uint16_t x, uint16_t y);
 
 	void _scroll_left(int x);
@@ -190,6 +224,7 @@ class notebook_t : public page_component_t {
 
 	void _set_theme_tab_offset(int x);
 	void _schedule_repaint();
+	void _schedule_tabs_update();
 
 	shared_ptr<notebook_t> shared_from_this();
 	void update_layout();
@@ -203,6 +238,7 @@ public:
 	 * tree_t interface
 	 **/
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	virtual void remove(shared_ptr<tree_t> src);
 	virtual void append_children(vector<shared_ptr<tree_t>> & out) const;
 	virtual void hide();
@@ -238,7 +274,13 @@ public:
 	 * notebook_t interface
 	 **/
 	void set_default(bool x);
+	/* log title change counters of all notebooks */
+	static void dump_title_stats();
 	void render_legacy(cairo_t * cr);
+	/* snapshot of the theme description, for the render worker */
+	auto get_render_state() -> notebook_render_state_t;
+	/* exposay use live thumbnails, it is not rendered by the worker */
+	bool has_exposay() const;
 	void start_exposay();
 	void update_client_position(view_p c);
 	void iconify_client(view_p x);
@@ -13,6 +13,7 @@
 
 #include <cairo.h>
 
+#include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
@@ -27,6 +28,7 @@
 #include <vector>
 #include <typeinfo>
 #include <memory>
+#include <algorithm>
 #include <utility>
 #include <list>
 
@@ -38,6 +40,7 @@
 #include <compositor.h>
 #include <compositor-x11.h>
 #include <compositor-drm.h>
+#include <compositor-headless.h>
 #include <windowed-output-api.h>
 #include <wayland-client-protocol.h>
 #include <xdg-shell-v5-shell.hxx>
@@ -113,7 +116,10 @@ static void _default_grab_cancel(weston_pointer_grab * grab) {
 }
 
 void page_t::page_repaint_idle() {
+	/* viewports of all outputs are rendered in parallel and attached together */
+	_render_worker.begin_batch();
 	_root->broadcast_trigger_redraw();
+	_render_worker.end_batch();
 	weston_compositor_schedule_repaint(ec);
 	repaint_scheduled = false;
 }
@@ -137,9 +143,12 @@ void page_t::destroy_surface(surface_t * s) {
 		grab_stop(_grab_handler->base.grab.pointer);
 	}
 
-	detach(s->_master_view.lock());
+	/* only the area of the view, its popups and transients is exposed */
+	auto master_view = s->_master_view.lock();
+	damage_tree_views(master_view);
+	detach(master_view);
 	assert(s->_master_view.expired());
-	weston_compositor_damage_all(ec);
+	_client_accounting.view_destroyed(wl_resource_get_client(s->surface()->resource));
 	sync_tree_view();
 }
 
@@ -149,6 +158,10 @@ void page_t::start_move(surface_t * s, struct weston_seat * seat, uint32_t seria
 		return;
 
 	auto pointer = weston_seat_get_pointer(seat);
+	/* only on a pressed button, as reported to the client */
+	if(pointer == nullptr or pointer->button_count == 0
+			or pointer->grab_serial != serial or _grab_handler != nullptr)
+		return;
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
 
@@ -167,6 +180,10 @@ void page_t::start_resize(surface_t * s, struct weston_seat * seat, uint32_t ser
 		return;
 
 	auto pointer = weston_seat_get_pointer(seat);
+	/* only on a pressed button, as reported to the client */
+	if(pointer == nullptr or pointer->button_count == 0
+			or pointer->grab_serial != serial or _grab_handler != nullptr)
+		return;
 	double x = wl_fixed_to_double(pointer->x);
 	double y = wl_fixed_to_double(pointer->y);
 
@@ -186,14 +203,22 @@ static void ack_buffer(struct wl_client *client,
 
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 
-	auto x = std::find_if(ths->pixmap_list.begin(), ths->pixmap_list.end(),
-			[serial](pixmap_p p) -> bool{
-				return p->serial() == serial;
-			});
+	auto x = ths->_pending_pixmaps.find(serial);
+	if(x != ths->_pending_pixmaps.end())
+		x->second->ack_buffer(client, resource, serial, surface, buffer);
 
-	if(x != ths->pixmap_list.end())
-		(*x)->ack_buffer(client, resource, serial, surface, buffer);
+}
 
+static void ack_cursor(struct wl_client *client,
+		   wl_resource * resource,
+		   uint32_t shape,
+		   wl_resource * surface,
+		   int32_t hotspot_x,
+		   int32_t hotspot_y) {
+	auto ths = reinterpret_cast<page_t*>(wl_resource_get_user_data(resource));
+	auto s = reinterpret_cast<weston_surface*>(wl_resource_get_user_data(surface));
+	ths->_cursors.set_shape(static_cast<cursor_shape_e>(shape), s,
+			hotspot_x, hotspot_y);
 }
 
 static void xx_buffer_delete(wl_resource * r) {
@@ -202,7 +227,8 @@ static void xx_buffer_delete(wl_resource * r) {
 }
 
 static const struct zzz_buffer_manager_interface _zzz_buffer_manager_implementation = {
-		ack_buffer
+		ack_buffer,
+		ack_cursor
 };
 
 //time64_t const page_t::default_wait{1000000000L / 120L};
@@ -214,6 +240,7 @@ void page_t::bind_xdg_shell_v5(struct wl_client * client, void * data,
 	auto c = new xdg_shell_client_t{ths, client, id};
 	ths->connect(c->destroy, ths, &page_t::xdg_shell_v5_client_destroy);
 	ths->_xdg_shell_v5_clients.push_back(c);
+	ths->_client_accounting.shell_bound(client);
 
 }
 
@@ -224,6 +251,7 @@ void page_t::bind_xdg_shell_v6(struct wl_client * client, void * data,
 	auto c = new xdg_shell_v6_client_t{ths, client, id};
 	ths->connect(c->destroy, ths, &page_t::xdg_shell_v6_client_destroy);
 	ths->_xdg_shell_v6_clients.push_back(c);
+	ths->_client_accounting.shell_bound(client);
 
 }
 
@@ -234,6 +262,7 @@ void page_t::bind_wl_shell(struct wl_client * client, void * data,
 	auto c = new wl_shell_client_t{ths, client, id};
 	ths->connect(c->destroy, ths, &page_t::wl_shell_client_destroy);
 	ths->_wl_shell_clients.push_back(c);
+	ths->_client_accounting.shell_bound(client);
 
 }
 
@@ -247,7 +276,7 @@ void page_t::bind_zzz_buffer_manager(struct wl_client * client, void * data,
 
 	/* ONLY one those client */
 	ths->_buffer_manager_resource = wl_resource_create(client,
-			&::zzz_buffer_manager_interface, 1, id);
+			&::zzz_buffer_manager_interface, 4, id);
 
 	/**
 	 * Define the implementation of the resource and the user_data,
@@ -268,6 +297,25 @@ void page_t::print_tree_binding(struct weston_keyboard *keyboard, uint32_t time,
 	page_t * ths = reinterpret_cast<page_t *>(data);
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 	ths->_root->print_tree(0);
+	ths->dump_client_accounting();
+}
+
+/**
+ * SIGUSR1 is read by the main loop through a signalfd, it must be blocked
+ * in every thread, otherwise the kernel may deliver it to one of them and
+ * kill page. Threads inherit the mask of their creator.
+ **/
+static void _mask_dump_signal(int how) {
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGUSR1);
+	pthread_sigmask(how, &mask, nullptr);
+}
+
+int page_t::dump_signal(int signal_number, void * data) {
+	page_t * ths = reinterpret_cast<page_t *>(data);
+	ths->write_dump();
+	return 0;
 }
 
 page_t::page_t(int argc, char ** argv) :
@@ -277,11 +325,14 @@ page_t::page_t(int argc, char ** argv) :
 	char const * conf_file_name = 0;
 
 	use_x11_backend = false;
+	use_headless_backend = false;
 	use_pixman = false;
 	_global_wl_shell = nullptr;
 	_global_xdg_shell_v5 = nullptr;
 	_global_xdg_shell_v6 = nullptr;
 	_global_buffer_manager = nullptr;
+	_startup_keymap = nullptr;
+	_has_first_frame = false;
 	configuration._replace_wm = false;
 	configuration._menu_drop_down_shadow = false;
 
@@ -292,6 +343,10 @@ page_t::page_t(int argc, char ** argv) :
 		string x = argv[k];
 		if(x == "--replace") {
 			configuration._replace_wm = true;
+		} else if(x == "--headless") {
+			use_headless_backend = true;
+		} else if(x == "--record" and k + 1 < argc) {
+			_record_file = argv[++k];
 		} else {
 			conf_file_name = argv[k];
 		}
@@ -306,94 +361,56 @@ page_t::page_t(int argc, char ** argv) :
 	/* load configurations, from lower priority to high one */
 
 	/* load default configuration */
-	_conf.merge_from_file_if_exist(string{DATA_DIR "/page/page.conf"});
+	_config_files.push_back(DATA_DIR "/page/page.conf");
 
 	/* load homedir configuration */
 	{
 		char const * chome = getenv("HOME");
 		if(chome != nullptr) {
 			string xhome = chome;
-			string file = xhome + "/.page.conf";
-			_conf.merge_from_file_if_exist(file);
+			_config_files.push_back(xhome + "/.page.conf");
 		}
 	}
 
 	/* load file in arguments if provided */
 	if (conf_file_name != nullptr) {
-		string s(conf_file_name);
-		_conf.merge_from_file_if_exist(s);
+		_config_files.push_back(conf_file_name);
 	}
 
-	page_base_dir = _conf.get_string("default", "theme_dir");
-	_theme_engine = _conf.get_string("default", "theme_engine");
+	_config = page_config_t::load(_config_files);
+	_startup.mark("configuration");
 
 //	_left_most_border = std::numeric_limits<int>::max();
 //	_top_most_border = std::numeric_limits<int>::max();
 
 	_theme = nullptr;
+	_startup_theme = nullptr;
 
 	_buffer_manager_resource = nullptr;
+	_internal_client = nullptr;
+	_pixmap_local_allocation = _config->pixmap_local_allocation;
 
 	_grab_handler = nullptr;
+	_dump_signal_source = nullptr;
 
-	bind_page_quit           = _conf.get_string("default", "bind_page_quit");
-	bind_close               = _conf.get_string("default", "bind_close");
-	bind_toggle_fullscreen   = _conf.get_string("default", "bind_toggle_fullscreen");
-	bind_toggle_compositor   = _conf.get_string("default", "bind_toggle_compositor");
-	bind_right_desktop       = _conf.get_string("default", "bind_right_desktop");
-	bind_left_desktop        = _conf.get_string("default", "bind_left_desktop");
-
-	bind_bind_window         = _conf.get_string("default", "bind_bind_window");
-	bind_fullscreen_window   = _conf.get_string("default", "bind_fullscreen_window");
-	bind_float_window        = _conf.get_string("default", "bind_float_window");
-
-	bind_cmd[0].key = _conf.get_string("default", "bind_cmd_0");
-	bind_cmd[1].key = _conf.get_string("default", "bind_cmd_1");
-	bind_cmd[2].key = _conf.get_string("default", "bind_cmd_2");
-	bind_cmd[3].key = _conf.get_string("default", "bind_cmd_3");
-	bind_cmd[4].key = _conf.get_string("default", "bind_cmd_4");
-	bind_cmd[5].key = _conf.get_string("default", "bind_cmd_5");
-	bind_cmd[6].key = _conf.get_string("default", "bind_cmd_6");
-	bind_cmd[7].key = _conf.get_string("default", "bind_cmd_7");
-	bind_cmd[8].key = _conf.get_string("default", "bind_cmd_8");
-	bind_cmd[9].key = _conf.get_string("default", "bind_cmd_9");
-
-	bind_cmd[0].cmd = _conf.get_string("default", "exec_cmd_0");
-	bind_cmd[1].cmd = _conf.get_string("default", "exec_cmd_1");
-	bind_cmd[2].cmd = _conf.get_string("default", "exec_cmd_2");
-	bind_cmd[3].cmd = _conf.get_string("default", "exec_cmd_3");
-	bind_cmd[4].cmd = _conf.get_string("default", "exec_cmd_4");
-	bind_cmd[5].cmd = _conf.get_string("default", "exec_cmd_5");
-	bind_cmd[6].cmd = _conf.get_string("default", "exec_cmd_6");
-	bind_cmd[7].cmd = _conf.get_string("default", "exec_cmd_7");
-	bind_cmd[8].cmd = _conf.get_string("default", "exec_cmd_8");
-	bind_cmd[9].cmd = _conf.get_string("default", "exec_cmd_9");
-
-	if(_conf.get_string("default", "auto_refocus") == "true") {
-		configuration._auto_refocus = true;
-	} else {
-		configuration._auto_refocus = false;
-	}
-
-	if(_conf.get_string("default", "enable_shade_windows") == "true") {
-		configuration._enable_shade_windows = true;
-	} else {
-		configuration._enable_shade_windows = false;
-	}
+	_workspace_snapshot_timer = nullptr;
 
-	if(_conf.get_string("default", "mouse_focus") == "true") {
-		configuration._mouse_focus = true;
-	} else {
-		configuration._mouse_focus = false;
-	}
+	configuration._auto_refocus = _config->auto_refocus;
+	configuration._enable_shade_windows = _config->enable_shade_windows;
+	configuration._mouse_focus = _config->mouse_focus;
+	configuration._menu_drop_down_shadow = _config->menu_drop_down_shadow;
+	configuration._fade_in_time = _config->fade_in_time;
+	configuration._coalesce_grab_motion = _config->coalesce_grab_motion;
+	/* the proxy copy read the client buffer, only current with pixman */
+	configuration._scaled_client_proxy = _config->scaled_client_proxy
+			and use_pixman and _config->pixmap_local_allocation;
 
-	if(_conf.get_string("default", "menu_drop_down_shadow") == "true") {
-		configuration._menu_drop_down_shadow = true;
-	} else {
-		configuration._menu_drop_down_shadow = false;
-	}
+	_client_accounting.limits = _config->client_limits;
+	_thumbnails.limits = _config->thumbnail_limits;
 
-	configuration._fade_in_time = _conf.get_long("compositor", "fade_in_time");
+	_workspace_snapshot_scale = _config->workspace_snapshot_scale;
+	_workspace_snapshot_max_bytes = _config->workspace_snapshot_max_bytes;
+	_workspace_snapshot_idle_timeout = _config->workspace_snapshot_idle_timeout;
 
 
 	default_grab_pod.grab_interface.focus = &_default_grab_focus;
@@ -408,6 +425,10 @@ page_t::page_t(int argc, char ** argv) :
 }
 
 page_t::~page_t() {
+	/* pixmaps report to the accounting, release them before it */
+	_viewport_buffers.clear();
+	pixmap_list.clear();
+
 	// cleanup cairo, for valgrind happiness.
 	//cairo_debug_reset_static_data();
 }
@@ -419,11 +440,42 @@ static int page_log_print(const char * fmt, va_list args) {
 
 void page_t::run() {
 
+	/* before any thread is created */
+	_mask_dump_signal(SIG_BLOCK);
+
 	if(g_logfile) {
 		fclose(g_logfile);
 	}
 
-	g_logfile = fopen(_conf.get_string("default", "log_file").c_str() ,"w");
+	g_logfile = fopen(_config->log_file.c_str() ,"w");
+
+	/* work that do not need the compositor run while the backend start */
+	{
+		auto config = _config;
+		/* only read by the main thread once the task is done */
+		_startup.add("theme", {}, [this, config]() {
+			_startup_theme = create_theme(*config);
+		});
+
+		_startup.add("fonts", {}, [config]() {
+			simple2_theme_t::warm_up_fonts(config->simple_theme);
+		});
+
+		_startup.add("keymap", {}, [this, config]() {
+			xkb_rule_names names = {
+				config->xkb_rules.c_str(),
+				config->xkb_model.c_str(),
+				config->xkb_layout.c_str(),
+				config->xkb_variant.c_str(),
+				config->xkb_options.c_str()
+			};
+			auto xkb_ctx = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+			_startup_keymap = xkb_keymap_new_from_names(xkb_ctx, &names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+			xkb_context_unref(xkb_ctx);
+		});
+
+		_startup.start();
+	}
 
 	/** initialize the empty desktop **/
 	_root = make_shared<page_root_t>(this);
@@ -433,19 +485,11 @@ void page_t::run() {
 		auto d = make_shared<workspace_t>(this, 0);
 		_root->_desktop_list.push_back(d);
 		_root->_desktop_stack->push_front(d);
-		d->hide();
+		d->show();
 	}
 
-	/** Initialize theme **/
-
-	if(_theme_engine == "tiny") {
-		cout << "using tiny theme engine" << endl;
-		_theme = new tiny_theme_t{_conf};
-	} else {
-		/* The default theme engine */
-		cout << "using simple theme engine" << endl;
-		_theme = new simple2_theme_t{_conf};
-	}
+	while(get_workspace_count() < _config->workspace_count)
+		create_workspace();
 
 	/* start listen root event before anything, each event will be stored to be processed later */
 	/** TODO: set default grab **/
@@ -486,6 +530,10 @@ void page_t::run() {
 	/* set the environment for children */
 	setenv("WAYLAND_DISPLAY", sock_name, 1);
 
+	/* written on SIGUSR1, next to the socket */
+	if(getenv("XDG_RUNTIME_DIR"))
+		_dump_file = string{getenv("XDG_RUNTIME_DIR")} + "/" + sock_name + ".dump";
+
 	int xxx[2];
 
 	socketpair(AF_UNIX, SOCK_STREAM, 0, xxx);
@@ -494,7 +542,8 @@ void page_t::run() {
 	_buffer_manager = std::thread{buffer_manager_main, xxx[1]};
 
 	/* connect to the serveur the other hand */
-	auto client = wl_client_create(_dpy, xxx[0]);
+	_internal_client = wl_client_create(_dpy, xxx[0]);
+	_client_accounting.set_internal_client(_internal_client);
 
 	/*
 	 * Weston compositor will create all core globals:
@@ -511,6 +560,7 @@ void page_t::run() {
 	 */
 	ec = weston_compositor_create(_dpy, nullptr);
 	weston_log("weston_compositor = %p\n", ec);
+	_startup.mark("compositor");
 
 	ec->user_data = this;
 	ec->vt_switching = 1;
@@ -523,7 +573,7 @@ void page_t::run() {
 			&page_t::bind_xdg_shell_v5);
 	_global_xdg_shell_v6 = wl_global_create(_dpy, &zxdg_shell_v6_interface, 1, this,
 			&page_t::bind_xdg_shell_v6);
-	_global_buffer_manager = wl_global_create(_dpy, &::zzz_buffer_manager_interface, 1, this, &page_t::bind_zzz_buffer_manager);
+	_global_buffer_manager = wl_global_create(_dpy, &::zzz_buffer_manager_interface, 4, this, &page_t::bind_zzz_buffer_manager);
 
 
 	connect_all();
@@ -532,28 +582,44 @@ void page_t::run() {
 	/* setup the keyboard layout (MANDATORY) */
 	xkb_rule_names names = {
 			/* weston steal those pointers ... */
-			strdup(_conf.get_string("default", "xkb_rules").c_str()),					/*rules*/
-			strdup(_conf.get_string("default", "xkb_model").c_str()),			/*model*/
-			strdup(_conf.get_string("default", "xkb_layout").c_str()),				/*layout*/
-			strdup(_conf.get_string("default", "xkb_variant").c_str()),					/*variant*/
-			strdup(_conf.get_string("default", "xkb_options").c_str())					/*option*/
+			strdup(_config->xkb_rules.c_str()),		/*rules*/
+			strdup(_config->xkb_model.c_str()),		/*model*/
+			strdup(_config->xkb_layout.c_str()),	/*layout*/
+			strdup(_config->xkb_variant.c_str()),	/*variant*/
+			strdup(_config->xkb_options.c_str())	/*option*/
 	};
 
 	weston_compositor_set_xkb_rule_names(ec, &names);
 
+	/* outputs are created by the backend within libweston signals, the
+	 * theme is needed there but its errors cannot be thrown through C,
+	 * thus they stop page here. */
+	wait_startup_theme();
+
 	char * display = getenv("DISPLAY");
-	if(display) {
+	if(use_headless_backend) {
+		load_headless_backend(ec);
+	} else if(display) {
 		use_x11_backend = true;
 		load_x11_backend(ec);
 	} else {
 		use_x11_backend = false;
 		load_drm_backend(ec);
 	}
+	_startup.mark("backend");
 
 	update_viewport_layout();
+	_startup.mark("layout");
 
 	weston_compositor_set_default_pointer_grab(ec, &default_grab_pod.grab_interface);
 
+	_dump_signal_source = wl_event_loop_add_signal(wl_display_get_event_loop(_dpy),
+			SIGUSR1, &page_t::dump_signal, this);
+
+	/* after the buffer manager, its messages are not recorded */
+	if(not _record_file.empty())
+		_recorder.start(_dpy, _record_file, _internal_client);
+
 	weston_compositor_wake(ec);
 
     wl_display_run(_dpy);
@@ -564,11 +630,29 @@ void page_t::run() {
 	//_dpy->on_visibility_change.remove(on_visibility_change_func);
 	//_mainloop.remove_poll(_dpy->fd());
 
+	_recorder.stop();
+	if(_dump_signal_source) {
+		wl_event_source_remove(_dump_signal_source);
+		_dump_signal_source = nullptr;
+	}
+
+	if(_workspace_snapshot_timer) {
+		wl_event_source_remove(_workspace_snapshot_timer);
+		_workspace_snapshot_timer = nullptr;
+	}
+	_on_compositor_idle.disconnect();
+
+	_config_watcher.stop();
+	_render_worker.stop();
+	_wallpaper.stop();
+	_startup.finish();
+
 	/** destroy the tree **/
 	_root = nullptr;
 
 	//delete _keymap; _keymap = nullptr;
 	delete _theme; _theme = nullptr;
+	delete _startup_theme; _startup_theme = nullptr;
 
 }
 
@@ -661,11 +745,197 @@ void page_t::handle_close_window(weston_keyboard * wk, uint32_t time, uint32_t k
 }
 
 void page_t::handle_goto_desktop_at_right(weston_keyboard * wk, uint32_t time, uint32_t key) {
-
+	weston_log("call %s\n", __PRETTY_FUNCTION__);
+	unsigned count = _root->_desktop_list.size();
+	switch_to_workspace(wk->seat, (_root->_current_desktop + 1) % count,
+			WORKSPACE_SWITCH_RIGHT);
 }
 
 void page_t::handle_goto_desktop_at_left(weston_keyboard * wk, uint32_t time, uint32_t key) {
+	weston_log("call %s\n", __PRETTY_FUNCTION__);
+	unsigned count = _root->_desktop_list.size();
+	switch_to_workspace(wk->seat, (_root->_current_desktop + count - 1) % count,
+			WORKSPACE_SWITCH_LEFT);
+}
 
+/**
+ * Switch to workspace id, the slide animation only use the snapshots of
+ * both workspaces. The workspace we leave is captured now, while its
+ * viewports still hold their back buffers. The destination cannot be
+ * captured while hidden, its snapshot is the one taken when we left it,
+ * if nothing changed since, otherwise the switch is not animated.
+ **/
+void page_t::switch_to_workspace(weston_seat * seat, unsigned id,
+		workspace_switch_direction_e direction) {
+	assert(id < _root->_desktop_list.size());
+	if(id == _root->_current_desktop)
+		return;
+
+	for(auto & x: _workspace_switchs)
+		x.second->finish();
+
+	auto from = get_current_workspace();
+	auto to = get_workspace(id);
+
+	if(not from->has_valid_snapshot())
+		from->take_snapshot(_workspace_snapshot_scale);
+	if(to->has_valid_snapshot())
+		update_workspace_snapshot_lru(to);
+	update_workspace_snapshot_lru(from);
+	/* the memory cap may have dropped the destination snapshot */
+	bool animate = to->has_valid_snapshot();
+
+	from->hide();
+	_root->_current_desktop = id;
+	_root->_desktop_stack->remove(to);
+	_root->_desktop_stack->push_back(to);
+	to->show();
+
+	if(animate)
+		to->start_switch(direction, from);
+
+	view_p focus;
+	if(to->client_focus_history_front(focus)) {
+		set_keyboard_focus(seat, focus);
+	} else {
+		if(not _current_focus.expired())
+			_current_focus.lock()->set_focus_state(false);
+		_current_focus.reset();
+		weston_seat_set_keyboard_focus(seat, nullptr);
+	}
+
+	if(_workspace_snapshot_timer and _workspace_snapshot_idle_timeout > 0)
+		wl_event_source_timer_update(_workspace_snapshot_timer,
+				_workspace_snapshot_idle_timeout * 1000);
+
+	sync_tree_view();
+}
+
+/**
+ * Move w in front of the snapshot LRU and drop the least recently used
+ * snapshots until we fit the configured memory cap.
+ **/
+void page_t::update_workspace_snapshot_lru(workspace_p w) {
+	_workspace_snapshot_lru.remove_if([](workspace_w const & x) {
+		return x.expired() or not x.lock()->has_valid_snapshot();
+	});
+	move_front(_workspace_snapshot_lru, w);
+
+	size_t total = 0;
+	for(auto & x: _workspace_snapshot_lru)
+		total += x.lock()->snapshot_size();
+
+	while(total > _workspace_snapshot_max_bytes
+			and _workspace_snapshot_lru.size() > 1) {
+		auto x = _workspace_snapshot_lru.back().lock();
+		_workspace_snapshot_lru.pop_back();
+		total -= x->snapshot_size();
+		x->drop_snapshot();
+	}
+}
+
+void page_t::drop_workspace_snapshots() {
+	weston_log("call %s\n", __PRETTY_FUNCTION__);
+	for(auto & x: _workspace_snapshot_lru) {
+		if(not x.expired())
+			x.lock()->drop_snapshot();
+	}
+	_workspace_snapshot_lru.clear();
+}
+
+auto page_t::create_theme(page_config_t const & config) -> theme_t * {
+	if(config.theme_engine == "tiny") {
+		cout << "using tiny theme engine" << endl;
+		return new tiny_theme_t{config.simple_theme};
+	} else {
+		/* The default theme engine */
+		cout << "using simple theme engine" << endl;
+		return new simple2_theme_t{config.simple_theme};
+	}
+}
+
+/**
+ * The startup theme is built by a worker, it is published to _theme by the
+ * main thread on first use, thus _theme is never written concurrently.
+ **/
+void page_t::wait_startup_theme() {
+	if(_theme != nullptr)
+		return;
+	_startup.wait("theme");
+	_theme = _startup_theme;
+	_startup_theme = nullptr;
+}
+
+void page_t::update_theme() {
+	/* the startup theme may still be in construction */
+	wait_startup_theme();
+	auto theme = create_theme(*_config);
+
+	delete _theme;
+	_theme = theme;
+
+	if(_root == nullptr)
+		return;
+
+	/* theme metrics may have changed, layout everything again */
+	for(auto & w: _root->_desktop_list) {
+		for(auto & v: w->get_viewports())
+			v->set_allocation(v->allocation());
+	}
+
+	drop_workspace_snapshots();
+	sync_tree_view();
+	schedule_repaint();
+}
+
+/**
+ * Switch to a new configuration snapshot, only subsystems depending on
+ * changed values are updated.
+ **/
+void page_t::apply_config(page_config_p config) {
+	auto old = _config;
+	_config = config;
+
+	configuration._auto_refocus = _config->auto_refocus;
+	configuration._enable_shade_windows = _config->enable_shade_windows;
+	configuration._mouse_focus = _config->mouse_focus;
+	configuration._menu_drop_down_shadow = _config->menu_drop_down_shadow;
+	configuration._fade_in_time = _config->fade_in_time;
+	configuration._coalesce_grab_motion = _config->coalesce_grab_motion;
+	/* the proxy copy read the client buffer, only current with pixman */
+	configuration._scaled_client_proxy = _config->scaled_client_proxy
+			and use_pixman and _config->pixmap_local_allocation;
+
+	_client_accounting.limits = _config->client_limits;
+	_thumbnails.limits = _config->thumbnail_limits;
+
+	_workspace_snapshot_scale = _config->workspace_snapshot_scale;
+	_workspace_snapshot_max_bytes = _config->workspace_snapshot_max_bytes;
+	_workspace_snapshot_idle_timeout = _config->workspace_snapshot_idle_timeout;
+	_pixmap_local_allocation = _config->pixmap_local_allocation;
+	if(old->workspace_snapshot_scale != _config->workspace_snapshot_scale)
+		drop_workspace_snapshots();
+
+	while(get_workspace_count() < _config->workspace_count)
+		create_workspace();
+
+	if(not old->same_bindings(*_config))
+		update_key_bindings();
+
+	if(not old->same_theme(*_config)) {
+		_render_worker.set_config(_config);
+		_wallpaper.set_source(_config->wallpaper_file, _config->wallpaper_scale_mode);
+		try {
+			update_theme();
+		} catch(exception & e) {
+			weston_log("theme not reloaded: %s\n", e.what());
+		}
+	}
+
+	if(not old->same_keyboard(*_config))
+		weston_log("keyboard layout changes need page restart\n");
+	if(old->log_file != _config->log_file)
+		weston_log("log file changes need page restart\n");
 }
 
 void page_t::handle_bind_window(weston_keyboard * wk, uint32_t time, uint32_t key) {
@@ -709,6 +979,11 @@ void page_t::handle_set_floating_window(weston_keyboard * wk, uint32_t time, uin
 
 }
 
+void page_t::handle_dump_clients(weston_keyboard * wk, uint32_t time, uint32_t key) {
+	weston_log("call %s\n", __PRETTY_FUNCTION__);
+	dump_client_accounting();
+}
+
 void page_t::handle_alt_left_button(struct weston_pointer *pointer, uint32_t time, uint32_t button) {
 	wl_fixed_t sx, sy;
 
@@ -753,52 +1028,52 @@ void page_t::handle_alt_right_button(struct weston_pointer *pointer, uint32_t ti
 
 void page_t::handle_bind_cmd_0(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[0].cmd);
+	run_cmd(_config->bind_cmd[0].cmd);
 }
 
 void page_t::handle_bind_cmd_1(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[1].cmd);
+	run_cmd(_config->bind_cmd[1].cmd);
 }
 
 void page_t::handle_bind_cmd_2(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[2].cmd);
+	run_cmd(_config->bind_cmd[2].cmd);
 }
 
 void page_t::handle_bind_cmd_3(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[3].cmd);
+	run_cmd(_config->bind_cmd[3].cmd);
 }
 
 void page_t::handle_bind_cmd_4(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[4].cmd);
+	run_cmd(_config->bind_cmd[4].cmd);
 }
 
 void page_t::handle_bind_cmd_5(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[5].cmd);
+	run_cmd(_config->bind_cmd[5].cmd);
 }
 
 void page_t::handle_bind_cmd_6(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[6].cmd);
+	run_cmd(_config->bind_cmd[6].cmd);
 }
 
 void page_t::handle_bind_cmd_7(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[7].cmd);
+	run_cmd(_config->bind_cmd[7].cmd);
 }
 
 void page_t::handle_bind_cmd_8(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[8].cmd);
+	run_cmd(_config->bind_cmd[8].cmd);
 }
 
 void page_t::handle_bind_cmd_9(weston_keyboard * wk, uint32_t time, uint32_t key) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
-	run_cmd(bind_cmd[9].cmd);
+	run_cmd(_config->bind_cmd[9].cmd);
 }
 
 
@@ -1698,8 +1973,7 @@ void page_t::detach(shared_ptr<tree_t> t) {
 		 **/
 		if(typeid(*t.get()) == typeid(view_t)) {
 			auto x = dynamic_pointer_cast<view_t>(t);
-			for(auto w: _root->_desktop_list)
-				w->client_focus_history_remove(x);
+			x->workspace_focus_hook.unlink();
 		}
 
 		t->parent()->remove(t);
@@ -1710,6 +1984,16 @@ void page_t::detach(shared_ptr<tree_t> t) {
 	}
 }
 
+void page_t::damage_tree_views(tree_p t) {
+	auto children = t->get_all_children();
+	children.push_back(t);
+	for(auto x: children) {
+		auto v = x->get_default_view();
+		if(v and weston_view_is_mapped(v))
+			weston_view_damage_below(v);
+	}
+}
+
 void page_t::fullscreen_client_to_viewport(view_p c, viewport_p v) {
 	detach(c);
 	if (has_key(_fullscreen_client_to_viewport, c.get())) {
@@ -1797,6 +2081,8 @@ void page_t::update_windows_stack() {
  * sub-rectangle that do not overlap previous allocated area.
  **/
 void page_t::update_viewport_layout() {
+	/* layout need the theme metrics */
+	wait_startup_theme();
 
 	/* compute the extends of all outputs */
 	rect outputs_extends{numeric_limits<int>::max(), numeric_limits<int>::max(),
@@ -1834,55 +2120,107 @@ void page_t::update_viewport_layout() {
 		already_allocated += location;
 	}
 
-	/* for each desktop we update the list of viewports, without destroying
-	 * existing is not nessesary */
+	/* for each desktop, diff the existing viewports with the new allocation:
+	 * viewports with the same output and area are kept as is, viewports of
+	 * an output that has been resized or moved are resized, others are
+	 * created or removed. */
+	int kept = 0, resized = 0, added = 0, removed = 0;
 	for(auto d: _root->_desktop_list) {
-		//d->set_allocation(_root->_root_position);
-		/** get old layout to recycle old viewport, and keep unchanged outputs **/
-		vector<shared_ptr<viewport_t>> old_layout = d->get_viewport_map();
-		/** store the newer layout, to be able to cleanup obsolete viewports **/
-		vector<shared_ptr<viewport_t>> new_layout;
-		/** for each not overlaped rectangle **/
+		auto old_layout = d->get_viewport_map();
+		vector<viewport_p> new_layout;
+		vector<bool> is_reused(old_layout.size(), false);
+		bool has_change = false;
+
+		auto find_old = [&](weston_output * o, rect const * area) -> int {
+			for(unsigned i = 0; i < old_layout.size(); ++i) {
+				if(is_reused[i] or old_layout[i]->get_output() != o)
+					continue;
+				if(area == nullptr or old_layout[i]->raw_area() == *area)
+					return i;
+			}
+			return -1;
+		};
+
+		/* first pass keep unchanged viewports, so they are not stolen
+		 * by a resized area of the same output */
+		vector<int> match(viewport_allocation.size(), -1);
+		for(unsigned i = 0; i < viewport_allocation.size(); ++i) {
+			match[i] = find_old(viewport_allocation[i].first, &viewport_allocation[i].second);
+			if(match[i] >= 0)
+				is_reused[match[i]] = true;
+		}
+
 		for(unsigned i = 0; i < viewport_allocation.size(); ++i) {
-			printf("%d: found viewport (%d,%d,%d,%d)\n", d->id(),
-					viewport_allocation[i].second.x, viewport_allocation[i].second.y,
-					viewport_allocation[i].second.w, viewport_allocation[i].second.h);
-			shared_ptr<viewport_t> vp;
-			if(i < old_layout.size()) {
-				vp = old_layout[i];
-				vp->set_raw_area(viewport_allocation[i].second);
+			auto const & area = viewport_allocation[i].second;
+			viewport_p vp;
+			if(match[i] >= 0) {
+				vp = old_layout[match[i]];
+				++kept;
 			} else {
-				vp = make_shared<viewport_t>(this, viewport_allocation[i].second, viewport_allocation[i].first);
+				int k = find_old(viewport_allocation[i].first, nullptr);
+				if(k >= 0) {
+					is_reused[k] = true;
+					vp = old_layout[k];
+					vp->set_raw_area(area);
+					vp->set_allocation(area);
+					++resized;
+				} else {
+					vp = make_shared<viewport_t>(this, area, viewport_allocation[i].first);
+					++added;
+				}
+				has_change = true;
 			}
 			new_layout.push_back(vp);
 		}
 
+		for(unsigned i = 0; i < old_layout.size(); ++i) {
+			if(not is_reused[i])
+				has_change = true;
+		}
+
+		if(not has_change and new_layout == old_layout)
+			continue;
+
 		d->set_layout(new_layout);
 		d->update_default_pop();
 
-		/** clean up obsolete layout **/
-		for (unsigned i = new_layout.size(); i < old_layout.size(); ++i) {
-			/** destroy this viewport **/
+		/** clean up obsolete viewports, their clients go to the default notebook **/
+		for(unsigned i = 0; i < old_layout.size(); ++i) {
+			if(is_reused[i])
+				continue;
 			remove_viewport(d, old_layout[i]);
-			old_layout[i] = nullptr;
+			++removed;
 		}
 
-
+		/* move floating clients that are no longer on any viewport */
 		if(new_layout.size() > 0) {
-			// update position of floating managed clients to avoid offscreen
-			// floating window
-			for(auto x: filter_class<view_t>(_root->get_all_children())) {
-				if(x->is(MANAGED_FLOATING)) {
-					auto r = x->get_window_position();
-					r.x = new_layout[0]->allocation().x;
-					r.y = new_layout[0]->allocation().y;
-					x->set_floating_wished_position(r);
-					x->reconfigure();
-				}
+			for(auto x: filter_class<view_t>(d->get_all_children())) {
+				if(not x->is(MANAGED_FLOATING))
+					continue;
+				auto r = x->get_floating_wished_position();
+				bool is_visible = any_of(new_layout.begin(), new_layout.end(),
+						[&r](viewport_p const & v) {
+					return v->raw_area().has_intersection(r);
+				});
+				if(is_visible)
+					continue;
+				r.x = new_layout[0]->allocation().x;
+				r.y = new_layout[0]->allocation().y;
+				x->set_floating_wished_position(r);
+				x->reconfigure();
 			}
 		}
 	}
 
+	weston_log("viewport layout: %d kept, %d resized, %d added, %d removed\n",
+			kept, resized, added, removed);
+
+	/* removed viewports may have released their buffer before they left */
+	trim_viewport_buffers();
+
+	if(resized == 0 and added == 0 and removed == 0)
+		return;
+
 	_root->broadcast_update_layout(time64_t::now());
 	sync_tree_view();
 
@@ -1914,7 +2252,7 @@ void page_t::manage_client(surface_t * s) {
 
 	auto view = make_shared<view_t>(this, s);
 	s->_master_view = view;
-
+	_client_accounting.view_created(wl_resource_get_client(s->surface()->resource));
 
 //	if (mw->_pending.fullscreen) {
 //		/**
@@ -2001,6 +2339,7 @@ void page_t::manage_popup(surface_t * s) {
 	if(parent_view != nullptr) {
 		auto view = make_shared<view_t>(this, s);
 		s->_master_view = view;
+		_client_accounting.view_created(wl_resource_get_client(s->surface()->resource));
 		weston_log("%s x=%d, y=%d\n", __PRETTY_FUNCTION__, s->_x_offset, s->_y_offset);
 		parent_view->add_popup_child(view, s->_x_offset, s->_y_offset);
 		sync_tree_view();
@@ -2192,7 +2531,7 @@ static xkb_keycode_t find_keycode_for_keysim(xkb_keymap * keymap, xkb_keysym_t k
 }
 
 template<void (page_t::*func)(weston_keyboard *, uint32_t, uint32_t)>
-void page_t::bind_key(xkb_keymap * keymap, key_desc_t & key) {
+void page_t::bind_key(xkb_keymap * keymap, key_desc_t const & key) {
 	xkb_keysym_t ks = xkb_keysym_from_name(key.keysym_name.c_str(), XKB_KEYSYM_NO_FLAGS);
 	if(ks == XKB_KEY_NoSymbol)
 		return;
@@ -2202,44 +2541,65 @@ void page_t::bind_key(xkb_keymap * keymap, key_desc_t & key) {
 	if (kc != XKB_KEYCODE_INVALID) {
 		/* HOWTO lose time: there is a fixes offset (8) between keycode from xkbcommon and
 		 * scancode from linux and obbiously weston use scancode... ref: xkbcommon.h */
-		weston_compositor_add_key_binding(ec, kc - 8, (enum weston_keyboard_modifier)key.mod,
+		auto b = weston_compositor_add_key_binding(ec, kc - 8, (enum weston_keyboard_modifier)key.mod,
 		[](weston_keyboard * keyboard, uint32_t time, uint32_t key, void *data) {
 			auto ths = reinterpret_cast<page_t *>(data);
 			(ths->*func)(keyboard, time, key);
 		}, this);
+		if(b)
+			_key_bindings.push_back(b);
 	}
 }
 
-void page_t::on_seat_created(weston_seat * seat) {
-	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
-
-	auto xkb_ctx = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-	auto keymap = xkb_keymap_new_from_names(xkb_ctx, &ec->xkb_names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+void page_t::update_key_bindings() {
+	for(auto b: _key_bindings)
+		weston_binding_destroy(b);
+	_key_bindings.clear();
 
-	bind_key<&page_t::handle_quit_page>(keymap, bind_page_quit);
-	bind_key<&page_t::handle_toggle_fullscreen>(keymap, bind_toggle_fullscreen);
-	bind_key<&page_t::handle_close_window>(keymap, bind_close);
+	xkb_keymap * keymap = nullptr;
 
-	bind_key<&page_t::handle_goto_desktop_at_right>(keymap, bind_right_desktop);
-	bind_key<&page_t::handle_goto_desktop_at_left>(keymap, bind_left_desktop);
+	/* use the keymap compiled during startup once */
+	_startup.wait("keymap");
+	if(_startup_keymap) {
+		keymap = _startup_keymap;
+		_startup_keymap = nullptr;
+	} else {
+		auto xkb_ctx = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+		keymap = xkb_keymap_new_from_names(xkb_ctx, &ec->xkb_names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+		xkb_context_unref(xkb_ctx);
+	}
+
+	bind_key<&page_t::handle_quit_page>(keymap, _config->bind_page_quit);
+	bind_key<&page_t::handle_toggle_fullscreen>(keymap, _config->bind_toggle_fullscreen);
+	bind_key<&page_t::handle_close_window>(keymap, _config->bind_close);
+
+	bind_key<&page_t::handle_goto_desktop_at_right>(keymap, _config->bind_right_desktop);
+	bind_key<&page_t::handle_goto_desktop_at_left>(keymap, _config->bind_left_desktop);
+
+	bind_key<&page_t::handle_bind_window>(keymap, _config->bind_bind_window);
+	bind_key<&page_t::handle_set_fullscreen_window>(keymap, _config->bind_fullscreen_window);
+	bind_key<&page_t::handle_set_floating_window>(keymap, _config->bind_float_window);
+	bind_key<&page_t::handle_dump_clients>(keymap, _config->bind_dump_clients);
+
+	bind_key<&page_t::handle_bind_cmd_0>(keymap, _config->bind_cmd[0].key);
+	bind_key<&page_t::handle_bind_cmd_1>(keymap, _config->bind_cmd[1].key);
+	bind_key<&page_t::handle_bind_cmd_2>(keymap, _config->bind_cmd[2].key);
+	bind_key<&page_t::handle_bind_cmd_3>(keymap, _config->bind_cmd[3].key);
+	bind_key<&page_t::handle_bind_cmd_4>(keymap, _config->bind_cmd[4].key);
+	bind_key<&page_t::handle_bind_cmd_5>(keymap, _config->bind_cmd[5].key);
+	bind_key<&page_t::handle_bind_cmd_6>(keymap, _config->bind_cmd[6].key);
+	bind_key<&page_t::handle_bind_cmd_7>(keymap, _config->bind_cmd[7].key);
+	bind_key<&page_t::handle_bind_cmd_8>(keymap, _config->bind_cmd[8].key);
+	bind_key<&page_t::handle_bind_cmd_9>(keymap, _config->bind_cmd[9].key);
 
-	bind_key<&page_t::handle_bind_window>(keymap, bind_bind_window);
-	bind_key<&page_t::handle_set_fullscreen_window>(keymap, bind_fullscreen_window);
-	bind_key<&page_t::handle_set_floating_window>(keymap, bind_float_window);
+	xkb_keymap_unref(keymap);
+}
 
-	bind_key<&page_t::handle_bind_cmd_0>(keymap, bind_cmd[0].key);
-	bind_key<&page_t::handle_bind_cmd_1>(keymap, bind_cmd[1].key);
-	bind_key<&page_t::handle_bind_cmd_2>(keymap, bind_cmd[2].key);
-	bind_key<&page_t::handle_bind_cmd_3>(keymap, bind_cmd[3].key);
-	bind_key<&page_t::handle_bind_cmd_4>(keymap, bind_cmd[4].key);
-	bind_key<&page_t::handle_bind_cmd_5>(keymap, bind_cmd[5].key);
-	bind_key<&page_t::handle_bind_cmd_6>(keymap, bind_cmd[6].key);
-	bind_key<&page_t::handle_bind_cmd_7>(keymap, bind_cmd[7].key);
-	bind_key<&page_t::handle_bind_cmd_8>(keymap, bind_cmd[8].key);
-	bind_key<&page_t::handle_bind_cmd_9>(keymap, bind_cmd[9].key);
+void page_t::on_seat_created(weston_seat * seat) {
+	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
 
-	xkb_keymap_unref(keymap);
-	xkb_context_unref(xkb_ctx);
+	/* key bindings are global, avoid duplicate them per seat */
+	update_key_bindings();
 
 	weston_compositor_add_button_binding(ec, BTN_LEFT, MODIFIER_ALT,
 	[](struct weston_pointer *pointer, uint32_t time, uint32_t button, void *data) {
@@ -2656,10 +3016,12 @@ void page_t::run_cmd(std::string const & cmd_with_args)
         gboolean ok;
 
         e = NULL;
+        /* do not leak the blocked SIGUSR1 to the children */
         ok = g_spawn_async(NULL, argv, NULL,
                            (GSpawnFlags)(G_SPAWN_SEARCH_PATH |
                            G_SPAWN_DO_NOT_REAP_CHILD),
-                           NULL, NULL, NULL, &e);
+                           [](gpointer) { _mask_dump_signal(SIG_UNBLOCK); },
+                           NULL, NULL, &e);
         if (!ok) {
             printf("%s\n", e->message);
             g_error_free(e);
@@ -2722,6 +3084,7 @@ unsigned int page_t::find_current_desktop(shared_ptr<xdg_surface_base_t> c) {
 //}
 
 theme_t const * page_t::theme() const {
+	const_cast<page_t *>(this)->wait_startup_theme();
 	return _theme;
 }
 
@@ -2737,12 +3100,22 @@ void page_t::grab_start(weston_pointer * pointer, pointer_grab_handler_t * handl
 	assert(_grab_handler == nullptr);
 	_grab_handler = handler;
 	pointer_start_grab(pointer, handler);
+	if(handler->cursor() != CURSOR_NONE)
+		_cursors.set_cursor(pointer, handler->cursor());
 }
 
 void page_t::grab_stop(weston_pointer * pointer) {
+	bool restore_cursor = _grab_handler->cursor() != CURSOR_NONE;
 	pointer_end_grab(pointer);
 	delete _grab_handler;
 	_grab_handler = nullptr;
+
+	/* enter again the surface under the pointer to let it set its cursor */
+	if(restore_cursor) {
+		_cursors.set_cursor(pointer, CURSOR_LEFT_PTR);
+		weston_pointer_clear_focus(pointer);
+		pointer->grab->interface->focus(pointer->grab);
+	}
 }
 
 //void page_t::overlay_add(shared_ptr<tree_t> x) {
@@ -2772,6 +3145,20 @@ int page_t::create_workspace() {
 //	update_desktop_visibility();
 	return d->id();
 }
+
+auto page_t::get_workspace_switch(weston_output * output, rect const & area) -> workspace_switch_p {
+	auto x = _workspace_switchs.find(output);
+	if(x != _workspace_switchs.end()) {
+		if(x->second->area() == area)
+			return x->second;
+		/* the output changed, the strip buffer cannot be reused */
+		x->second->finish();
+	}
+
+	auto sw = make_shared<workspace_switch_t>(this, output, area);
+	_workspace_switchs[output] = sw;
+	return sw;
+}
 //
 //int page_t::left_most_border() {
 //	return _left_most_border;
@@ -2784,28 +3171,28 @@ int page_t::create_workspace() {
 //	return _keymap;
 //}
 
-list<view_w> page_t::global_client_focus_history() {
+auto page_t::global_client_focus_history() -> focus_history_t const & {
 	return _global_focus_history;
 }
 
 bool page_t::global_focus_history_front(shared_ptr<view_t> & out) {
 	if(not global_focus_history_is_empty()) {
-		out = _global_focus_history.front().lock();
+		out = _global_focus_history.front()->shared_from_this();
 		return true;
 	}
 	return false;
 }
 
 void page_t::global_focus_history_remove(shared_ptr<view_t> in) {
-	_global_focus_history.remove_if([in](weak_ptr<tree_t> const & w) { return w.expired() or w.lock() == in; });
+	_global_focus_history.remove(in->global_focus_hook);
 }
 
 void page_t::global_focus_history_move_front(shared_ptr<view_t> in) {
-	move_front(_global_focus_history, in);
+	_global_focus_history.move_front(in->global_focus_hook);
 }
 
+/* destroyed views unlink themselves */
 bool page_t::global_focus_history_is_empty() {
-	_global_focus_history.remove_if([](weak_ptr<tree_t> const & w) { return w.expired(); });
 	return _global_focus_history.empty();
 }
 
@@ -2998,6 +3385,30 @@ void page_t::load_drm_backend(weston_compositor* ec) {
 
 }
 
+void page_t::load_headless_backend(weston_compositor* ec) {
+	weston_headless_backend_config config = {{ 0, }};
+	struct weston_windowed_output_api const * api;
+
+	config.base.struct_size = sizeof(weston_headless_backend_config);
+	config.base.struct_version = WESTON_HEADLESS_BACKEND_CONFIG_VERSION;
+
+	config.use_pixman = use_pixman?1:0;
+
+	auto backend_init = reinterpret_cast<backend_init_func>(
+			weston_load_module("headless-backend.so", "backend_init"));
+	if (!backend_init)
+		return;
+
+	backend_init(ec, &config.base);
+
+    output_created.connect(&ec->output_created_signal, this, &page_t::on_output_created);
+    output_pending.connect(&ec->output_pending_signal, this, &page_t::on_output_pending);
+
+	api = weston_windowed_output_get_api(ec);
+	api->output_create(ec, "headless");
+
+}
+
 void page_t::connect_all() {
 
 	wl_list_init(&destroy.link);
@@ -3016,8 +3427,33 @@ void page_t::connect_all() {
 
 	seat_created.connect(&ec->seat_created_signal, this, &page_t::on_seat_created);
 
-	wl_list_init(&output_destroyed.link);
-	wl_list_init(&output_moved.link);
+	_client_accounting.start(ec);
+	connect(_client_accounting.on_client_destroy, this, &page_t::on_client_destroyed);
+
+	_thumbnails.start(ec);
+
+	/* decorations are rasterized out of the main loop */
+	_render_worker.set_config(_config);
+	_render_worker.start(wl_display_get_event_loop(_dpy), &page_t::create_theme);
+
+	/* the wallpaper is decoded and scaled out of the main loop */
+	_wallpaper.set_source(_config->wallpaper_file, _config->wallpaper_scale_mode);
+	_wallpaper.start(wl_display_get_event_loop(_dpy));
+	connect(_wallpaper.on_ready, this, &page_t::on_wallpaper_ready);
+
+	connect(_config_watcher.on_reload, this, &page_t::apply_config);
+	_config_watcher.start(wl_display_get_event_loop(_dpy), _config_files);
+
+	/* workspace snapshots are only useful while the user is switching */
+	_on_compositor_idle.connect(&ec->idle_signal, [this](weston_compositor * c) {
+		drop_workspace_snapshots();
+	});
+	_workspace_snapshot_timer = wl_event_loop_add_timer(
+			wl_display_get_event_loop(_dpy), [](void * data) -> int {
+		reinterpret_cast<page_t*>(data)->drop_workspace_snapshots();
+		return 0;
+	}, this);
+
 
 	wl_list_init(&session.link);
 
@@ -3032,9 +3468,6 @@ void page_t::connect_all() {
     hide_input_panel.notify = [](wl_listener *l, void *data) { weston_log("compositor::hide_input_panel\n"); };
     update_input_panel.notify = [](wl_listener *l, void *data) { weston_log("compositor::update_input_panel\n"); };
 
-    output_destroyed.notify = [](wl_listener *l, void *data) { weston_log("compositor::output_destroyed\n"); };
-    output_moved.notify = [](wl_listener *l, void *data) { weston_log("compositor::output_moved\n"); };
-	output_resized.notify =  [](wl_listener *l, void *data) { weston_log("compositor::output_resized\n"); };
 
     session.notify = [](wl_listener *l, void *data) { weston_log("compositor::session\n"); };
 
@@ -3049,9 +3482,9 @@ void page_t::connect_all() {
     wl_signal_add(&ec->hide_input_panel_signal, &hide_input_panel);
     wl_signal_add(&ec->update_input_panel_signal, &update_input_panel);
 
-    wl_signal_add(&ec->output_destroyed_signal, &output_destroyed);
-    wl_signal_add(&ec->output_moved_signal, &output_moved);
-    wl_signal_add(&ec->output_resized_signal, &output_resized);
+    output_destroyed.connect(&ec->output_destroyed_signal, this, &page_t::on_output_destroyed);
+    output_moved.connect(&ec->output_moved_signal, this, &page_t::on_output_changed);
+    output_resized.connect(&ec->output_resized_signal, this, &page_t::on_output_changed);
 
     wl_signal_add(&ec->session_signal, &session);
 }
@@ -3060,18 +3493,72 @@ void page_t::on_output_created(weston_output * output) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 	_outputs.push_back(output);
 	update_viewport_layout();
+
+	/* measure time to first frame on the first output */
+	if(not _has_first_frame and _outputs.size() == 1) {
+		_on_first_frame.connect(&output->frame_signal, [this](weston_output * o) {
+			weston_log("startup: first frame at %ld ms\n",
+					static_cast<long>(static_cast<int64_t>(_startup.elapsed()) / 1000000L));
+			_has_first_frame = true;
+			_on_first_frame.disconnect();
+			_startup.finish();
+		});
+	}
+}
+
+void page_t::on_output_destroyed(weston_output * output) {
+	weston_log("call %s\n", __PRETTY_FUNCTION__);
+	_outputs.remove(output);
+
+	/* the switch listen the output frames and own a strip of its size */
+	auto x = _workspace_switchs.find(output);
+	if(x != _workspace_switchs.end()) {
+		x->second->finish();
+		_workspace_switchs.erase(x);
+	}
+
+	update_viewport_layout();
+}
+
+void page_t::on_output_changed(weston_output * output) {
+	weston_log("call %s\n", __PRETTY_FUNCTION__);
+	update_viewport_layout();
+}
+
+/**
+ * Scale from config, or from the EDID physical size when set to "auto":
+ * outputs above 192 dpi are scaled by 2.
+ **/
+int page_t::compute_output_scale(weston_output * output) {
+	auto spec = _config->output_scale_for(output->name?output->name:"");
+
+	if(spec != "auto") {
+		long scale = strtol(spec.c_str(), nullptr, 10);
+		return scale < 1 ? 1 : static_cast<int>(scale);
+	}
+
+	if(output->current_mode == nullptr or output->mm_width <= 0)
+		return 1;
+
+	double dpi = output->current_mode->width * 25.4 / output->mm_width;
+	int scale = dpi >= 192.0 ? 2 : 1;
+	weston_log("output %s: %.0f dpi, scale %d\n", output->name, dpi, scale);
+	return scale;
 }
 
 void page_t::on_output_pending(weston_output * output) {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 
-	if (use_x11_backend) {
-		weston_output_set_scale(output, 1);
+	if (use_x11_backend or use_headless_backend) {
+		weston_output_set_scale(output, compute_output_scale(output));
 		weston_output_set_transform(output, WL_OUTPUT_TRANSFORM_NORMAL);
 
 		const struct weston_windowed_output_api *api =
 				weston_windowed_output_get_api(ec);
-		api->output_set_size(output, 1600, 1600);
+		if (use_headless_backend)
+			api->output_set_size(output, 1920, 1080);
+		else
+			api->output_set_size(output, 1600, 1600);
 
 		weston_output_enable(output);
 	} else {
@@ -3089,7 +3576,8 @@ void page_t::on_output_pending(weston_output * output) {
 			return;
 		}
 
-		weston_output_set_scale(output, 1);
+		/* after set_mode, auto scale need the current mode */
+		weston_output_set_scale(output, compute_output_scale(output));
 		weston_output_set_transform(output, WL_OUTPUT_TRANSFORM_NORMAL);
 
 		api->set_gbm_format(output, NULL);
@@ -3100,6 +3588,14 @@ void page_t::on_output_pending(weston_output * output) {
 
 }
 
+/* true if the view is entirely inside area */
+static bool view_is_inside(weston_view * v, rect const & area) {
+	weston_view_update_transform(v);
+	auto e = pixman_region32_extents(&v->transform.boundingbox);
+	return e->x1 >= area.x and e->y1 >= area.y
+			and e->x2 <= area.x + area.w and e->y2 <= area.y + area.h;
+}
+
 /**
  * This function synchronize the page tree with the weston scene graph. The side
  * effects are damage all outputs and schedule repaint for all outputs.
@@ -3110,45 +3606,202 @@ void page_t::sync_tree_view() {
 	list<weston_view *> views;
 	auto children = _root->get_all_children();
 	weston_log("found %lu children\n", children.size());
+
+	/* views of hidden workspaces are not shown */
+	set<tree_t *> hidden;
+	for(auto d: _root->_desktop_list) {
+		if(d == get_current_workspace())
+			continue;
+		for(auto x: d->get_all_children())
+			hidden.insert(x.get());
+	}
+
+	/**
+	 * A visible fullscreen client hide everything stacked below it on its
+	 * viewport, those views are left out of the layer, thus weston do not
+	 * composite them and the viewport stop drawing its decorations.
+	 **/
+	map<tree_t *, viewport_p> covering;
+	for(auto & x: _fullscreen_client_to_viewport) {
+		auto c = x.second.client.lock();
+		auto vp = x.second.viewport.lock();
+		if(c == nullptr or vp == nullptr or hidden.count(c.get()))
+			continue;
+		if(c->get_default_view() == nullptr)
+			continue;
+		covering[c.get()] = vp;
+	}
+
+	set<viewport_t *> covered;
+	for(auto & x: covering)
+		covered.insert(x.second.get());
+	for(auto & vp: get_current_workspace()->get_viewports())
+		vp->set_covered(covered.count(vp.get()));
+
 	for(auto x: children) {
+		if(hidden.count(x.get()))
+			continue;
 		auto v = x->get_default_view();
+
+		auto cover = covering.find(x.get());
+		if(cover != covering.end()) {
+			/* everything pushed before is below the fullscreen client */
+			auto area = cover->second->raw_area();
+			views.remove_if([area](weston_view * v) -> bool {
+				return view_is_inside(v, area);
+			});
+			views.push_back(cover->second->get_backdrop_view());
+		}
+
 		if(v)
 			views.push_back(v);
+		/* scaled proxies are stacked right over their client */
+		auto c = dynamic_cast<view_t *>(x.get());
+		if(v and c and c->get_proxy_view())
+			views.push_back(c->get_proxy_view());
 	}
 
 	//_root->print_tree(0);
 
 	weston_log("found %lu views\n", views.size());
 
-	/* remove all existing views */
+	set<weston_view *> new_views{views.begin(), views.end()};
+
+	/* remove all existing views, damage the ones that will not come back */
+	vector<weston_view *> old_order;
+	set<weston_view *> old_views;
 	weston_layer_entry * nxt;
 	weston_layer_entry * cur;
 	wl_list_for_each_safe(cur, nxt, &default_layer.view_list.link, link) {
 		weston_view * v = wl_container_of(cur, v, layer_link);
+		if(new_views.count(v)) {
+			old_order.push_back(v);
+			old_views.insert(v);
+		} else {
+			weston_view_damage_below(v);
+		}
 		weston_layer_entry_remove(&v->layer_link);
 	}
 
 	for(auto v: views) {
 		weston_layer_entry_insert(&default_layer.view_list, &v->layer_link);
-		weston_view_geometry_dirty(v);
-		weston_view_update_transform(v);
+		if(not old_views.count(v)) {
+			weston_view_geometry_dirty(v);
+			weston_view_update_transform(v);
+		}
 	}
 
+	vector<weston_view *> new_order;
 	wl_list_for_each_safe(cur, nxt, &default_layer.view_list.link, link) {
 		weston_view * v = wl_container_of(cur, v, layer_link);
+		if(old_views.count(v))
+			new_order.push_back(v);
 		weston_log("view=%p,output=%p,role='%s',surface=%p,x=%f,y=%f\n", v, v->output, weston_surface_get_role(v->surface), v->surface, v->geometry.x, v->geometry.y);
 	}
 
+	/* views that stay in place do not need to be repainted */
+	if(old_order != new_order) {
+		for(auto v: new_order) {
+			weston_view_geometry_dirty(v);
+			weston_view_update_transform(v);
+		}
+	}
+
 	schedule_repaint();
 
 }
 
-auto page_t::create_pixmap(uint32_t width, uint32_t height) -> pixmap_p {
-	auto p = make_shared<pixmap_t>(this, PIXMAP_RGBA, width, height);
-	pixmap_list.push_back(p);
+auto page_t::create_pixmap(uint32_t width, uint32_t height, pixmap_format_e format, unsigned scale) -> pixmap_p {
+	auto p = make_shared<pixmap_t>(this, format, width, height, scale);
+	/* local pixmaps are released with their last reference */
+	if(not p->is_local())
+		pixmap_list.push_back(p);
+	_client_accounting.pixmap_created(static_cast<int64_t>(width) * height * 4);
 	return p;
 }
 
+auto page_t::thumbnails() -> thumbnail_cache_t * {
+	return &_thumbnails;
+}
+
+auto page_t::render_worker() -> render_worker_t * {
+	return &_render_worker;
+}
+
+auto page_t::wallpaper() -> wallpaper_t * {
+	return &_wallpaper;
+}
+
+void page_t::set_theme_background(cairo_surface_t * image, int x, int y) {
+	wait_startup_theme();
+	_theme->set_background(image, x, y);
+}
+
+/* viewports drawn without wallpaper, redraw them */
+void page_t::on_wallpaper_ready() {
+	if(_root == nullptr)
+		return;
+	for(auto & w: _root->_desktop_list) {
+		for(auto & v: w->get_viewports())
+			v->queue_redraw();
+	}
+}
+
+/**
+ * Released buffers are kept and given to the next viewport of the same
+ * size, e.g. when switching workspace.
+ **/
+auto page_t::acquire_viewport_buffer(unsigned width, unsigned height, unsigned scale) -> viewport_buffer_p {
+	for(auto & b: _viewport_buffers) {
+		if(not b->is_used() and b->width() == width and b->height() == height
+				and b->scale() == scale) {
+			b->acquire();
+			return b;
+		}
+	}
+
+	auto b = make_shared<viewport_buffer_t>(this, width, height, scale);
+	b->acquire();
+	_viewport_buffers.push_back(b);
+	weston_log("viewport buffers: %lu allocated\n", _viewport_buffers.size());
+	return b;
+}
+
+void page_t::release_viewport_buffer(viewport_buffer_p b) {
+	b->release();
+	trim_viewport_buffers();
+}
+
+/**
+ * Free unused buffers that no viewport of any workspace can use anymore,
+ * e.g. after a dock, effective area or output change. Loopback pixmaps
+ * cannot be released to the buffer manager, those are kept.
+ **/
+void page_t::trim_viewport_buffers() {
+	if(_root == nullptr)
+		return;
+
+	auto is_wanted = [this](viewport_buffer_p const & b) -> bool {
+		for(auto & w: _root->_desktop_list) {
+			for(auto & v: w->get_viewports()) {
+				if(v->wants_buffer(b->width(), b->height(), b->scale()))
+					return true;
+			}
+		}
+		return false;
+	};
+
+	auto size = _viewport_buffers.size();
+	_viewport_buffers.erase(remove_if(_viewport_buffers.begin(), _viewport_buffers.end(),
+			[&is_wanted](viewport_buffer_p const & b) -> bool {
+		return not b->is_used() and b->pixmap()->is_local() and not is_wanted(b);
+	}), _viewport_buffers.end());
+
+	if(size != _viewport_buffers.size())
+		weston_log("viewport buffers: %lu freed, %lu allocated\n",
+				size - _viewport_buffers.size(), _viewport_buffers.size());
+}
+
 /**
  * Called when the cursor enter in the output region or when a refocus maybe
  * needed.
@@ -3166,8 +3819,14 @@ void page_t::process_focus(weston_pointer_grab * grab) {
 					   pointer->x, pointer->y,
 					   &sx, &sy);
 
-	if (pointer->focus != view || pointer->sx != sx || pointer->sy != sy)
+	if (pointer->focus != view || pointer->sx != sx || pointer->sy != sy) {
+		/* our own surfaces never set a cursor */
+		if (pointer->focus != view and (view == nullptr
+				or view->surface->resource == nullptr
+				or wl_resource_get_client(view->surface->resource) == _internal_client))
+			_cursors.set_cursor(pointer, CURSOR_LEFT_PTR);
 		weston_pointer_set_focus(pointer, view, sx, sy);
+	}
 }
 
 void page_t::process_motion(weston_pointer_grab * grab, uint32_t time, weston_pointer_motion_event *event) {
@@ -3198,15 +3857,74 @@ void page_t::process_cancel(weston_pointer_grab * grab) {
 }
 
 void page_t::xdg_shell_v5_client_destroy(xdg_shell_client_t * c) {
-	//_clients.remove_if([c] (xdg_shell_client_t const & x) -> bool { return x.client == c; });
+	_client_accounting.shell_released(c->client);
+	_xdg_shell_v5_clients.remove(c);
 }
 
 void page_t::xdg_shell_v6_client_destroy(xdg_shell_v6_client_t * c) {
-	//_clients.remove_if([c] (xdg_shell_client_t const & x) -> bool { return x.client == c; });
+	_client_accounting.shell_released(c->client);
+	_xdg_shell_v6_clients.remove(c);
 }
 
 void page_t::wl_shell_client_destroy(wl_shell_client_t * c) {
-	//_clients.remove_if([c] (xdg_shell_client_t const & x) -> bool { return x.client == c; });
+	_client_accounting.shell_released(c->_client);
+	_wl_shell_clients.remove(c);
+}
+
+/**
+ * Called before the client resources are destroyed, shell objects are
+ * deleted without destroy signal in that case, thus forget them now.
+ **/
+void page_t::on_client_destroyed(wl_client * client) {
+	_xdg_shell_v5_clients.remove_if([client](xdg_shell_client_t * x) -> bool { return x->client == client; });
+	_xdg_shell_v6_clients.remove_if([client](xdg_shell_v6_client_t * x) -> bool { return x->client == client; });
+	_wl_shell_clients.remove_if([client](wl_shell_client_t * x) -> bool { return x->_client == client; });
+}
+
+/**
+ * Write the tree and the clients usage to _dump_file, without pointers,
+ * pids nor timings, thus dumps of two builds can be diffed. The file is
+ * replaced at once, readers never see a partial dump.
+ **/
+void page_t::write_dump() {
+	if(_dump_file.empty() or _root == nullptr)
+		return;
+
+	auto tmp = _dump_file + ".tmp";
+	FILE * f = fopen(tmp.c_str(), "w");
+	if(f == nullptr) {
+		weston_log("cannot write dump %s: %m\n", tmp.c_str());
+		return;
+	}
+
+	fprintf(f, "tree\n");
+	_root->dump_tree(f, 1);
+	fprintf(f, "clients\n");
+	_client_accounting.write_summary(f);
+
+	if(fclose(f) == 0 and rename(tmp.c_str(), _dump_file.c_str()) == 0)
+		weston_log("dump written to %s\n", _dump_file.c_str());
+	else
+		weston_log("cannot write dump %s: %m\n", _dump_file.c_str());
+}
+
+void page_t::dump_client_accounting() {
+	_client_accounting.dump();
+
+	for(auto c: _xdg_shell_v6_clients) {
+		weston_log("xdg_shell_v6 client %p: %lu xdg_surface, %lu xdg_positioner\n",
+				c->client, c->xdg_surface_map.size(), c->xdg_positioner_v6_map.size());
+	}
+
+	for(auto c: _xdg_shell_v5_clients) {
+		weston_log("xdg_shell_v5 client %p: %lu toplevel, %lu popup\n",
+				c->client, c->xdg_surface_toplevel_map.size(), c->xdg_surface_popup_map.size());
+	}
+
+	weston_log("wl_shell clients: %lu\n", _wl_shell_clients.size());
+
+	notebook_t::dump_title_stats();
+
 }
 
 void page_t::client_create_popup(xdg_shell_client_t * c, xdg_surface_popup_t * s) {
@@ -56,6 +56,15 @@
 #include "xdg-shell-v5-surface-toplevel.hxx"
 
 #include "xdg-shell-v6-shell.hxx"
+#include "client_accounting.hxx"
+#include "thumbnail_cache.hxx"
+#include "page_config.hxx"
+#include "config_watcher.hxx"
+#include "startup.hxx"
+#include "render_worker.hxx"
+#include "wallpaper.hxx"
+#include "cursor.hxx"
+#include "protocol_recorder.hxx"
 
 namespace page {
 
@@ -87,17 +96,33 @@ enum process_mode_e {
 	PROCESS_ALT_TAB						// when alt-tab running
 };
 
-struct key_bind_cmd_t {
-	key_desc_t key;
-	string cmd;
-};
-
 struct page_t : public page_context_t, public connectable_t {
+	/* first member, its creation is the startup time origin */
+	startup_t _startup;
+	/* compiled during startup, consumed by the first key binding */
+	xkb_keymap * _startup_keymap;
+	listener_t<weston_output> _on_first_frame;
+	bool _has_first_frame;
+
 	shared_ptr<page_root_t> _root;
 	weston_layer default_layer;
 	theme_t * _theme;
+	/* built during startup, see wait_startup_theme() */
+	theme_t * _startup_theme;
 	page_configuration_t configuration;
-	config_handler_t _conf;
+
+	/* configuration files, from lower priority to higher one */
+	vector<string> _config_files;
+	page_config_p _config;
+	config_watcher_t _config_watcher;
+
+	/* protocol record for page-replay, see --record */
+	string _record_file;
+	protocol_recorder_t _recorder;
+	/* SIGUSR1 dump the tree and statistics, e.g. at the end of a replay */
+	wl_event_source * _dump_signal_source;
+	/* $XDG_RUNTIME_DIR/<socket name>.dump */
+	string _dump_file;
 
 	pointer_grab_handler_t * _grab_handler;
 
@@ -114,10 +139,8 @@ struct page_t : public page_context_t, public connectable_t {
 	 **/
 	map<view_t *, fullscreen_data_t> _fullscreen_client_to_viewport;
 
-	string page_base_dir;
-	string _theme_engine;
-
 	bool use_x11_backend;
+	bool use_headless_backend;
 	bool use_pixman;
 	bool repaint_scheduled;
 
@@ -139,14 +162,44 @@ struct page_t : public page_context_t, public connectable_t {
 	listener_t<weston_seat> seat_created;
 	listener_t<weston_output> output_created;
 	listener_t<weston_output> output_pending;
-	wl_listener output_destroyed;
-	wl_listener output_moved;
-	wl_listener output_resized;
+	listener_t<weston_output> output_destroyed;
+	listener_t<weston_output> output_moved;
+	listener_t<weston_output> output_resized;
 
 	wl_listener session;
 
 	wl_resource * _buffer_manager_resource;
+	/* pixmaps allocated by the loopback client, they are never released */
 	list<pixmap_p> pixmap_list;
+	/* loopback requests waiting for ack_buffer, by serial */
+	map<uint32_t, pixmap_t *> _pending_pixmaps;
+	/* the loopback client, also owner of local pixmaps buffers */
+	wl_client * _internal_client;
+	bool _pixmap_local_allocation;
+
+	/* per wl_client memory and resources usage */
+	client_accounting_t _client_accounting;
+
+	/* downscaled client images for exposay and alt-tab */
+	thumbnail_cache_t _thumbnails;
+	render_worker_t _render_worker;
+	wallpaper_t _wallpaper;
+	/* cursor shapes preloaded by the buffer manager */
+	cursor_manager_t _cursors;
+
+	/* back buffers of visible viewports, reused when hidden */
+	vector<viewport_buffer_p> _viewport_buffers;
+
+	/* workspace snapshots, most recently used first */
+	double _workspace_snapshot_scale;
+	size_t _workspace_snapshot_max_bytes;
+	int32_t _workspace_snapshot_idle_timeout;
+	list<workspace_w> _workspace_snapshot_lru;
+	wl_event_source * _workspace_snapshot_timer;
+	listener_t<weston_compositor> _on_compositor_idle;
+
+	/* one reusable switch animation per output */
+	map<weston_output *, workspace_switch_p> _workspace_switchs;
 
 	view_w _current_focus;
 
@@ -170,26 +223,15 @@ struct page_t : public page_context_t, public connectable_t {
 	struct wl_global * _global_xdg_shell_v6;
 	struct wl_global * _global_buffer_manager;
 
-	key_desc_t bind_page_quit;
-	key_desc_t bind_toggle_fullscreen;
-	key_desc_t bind_toggle_compositor;
-	key_desc_t bind_close;
-
-	key_desc_t bind_right_desktop;
-	key_desc_t bind_left_desktop;
-
-	key_desc_t bind_bind_window;
-	key_desc_t bind_fullscreen_window;
-	key_desc_t bind_float_window;
-
-	array<key_bind_cmd_t, 10> bind_cmd;
+	/* current key bindings, replaced when the configuration change */
+	vector<weston_binding *> _key_bindings;
 
 	//xcb_timestamp_t _last_focus_time;
 	//xcb_timestamp_t _last_button_press;
 
 	/** store all client in mapping order, older first **/
 	list<view_w> _net_client_list;
-	list<view_w> _global_focus_history;
+	focus_history_t _global_focus_history;
 
 //	int _left_most_border;
 //	int _top_most_border;
@@ -208,6 +250,10 @@ struct page_t : public page_context_t, public connectable_t {
 	void xdg_shell_v5_client_destroy(xdg_shell_client_t *);
 	void xdg_shell_v6_client_destroy(xdg_shell_v6_client_t *);
 	void wl_shell_client_destroy(wl_shell_client_t *);
+	void on_client_destroyed(wl_client * client);
+	void on_wallpaper_ready();
+	void dump_client_accounting();
+	void write_dump();
 	void client_create_popup(xdg_shell_client_t *, xdg_surface_popup_t *);
 	void client_create_toplevel(xdg_shell_client_t *, xdg_surface_toplevel_t *);
 
@@ -220,9 +266,13 @@ struct page_t : public page_context_t, public connectable_t {
 	void handle_close_window(weston_keyboard * wk, uint32_t time, uint32_t key);
 	void handle_goto_desktop_at_right(weston_keyboard * wk, uint32_t time, uint32_t key);
 	void handle_goto_desktop_at_left(weston_keyboard * wk, uint32_t time, uint32_t key);
+	void switch_to_workspace(weston_seat * seat, unsigned id, workspace_switch_direction_e direction);
+	void update_workspace_snapshot_lru(workspace_p w);
+	void drop_workspace_snapshots();
 	void handle_bind_window(weston_keyboard * wk, uint32_t time, uint32_t key);
 	void handle_set_fullscreen_window(weston_keyboard * wk, uint32_t time, uint32_t key);
 	void handle_set_floating_window(weston_keyboard * wk, uint32_t time, uint32_t key);
+	void handle_dump_clients(weston_keyboard * wk, uint32_t time, uint32_t key);
 
 	void handle_alt_left_button(struct weston_pointer *pointer, uint32_t time, uint32_t button);
 	void handle_alt_right_button(struct weston_pointer *pointer, uint32_t time, uint32_t button);
@@ -376,8 +426,14 @@ struct page_t : public page_context_t, public connectable_t {
 //	void update_keymap();
 
 	template<void (page_t::*func)(weston_keyboard *, uint32_t, uint32_t)>
-	void bind_key(xkb_keymap * keymap, key_desc_t & key);
+	void bind_key(xkb_keymap * keymap, key_desc_t const & key);
 	void bind_all_keys(weston_seat * seat);
+	void update_key_bindings();
+
+	void apply_config(page_config_p config);
+	static auto create_theme(page_config_t const & config) -> theme_t *;
+	void wait_startup_theme();
+	void update_theme();
 
 	void on_seat_created(weston_seat * seat);
 
@@ -429,9 +485,15 @@ struct page_t : public page_context_t, public connectable_t {
 
 	void connect_all();
 	void on_output_created(weston_output * output);
+	void on_output_destroyed(weston_output * output);
+	void on_output_changed(weston_output * output);
 	void on_output_pending(weston_output * output);
+	int compute_output_scale(weston_output * output);
+	/* damage the screen area of t and its children views */
+	void damage_tree_views(tree_p t);
 	void load_x11_backend(weston_compositor* ec);
 	void load_drm_backend(weston_compositor* ec);
+	void load_headless_backend(weston_compositor* ec);
 	static void bind_wl_shell(wl_client * client, void * data,
 					      uint32_t version, uint32_t id);
 	static void bind_xdg_shell_v5(wl_client * client, void * data,
@@ -440,6 +502,7 @@ struct page_t : public page_context_t, public connectable_t {
 					      uint32_t version, uint32_t id);
 	static void bind_zzz_buffer_manager(struct wl_client * client, void * data,
 		      uint32_t version, uint32_t id);
+	static int dump_signal(int signal_number, void * data);
 	static void print_tree_binding(struct weston_keyboard *keyboard, uint32_t time,
 			  uint32_t key, void *data);
 
@@ -465,6 +528,7 @@ struct page_t : public page_context_t, public connectable_t {
 	virtual auto get_workspace(int id) const -> workspace_p const &;
 	virtual int  get_workspace_count() const;
 	virtual int  create_workspace();
+	virtual auto get_workspace_switch(weston_output * output, rect const & area) -> workspace_switch_p;
 	virtual void grab_start(weston_pointer * pointer, pointer_grab_handler_t * handler);
 	virtual void grab_stop(weston_pointer * pointer);
 	virtual void detach(tree_p t);
@@ -479,7 +543,7 @@ struct page_t : public page_context_t, public connectable_t {
 	virtual void notebook_close(notebook_p nbk);
 //	virtual int  left_most_border();
 //	virtual int  top_most_border();
-	virtual auto global_client_focus_history() -> list<view_w>;
+	virtual auto global_client_focus_history() -> focus_history_t const &;
 //	virtual auto net_client_list() -> list<shared_ptr<xdg_surface_toplevel_t>>;
 //	virtual auto keymap() const -> keymap_t const *;
 //	virtual auto create_view(xcb_window_t w) -> shared_ptr<client_view_t>;
@@ -487,7 +551,14 @@ struct page_t : public page_context_t, public connectable_t {
 //	virtual auto mainloop() -> mainloop_t *;
 	virtual void sync_tree_view();
 	virtual void manage_client(surface_t * s);
-	virtual auto create_pixmap(uint32_t width, uint32_t height) -> pixmap_p;
+	virtual auto create_pixmap(uint32_t width, uint32_t height, pixmap_format_e format = PIXMAP_RGBA, unsigned scale = 1) -> pixmap_p;
+	virtual auto thumbnails() -> thumbnail_cache_t *;
+	virtual auto render_worker() -> render_worker_t *;
+	virtual auto wallpaper() -> wallpaper_t *;
+	virtual void set_theme_background(cairo_surface_t * image, int x, int y);
+	virtual auto acquire_viewport_buffer(unsigned width, unsigned height, unsigned scale) -> viewport_buffer_p;
+	virtual void release_viewport_buffer(viewport_buffer_p b);
+	void trim_viewport_buffers();
 	virtual void manage_popup(surface_t * s);
 	virtual void configure_popup(surface_t * s);
 	virtual void schedule_repaint();
@@ -0,0 +1,248 @@
+/*
+ * page_config.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "page_config.hxx"
+
+#include <algorithm>
+
+#include "exception.hxx"
+
+namespace page {
+
+using namespace std;
+
+static color_t get_color(config_handler_t const & conf, char const * group, char const * key) {
+	try {
+		return color_t{conf.get_string(group, key)};
+	} catch(std::runtime_error & e) {
+		throw exception_t("bad color %s:%s", group, key);
+	}
+}
+
+static void load_simple_theme(config_handler_t const & conf, simple_theme_config_t & t) {
+	char const * g = "simple_theme";
+
+	t.theme_dir = conf.get_string("default", "theme_dir");
+
+	t.default_background_color = get_color(conf, g, "default_background_color");
+
+	t.popup_text_color = get_color(conf, g, "popup_text_color");
+	t.popup_outline_color = get_color(conf, g, "popup_outline_color");
+	t.popup_background_color = get_color(conf, g, "popup_background_color");
+
+	t.grip_color = get_color(conf, g, "grip_color");
+
+	t.notebook_mouse_over_background_color = get_color(conf, g, "notebook_mouse_over_background_color");
+
+	t.notebook_active_text_color = get_color(conf, g, "notebook_active_text_color");
+	t.notebook_active_outline_color = get_color(conf, g, "notebook_active_outline_color");
+	t.notebook_active_border_color = get_color(conf, g, "notebook_active_border_color");
+	t.notebook_active_background_color = get_color(conf, g, "notebook_active_background_color");
+
+	t.notebook_selected_text_color = get_color(conf, g, "notebook_selected_text_color");
+	t.notebook_selected_outline_color = get_color(conf, g, "notebook_selected_outline_color");
+	t.notebook_selected_border_color = get_color(conf, g, "notebook_selected_border_color");
+	t.notebook_selected_background_color = get_color(conf, g, "notebook_selected_background_color");
+
+	t.notebook_attention_text_color = get_color(conf, g, "notebook_attention_text_color");
+	t.notebook_attention_outline_color = get_color(conf, g, "notebook_attention_outline_color");
+	t.notebook_attention_border_color = get_color(conf, g, "notebook_attention_border_color");
+	t.notebook_attention_background_color = get_color(conf, g, "notebook_attention_background_color");
+
+	t.notebook_normal_text_color = get_color(conf, g, "notebook_normal_text_color");
+	t.notebook_normal_outline_color = get_color(conf, g, "notebook_normal_outline_color");
+	t.notebook_normal_border_color = get_color(conf, g, "notebook_normal_border_color");
+	t.notebook_normal_background_color = get_color(conf, g, "notebook_normal_background_color");
+
+	t.floating_active_text_color = get_color(conf, g, "floating_active_text_color");
+	t.floating_active_outline_color = get_color(conf, g, "floating_active_outline_color");
+	t.floating_active_border_color = get_color(conf, g, "floating_active_border_color");
+	t.floating_active_background_color = get_color(conf, g, "floating_active_background_color");
+
+	t.floating_attention_text_color = get_color(conf, g, "floating_attention_text_color");
+	t.floating_attention_outline_color = get_color(conf, g, "floating_attention_outline_color");
+	t.floating_attention_border_color = get_color(conf, g, "floating_attention_border_color");
+	t.floating_attention_background_color = get_color(conf, g, "floating_attention_background_color");
+
+	t.floating_normal_text_color = get_color(conf, g, "floating_normal_text_color");
+	t.floating_normal_outline_color = get_color(conf, g, "floating_normal_outline_color");
+	t.floating_normal_border_color = get_color(conf, g, "floating_normal_border_color");
+	t.floating_normal_background_color = get_color(conf, g, "floating_normal_background_color");
+
+	t.notebook_margin_top = conf.get_long(g, "notebook_margin_top");
+	t.notebook_margin_bottom = conf.get_long(g, "notebook_margin_bottom");
+	t.notebook_margin_left = conf.get_long(g, "notebook_margin_left");
+	t.notebook_margin_right = conf.get_long(g, "notebook_margin_right");
+
+	t.notebook_active_font = conf.get_string(g, "notebook_active_font");
+	t.notebook_selected_font = conf.get_string(g, "notebook_selected_font");
+	t.notebook_attention_font = conf.get_string(g, "notebook_attention_font");
+	t.notebook_normal_font = conf.get_string(g, "notebook_normal_font");
+
+	t.floating_active_font = conf.get_string(g, "floating_active_font");
+	t.floating_attention_font = conf.get_string(g, "floating_attention_font");
+	t.floating_normal_font = conf.get_string(g, "floating_normal_font");
+
+	t.pango_popup_font = conf.get_string(g, "pango_popup_font");
+}
+
+page_config_t::page_config_t() :
+	auto_refocus{false},
+	enable_shade_windows{false},
+	mouse_focus{false},
+	menu_drop_down_shadow{false},
+	fade_in_time{0},
+	coalesce_grab_motion{true},
+	workspace_count{4},
+	workspace_snapshot_scale{0.5},
+	workspace_snapshot_max_bytes{64L * 1024L * 1024L},
+	workspace_snapshot_idle_timeout{30},
+	pixmap_local_allocation{true},
+	output_scale{"1"},
+	scaled_client_proxy{false},
+	wallpaper_scale_mode{"center"}
+{
+
+}
+
+auto page_config_t::load(vector<string> const & files) -> page_config_p {
+	auto c = shared_ptr<page_config_t>{new page_config_t};
+	auto & conf = c->raw;
+
+	for(auto & f: files)
+		conf.merge_from_file_if_exist(f);
+
+	c->log_file = conf.get_string("default", "log_file");
+	c->theme_dir = conf.get_string("default", "theme_dir");
+	c->theme_engine = conf.get_string("default", "theme_engine");
+	load_simple_theme(conf, c->simple_theme);
+
+	c->xkb_rules = conf.get_string("default", "xkb_rules");
+	c->xkb_model = conf.get_string("default", "xkb_model");
+	c->xkb_layout = conf.get_string("default", "xkb_layout");
+	c->xkb_variant = conf.get_string("default", "xkb_variant");
+	c->xkb_options = conf.get_string("default", "xkb_options");
+
+	c->auto_refocus = (conf.get_string("default", "auto_refocus") == "true");
+	c->enable_shade_windows = (conf.get_string("default", "enable_shade_windows") == "true");
+	c->mouse_focus = (conf.get_string("default", "mouse_focus") == "true");
+	c->menu_drop_down_shadow = (conf.get_string("default", "menu_drop_down_shadow") == "true");
+	c->fade_in_time = conf.get_long("compositor", "fade_in_time");
+	if(conf.has_key("compositor", "coalesce_grab_motion"))
+		c->coalesce_grab_motion = (conf.get_string("compositor", "coalesce_grab_motion") == "true");
+
+	c->bind_page_quit           = conf.get_string("default", "bind_page_quit");
+	c->bind_close               = conf.get_string("default", "bind_close");
+	c->bind_toggle_fullscreen   = conf.get_string("default", "bind_toggle_fullscreen");
+	c->bind_toggle_compositor   = conf.get_string("default", "bind_toggle_compositor");
+	c->bind_right_desktop       = conf.get_string("default", "bind_right_desktop");
+	c->bind_left_desktop        = conf.get_string("default", "bind_left_desktop");
+
+	c->bind_bind_window         = conf.get_string("default", "bind_bind_window");
+	c->bind_fullscreen_window   = conf.get_string("default", "bind_fullscreen_window");
+	c->bind_float_window        = conf.get_string("default", "bind_float_window");
+
+	if(conf.has_key("default", "bind_dump_clients"))
+		c->bind_dump_clients = conf.get_string("default", "bind_dump_clients");
+
+	for(int i = 0; i < 10; ++i) {
+		string bind_key = "bind_cmd_" + to_string(i);
+		string exec_key = "exec_cmd_" + to_string(i);
+		c->bind_cmd[i].key = conf.get_string("default", bind_key.c_str());
+		c->bind_cmd[i].cmd = conf.get_string("default", exec_key.c_str());
+	}
+
+	/* per client soft limits, 0 or missing means unlimited */
+	if(conf.has_key("limits", "client_max_surfaces"))
+		c->client_limits.max_surfaces = conf.get_long("limits", "client_max_surfaces");
+	if(conf.has_key("limits", "client_max_buffer_mb"))
+		c->client_limits.max_buffer_bytes = conf.get_long("limits", "client_max_buffer_mb") * 1024L * 1024L;
+	if(conf.has_key("limits", "client_disconnect_over_limits"))
+		c->client_limits.disconnect = (conf.get_string("limits", "client_disconnect_over_limits") == "true");
+
+	if(conf.has_key("compositor", "thumbnail_max_size"))
+		c->thumbnail_limits.max_size = max(16L, conf.get_long("compositor", "thumbnail_max_size"));
+	if(conf.has_key("compositor", "thumbnail_max_entries"))
+		c->thumbnail_limits.max_entries = conf.get_long("compositor", "thumbnail_max_entries");
+	if(conf.has_key("compositor", "thumbnail_min_interval"))
+		c->thumbnail_limits.min_interval = time64_t(conf.get_long("compositor", "thumbnail_min_interval") / 1000.0);
+
+	if(conf.has_key("default", "workspace_count"))
+		c->workspace_count = max(1L, conf.get_long("default", "workspace_count"));
+
+	/* workspace snapshots used by switch animation */
+	if(conf.has_key("compositor", "workspace_snapshot_scale"))
+		c->workspace_snapshot_scale = conf.get_double("compositor", "workspace_snapshot_scale");
+	c->workspace_snapshot_scale = min(1.0, max(0.05, c->workspace_snapshot_scale));
+	if(conf.has_key("compositor", "workspace_snapshot_max_mb"))
+		c->workspace_snapshot_max_bytes = conf.get_long("compositor", "workspace_snapshot_max_mb") * 1024L * 1024L;
+	if(conf.has_key("compositor", "workspace_snapshot_idle_timeout"))
+		c->workspace_snapshot_idle_timeout = conf.get_long("compositor", "workspace_snapshot_idle_timeout");
+
+	if(conf.has_key("compositor", "pixmap_local_allocation"))
+		c->pixmap_local_allocation = (conf.get_string("compositor", "pixmap_local_allocation") == "true");
+
+	if(conf.has_key("compositor", "output_scale"))
+		c->output_scale = conf.get_string("compositor", "output_scale");
+
+	if(conf.has_key("compositor", "scaled_client_proxy"))
+		c->scaled_client_proxy = (conf.get_string("compositor", "scaled_client_proxy") == "true");
+
+	/* the wallpaper keys belong to the theme group */
+	if(conf.has_key("simple_theme", "background_png"))
+		c->wallpaper_file = conf.get_string("simple_theme", "background_png");
+	if(conf.has_key("simple_theme", "scale_mode"))
+		c->wallpaper_scale_mode = conf.get_string("simple_theme", "scale_mode");
+
+	return c;
+}
+
+bool page_config_t::same_bindings(page_config_t const & x) const {
+	if(not (bind_page_quit == x.bind_page_quit
+			and bind_toggle_fullscreen == x.bind_toggle_fullscreen
+			and bind_toggle_compositor == x.bind_toggle_compositor
+			and bind_close == x.bind_close
+			and bind_right_desktop == x.bind_right_desktop
+			and bind_left_desktop == x.bind_left_desktop
+			and bind_bind_window == x.bind_bind_window
+			and bind_fullscreen_window == x.bind_fullscreen_window
+			and bind_float_window == x.bind_float_window
+			and bind_dump_clients == x.bind_dump_clients))
+		return false;
+
+	/* commands are read at key press, only keys need rebind */
+	for(int i = 0; i < 10; ++i) {
+		if(not (bind_cmd[i].key == x.bind_cmd[i].key))
+			return false;
+	}
+
+	return true;
+}
+
+bool page_config_t::same_theme(page_config_t const & x) const {
+	return theme_engine == x.theme_engine
+			and theme_dir == x.theme_dir
+			and raw.same_group(x.raw, "simple_theme");
+}
+
+auto page_config_t::output_scale_for(string const & output_name) const -> string {
+	if(raw.has_key("output_scale", output_name.c_str()))
+		return raw.get_string("output_scale", output_name.c_str());
+	return output_scale;
+}
+
+bool page_config_t::same_keyboard(page_config_t const & x) const {
+	return xkb_rules == x.xkb_rules
+			and xkb_model == x.xkb_model
+			and xkb_layout == x.xkb_layout
+			and xkb_variant == x.xkb_variant
+			and xkb_options == x.xkb_options;
+}
+
+}
@@ -0,0 +1,188 @@
+/*
+ * page_config.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Typed snapshot of the configuration files. The files are parsed once per
+ * load and the snapshot is never modified after, thus it can be shared
+ * between the main loop and the config watcher thread.
+ *
+ */
+
+#ifndef SRC_PAGE_CONFIG_HXX_
+#define SRC_PAGE_CONFIG_HXX_
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <array>
+
+#include "config_handler.hxx"
+#include "color.hxx"
+#include "key_desc.hxx"
+#include "client_accounting.hxx"
+#include "thumbnail_cache.hxx"
+
+namespace page {
+
+using namespace std;
+
+struct key_bind_cmd_t {
+	key_desc_t key;
+	string cmd;
+};
+
+/* [simple_theme] group, colors are parsed once per load, not per theme */
+struct simple_theme_config_t {
+	string theme_dir;
+
+	color_t default_background_color;
+
+	color_t popup_text_color;
+	color_t popup_outline_color;
+	color_t popup_background_color;
+
+	color_t grip_color;
+
+	color_t notebook_mouse_over_background_color;
+
+	color_t notebook_active_text_color;
+	color_t notebook_active_outline_color;
+	color_t notebook_active_border_color;
+	color_t notebook_active_background_color;
+
+	color_t notebook_selected_text_color;
+	color_t notebook_selected_outline_color;
+	color_t notebook_selected_border_color;
+	color_t notebook_selected_background_color;
+
+	color_t notebook_attention_text_color;
+	color_t notebook_attention_outline_color;
+	color_t notebook_attention_border_color;
+	color_t notebook_attention_background_color;
+
+	color_t notebook_normal_text_color;
+	color_t notebook_normal_outline_color;
+	color_t notebook_normal_border_color;
+	color_t notebook_normal_background_color;
+
+	color_t floating_active_text_color;
+	color_t floating_active_outline_color;
+	color_t floating_active_border_color;
+	color_t floating_active_background_color;
+
+	color_t floating_attention_text_color;
+	color_t floating_attention_outline_color;
+	color_t floating_attention_border_color;
+	color_t floating_attention_background_color;
+
+	color_t floating_normal_text_color;
+	color_t floating_normal_outline_color;
+	color_t floating_normal_border_color;
+	color_t floating_normal_background_color;
+
+	int notebook_margin_top;
+	int notebook_margin_bottom;
+	int notebook_margin_left;
+	int notebook_margin_right;
+
+	/* pango font descriptions */
+	string notebook_active_font;
+	string notebook_selected_font;
+	string notebook_attention_font;
+	string notebook_normal_font;
+
+	string floating_active_font;
+	string floating_attention_font;
+	string floating_normal_font;
+
+	string pango_popup_font;
+};
+
+struct page_config_t;
+using page_config_p = shared_ptr<page_config_t const>;
+
+struct page_config_t {
+	/* kept for groups with free keys, like [output_scale] */
+	config_handler_t raw;
+
+	string log_file;
+	string theme_dir;
+	string theme_engine;
+	simple_theme_config_t simple_theme;
+
+	string xkb_rules;
+	string xkb_model;
+	string xkb_layout;
+	string xkb_variant;
+	string xkb_options;
+
+	bool auto_refocus;
+	bool enable_shade_windows;
+	bool mouse_focus;
+	bool menu_drop_down_shadow;
+	int64_t fade_in_time;
+	/* apply grab motion once per frame instead of once per event */
+	bool coalesce_grab_motion;
+
+	key_desc_t bind_page_quit;
+	key_desc_t bind_toggle_fullscreen;
+	key_desc_t bind_toggle_compositor;
+	key_desc_t bind_close;
+
+	key_desc_t bind_right_desktop;
+	key_desc_t bind_left_desktop;
+
+	key_desc_t bind_bind_window;
+	key_desc_t bind_fullscreen_window;
+	key_desc_t bind_float_window;
+
+	key_desc_t bind_dump_clients;
+
+	array<key_bind_cmd_t, 10> bind_cmd;
+
+	client_limits_t client_limits;
+	thumbnail_limits_t thumbnail_limits;
+
+	long workspace_count;
+	double workspace_snapshot_scale;
+	size_t workspace_snapshot_max_bytes;
+	int32_t workspace_snapshot_idle_timeout;
+
+	/* create pixmaps in process instead of using the loopback client */
+	bool pixmap_local_allocation;
+
+	/* default output scale, an integer or "auto" to guess it from EDID */
+	string output_scale;
+
+	/* show a downscaled copy of clients larger than their notebook */
+	bool scaled_client_proxy;
+
+	/* PNG or JPEG file, empty for none, and center, stretch, zoom, scale or tile */
+	string wallpaper_file;
+	string wallpaper_scale_mode;
+
+	/**
+	 * Merge files in order, later files override previous ones, missing
+	 * files are ignored. Throw exception_t if a mandatory key is missing
+	 * or a key binding is invalid.
+	 **/
+	static auto load(vector<string> const & files) -> page_config_p;
+
+	bool same_bindings(page_config_t const & x) const;
+	bool same_theme(page_config_t const & x) const;
+	bool same_keyboard(page_config_t const & x) const;
+
+	/* scale of an output, [output_scale] <name> override the default */
+	auto output_scale_for(string const & output_name) const -> string;
+
+private:
+	page_config_t();
+
+};
+
+}
+
+#endif /* SRC_PAGE_CONFIG_HXX_ */
@@ -25,6 +25,10 @@ using namespace std;
 
 class theme_t;
 class mainloop_t;
+class thumbnail_cache_t;
+class viewport_buffer_t;
+class render_worker_t;
+class wallpaper_t;
 
 enum edge_e {
 	EDGE_NONE = 0,
@@ -45,6 +49,8 @@ struct page_configuration_t {
 	bool _mouse_focus;
 	bool _enable_shade_windows;
 	int64_t _fade_in_time;
+	bool _coalesce_grab_motion;
+	bool _scaled_client_proxy;
 };
 
 /**
@@ -74,6 +80,7 @@ public:
 	virtual auto get_workspace(int id) const -> workspace_p const & = 0;
 	virtual int  get_workspace_count() const = 0;
 	virtual int  create_workspace() = 0;
+	virtual auto get_workspace_switch(weston_output * output, rect const & area) -> workspace_switch_p = 0;
 	virtual void grab_start(weston_pointer * pointer, pointer_grab_handler_t * handler) = 0;
 	virtual void grab_stop(weston_pointer * pointer) = 0;
 	virtual void detach(tree_p t) = 0;
@@ -88,7 +95,7 @@ public:
 	virtual void notebook_close(notebook_p nbk) = 0;
 //	virtual int  left_most_border() = 0;
 //	virtual int  top_most_border() = 0;
-	virtual auto global_client_focus_history() -> list<view_w> = 0;
+	virtual auto global_client_focus_history() -> focus_history_t const & = 0;
 //	virtual auto net_client_list() -> list<shared_ptr<xdg_surface_toplevel_t>> = 0;
 //	virtual auto keymap() const -> keymap_t const * = 0;
 //	virtual void switch_to_desktop(unsigned int desktop) = 0;
@@ -97,7 +104,14 @@ public:
 //	virtual auto mainloop() -> mainloop_t * = 0;
 	virtual void sync_tree_view() = 0;
 	virtual void manage_client(surface_t * s) = 0;
-	virtual auto create_pixmap(uint32_t width, uint32_t height) -> pixmap_p = 0;
+	virtual auto create_pixmap(uint32_t width, uint32_t height, pixmap_format_e format = PIXMAP_RGBA, unsigned scale = 1) -> pixmap_p = 0;
+	virtual auto thumbnails() -> thumbnail_cache_t * = 0;
+	virtual auto render_worker() -> render_worker_t * = 0;
+	virtual auto wallpaper() -> wallpaper_t * = 0;
+	/* wallpaper used by the main loop theme, see theme_t::set_background */
+	virtual void set_theme_background(cairo_surface_t * image, int x, int y) = 0;
+	virtual auto acquire_viewport_buffer(unsigned width, unsigned height, unsigned scale) -> shared_ptr<viewport_buffer_t> = 0;
+	virtual void release_viewport_buffer(shared_ptr<viewport_buffer_t> b) = 0;
 	virtual void bind_window(view_p mw) = 0;
 	virtual void manage_popup(surface_t * s) = 0;
 	virtual void configure_popup(surface_t * s) = 0;
@@ -0,0 +1,142 @@
+/*
+ * page_dispatch_bench.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Microbenchmark of the request dispatch generated by wayland-cxx-scanner.
+ * zxdg_positioner_v6.set_size is called through the implementation table
+ * of the *_vtable path (virtual call) and of the *_dispatch<T> path
+ * (direct call), then the object lookup get() of both is timed, i.e.
+ * dynamic_cast against static_cast. libwayland is not linked: the two
+ * wl_resource functions used by the generated code are stubbed below and
+ * the same fake resource is used for every call.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include "xdg-shell-unstable-v6-interface.hxx"
+#include "time.hxx"
+
+/* volatile, the compiler must not see through set_implementation */
+static void const * volatile stub_implementation;
+static void * volatile stub_data;
+
+extern "C" {
+
+void wl_resource_set_implementation(struct wl_resource * resource,
+		void const * implementation, void * data,
+		wl_resource_destroy_func_t destroy) {
+	stub_implementation = implementation;
+	stub_data = data;
+}
+
+void * wl_resource_get_user_data(struct wl_resource * resource) {
+	return stub_data;
+}
+
+}
+
+namespace page {
+
+using namespace wcxx;
+
+/* like connectable_t, put the dispatch base at a non zero offset */
+struct bench_base_t {
+	virtual ~bench_base_t() = default;
+	int64_t pad;
+};
+
+struct bench_vtable_t : public bench_base_t, public zxdg_positioner_v6_vtable {
+	int64_t sum = 0;
+
+	static auto get(struct wl_resource * r) -> bench_vtable_t * {
+		return dynamic_cast<bench_vtable_t *>(reinterpret_cast<zxdg_positioner_v6_vtable *>(wl_resource_get_user_data(r)));
+	}
+
+	virtual void zxdg_positioner_v6_destroy(struct wl_client * client, struct wl_resource * resource) override { }
+	virtual void zxdg_positioner_v6_set_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height) override { sum += width + height; }
+	virtual void zxdg_positioner_v6_set_anchor_rect(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y, int32_t width, int32_t height) override { }
+	virtual void zxdg_positioner_v6_set_anchor(struct wl_client * client, struct wl_resource * resource, uint32_t anchor) override { }
+	virtual void zxdg_positioner_v6_set_gravity(struct wl_client * client, struct wl_resource * resource, uint32_t gravity) override { }
+	virtual void zxdg_positioner_v6_set_constraint_adjustment(struct wl_client * client, struct wl_resource * resource, uint32_t constraint_adjustment) override { }
+	virtual void zxdg_positioner_v6_set_offset(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y) override { }
+	virtual void zxdg_positioner_v6_delete_resource(struct wl_resource * resource) override { }
+};
+
+struct bench_dispatch_t : public bench_base_t, public zxdg_positioner_v6_dispatch<bench_dispatch_t> {
+	int64_t sum = 0;
+
+	static auto get(struct wl_resource * r) -> bench_dispatch_t * {
+		return zxdg_positioner_v6_dispatch::get(r);
+	}
+
+	void zxdg_positioner_v6_destroy(struct wl_client * client, struct wl_resource * resource) { }
+	void zxdg_positioner_v6_set_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height) { sum += width + height; }
+	void zxdg_positioner_v6_set_anchor_rect(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y, int32_t width, int32_t height) { }
+	void zxdg_positioner_v6_set_anchor(struct wl_client * client, struct wl_resource * resource, uint32_t anchor) { }
+	void zxdg_positioner_v6_set_gravity(struct wl_client * client, struct wl_resource * resource, uint32_t gravity) { }
+	void zxdg_positioner_v6_set_constraint_adjustment(struct wl_client * client, struct wl_resource * resource, uint32_t constraint_adjustment) { }
+	void zxdg_positioner_v6_set_offset(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y) { }
+	void zxdg_positioner_v6_delete_resource(struct wl_resource * resource) { }
+};
+
+/* call set_size through the table registered by set_implementation, as
+ * libwayland does on each request */
+static double bench_request(struct wl_resource * r, long count) {
+	auto impl = static_cast<zxdg_positioner_v6_interface const *>(stub_implementation);
+	auto start = time64_t::now();
+	for(long i = 0; i < count; ++i)
+		impl->set_size(nullptr, r, i & 0xff, 1);
+	return static_cast<double>(time64_t::now() - start) / count;
+}
+
+template<typename T>
+static double bench_get(struct wl_resource * r, long count, int64_t & sum) {
+	auto start = time64_t::now();
+	for(long i = 0; i < count; ++i)
+		sum += reinterpret_cast<intptr_t>(T::get(r)) & 1;
+	return static_cast<double>(time64_t::now() - start) / count;
+}
+
+}
+
+int main(int argc, char ** argv) {
+	using namespace page;
+
+	long count = 100000000L;
+	if(argc > 1)
+		count = strtol(argv[1], nullptr, 10);
+	if(count <= 0) {
+		fprintf(stderr, "usage: %s [count]\n", argv[0]);
+		return 1;
+	}
+
+	/* the resource is never dereferenced by the stubs */
+	static int64_t fake;
+	auto r = reinterpret_cast<struct wl_resource *>(&fake);
+	int64_t sum = 0;
+
+	bench_vtable_t v;
+	v.set_implementation(r);
+	double vtable_request = bench_request(r, count);
+	double vtable_get = bench_get<bench_vtable_t>(r, count, sum);
+	sum += v.sum;
+
+	bench_dispatch_t d;
+	d.set_implementation(r);
+	double dispatch_request = bench_request(r, count);
+	double dispatch_get = bench_get<bench_dispatch_t>(r, count, sum);
+	sum += d.sum;
+
+	printf("%ld calls\n", count);
+	printf("request  vtable %6.2f ns  dispatch %6.2f ns\n", vtable_request, dispatch_request);
+	printf("get()    vtable %6.2f ns  dispatch %6.2f ns\n", vtable_get, dispatch_get);
+	/* keep the handlers side effects alive */
+	fprintf(stderr, "%ld\n", static_cast<long>(sum));
+	return 0;
+}
@@ -0,0 +1,805 @@
+/*
+ * page_loadgen.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Synthetic zxdg_shell_v6 client to stress the compositor of
+ * WAYLAND_DISPLAY, usually page --headless. It maps toplevels and popups
+ * with shm buffers, then generate commits, title changes, move and resize
+ * requests and window churn at the given rates for a given duration.
+ * Roundtrip, configure and frame latencies are measured from the client
+ * side and written on stdout at the end.
+ *
+ */
+
+#include <wayland-client.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xdg-shell-unstable-v6-client-protocol.h"
+#include "time.hxx"
+#include "anonymous_file.hxx"
+
+namespace page {
+
+using namespace std;
+
+struct loadgen_config_t {
+	unsigned toplevels;
+	unsigned popups;
+	int width;
+	int height;
+	/* per second, for the whole client, 0 disable */
+	double commit_rate;
+	double title_rate;
+	double move_rate;
+	double resize_rate;
+	double churn_rate;
+	/* commit as fast as buffers are released, ignore commit_rate */
+	bool commit_storm;
+	double duration;
+};
+
+class latency_t {
+	char const * _name;
+	vector<int64_t> _samples;
+
+public:
+	latency_t(char const * name) : _name{name} { }
+
+	void add(time64_t start) {
+		_samples.push_back(static_cast<int64_t>(time64_t::now() - start) / 1000L);
+	}
+
+	void print() {
+		if(_samples.empty()) {
+			printf("%s: no sample\n", _name);
+			return;
+		}
+
+		sort(_samples.begin(), _samples.end());
+		int64_t sum = 0;
+		for(auto x: _samples)
+			sum += x;
+
+		auto at = [this](double p) -> long {
+			return _samples[min<size_t>(_samples.size() - 1, _samples.size() * p)];
+		};
+
+		printf("%s: %lu samples, avg %ld us, p50 %ld us, p99 %ld us, max %ld us\n",
+				_name, static_cast<unsigned long>(_samples.size()),
+				static_cast<long>(sum / static_cast<int64_t>(_samples.size())),
+				at(0.50), at(0.99), static_cast<long>(_samples.back()));
+	}
+
+};
+
+class loadgen_t;
+
+struct shm_buffer_t {
+	wl_buffer * buffer;
+	uint32_t * data;
+	bool busy;
+};
+
+struct window_t {
+	loadgen_t * lg;
+	unsigned id;
+	window_t * parent;
+
+	wl_surface * surface;
+	zxdg_surface_v6 * xdg_surface;
+	zxdg_toplevel_v6 * toplevel;
+	zxdg_popup_v6 * popup;
+
+	int width;
+	int height;
+	/* buffers of the current size, in a single pool */
+	void * pool_data;
+	size_t pool_size;
+	shm_buffer_t buffers[2];
+
+	bool configured;
+	bool closed;
+	time64_t created;
+
+	wl_callback * frame;
+	time64_t frame_start;
+
+	unsigned commit_count;
+	unsigned title_count;
+	list<window_t *> popups;
+	/* popups of a churned window, created again on this one */
+	unsigned popups_lost;
+};
+
+class loadgen_t {
+	loadgen_config_t _config;
+
+	wl_display * _dpy;
+	wl_registry * _registry;
+	wl_compositor * _compositor;
+	wl_shm * _shm;
+	wl_seat * _seat;
+	zxdg_shell_v6 * _shell;
+
+	list<unique_ptr<window_t>> _windows;
+	/* configured toplevels, for round robin */
+	vector<window_t *> _mapped;
+	unsigned _next_window;
+
+	time64_t _start;
+	/* actions done, compared to rate times elapsed time */
+	unsigned long _commits;
+	unsigned long _titles;
+	unsigned long _moves;
+	unsigned long _resizes;
+	unsigned long _churns;
+	unsigned long _commits_dropped;
+	unsigned long _created;
+
+	latency_t _roundtrip;
+	latency_t _configure;
+	latency_t _frame;
+	list<pair<wl_callback *, time64_t>> _syncs;
+
+	static wl_registry_listener const _registry_listener;
+	static zxdg_shell_v6_listener const _shell_listener;
+	static zxdg_surface_v6_listener const _surface_listener;
+	static zxdg_toplevel_v6_listener const _toplevel_listener;
+	static zxdg_popup_v6_listener const _popup_listener;
+	static wl_buffer_listener const _buffer_listener;
+	static wl_callback_listener const _frame_listener;
+	static wl_callback_listener const _sync_listener;
+
+	static void _global(void * data, wl_registry * registry, uint32_t name,
+			char const * interface, uint32_t version);
+	static void _global_remove(void * data, wl_registry * registry, uint32_t name);
+	static void _ping(void * data, zxdg_shell_v6 * shell, uint32_t serial);
+	static void _surface_configure(void * data, zxdg_surface_v6 * s, uint32_t serial);
+	static void _toplevel_configure(void * data, zxdg_toplevel_v6 * t,
+			int32_t width, int32_t height, wl_array * states);
+	static void _toplevel_close(void * data, zxdg_toplevel_v6 * t);
+	static void _popup_configure(void * data, zxdg_popup_v6 * p,
+			int32_t x, int32_t y, int32_t width, int32_t height);
+	static void _popup_done(void * data, zxdg_popup_v6 * p);
+	static void _buffer_release(void * data, wl_buffer * buffer);
+	static void _frame_done(void * data, wl_callback * callback, uint32_t time);
+	static void _sync_done(void * data, wl_callback * callback, uint32_t time);
+
+	auto _create_window(window_t * parent) -> window_t *;
+	void _destroy_window(window_t * w);
+	void _resize_buffers(window_t * w, int width, int height);
+	void _release_buffers(window_t * w);
+	bool _commit(window_t * w);
+	void _update_mapped();
+	auto _pick(unsigned long n) -> window_t *;
+	void _churn();
+	void _sync();
+
+	/* number of actions due at rate, given the elapsed time */
+	static unsigned long _due(double rate, double elapsed, unsigned long done) {
+		double x = rate * elapsed;
+		return x > done ? static_cast<unsigned long>(x) - done : 0;
+	}
+
+public:
+	loadgen_t(loadgen_config_t const & config);
+	~loadgen_t();
+
+	bool run();
+
+};
+
+wl_registry_listener const loadgen_t::_registry_listener = {
+	&loadgen_t::_global,
+	&loadgen_t::_global_remove
+};
+
+zxdg_shell_v6_listener const loadgen_t::_shell_listener = {
+	&loadgen_t::_ping
+};
+
+zxdg_surface_v6_listener const loadgen_t::_surface_listener = {
+	&loadgen_t::_surface_configure
+};
+
+zxdg_toplevel_v6_listener const loadgen_t::_toplevel_listener = {
+	&loadgen_t::_toplevel_configure,
+	&loadgen_t::_toplevel_close
+};
+
+zxdg_popup_v6_listener const loadgen_t::_popup_listener = {
+	&loadgen_t::_popup_configure,
+	&loadgen_t::_popup_done
+};
+
+wl_buffer_listener const loadgen_t::_buffer_listener = {
+	&loadgen_t::_buffer_release
+};
+
+wl_callback_listener const loadgen_t::_frame_listener = {
+	&loadgen_t::_frame_done
+};
+
+wl_callback_listener const loadgen_t::_sync_listener = {
+	&loadgen_t::_sync_done
+};
+
+loadgen_t::loadgen_t(loadgen_config_t const & config) :
+	_config(config),
+	_dpy{nullptr},
+	_registry{nullptr},
+	_compositor{nullptr},
+	_shm{nullptr},
+	_seat{nullptr},
+	_shell{nullptr},
+	_next_window{0},
+	_commits{0},
+	_titles{0},
+	_moves{0},
+	_resizes{0},
+	_churns{0},
+	_commits_dropped{0},
+	_created{0},
+	_roundtrip{"roundtrip"},
+	_configure{"configure"},
+	_frame{"frame"}
+{
+
+}
+
+loadgen_t::~loadgen_t() {
+	if(_dpy == nullptr)
+		return;
+
+	while(not _windows.empty()) {
+		auto w = _windows.front().get();
+		/* popups are destroyed with their parent */
+		while(w->parent)
+			w = w->parent;
+		_destroy_window(w);
+	}
+
+	for(auto & x: _syncs)
+		wl_callback_destroy(x.first);
+	if(_shell)
+		zxdg_shell_v6_destroy(_shell);
+	if(_seat)
+		wl_seat_destroy(_seat);
+	if(_shm)
+		wl_shm_destroy(_shm);
+	if(_compositor)
+		wl_compositor_destroy(_compositor);
+	if(_registry)
+		wl_registry_destroy(_registry);
+	wl_display_disconnect(_dpy);
+}
+
+void loadgen_t::_global(void * data, wl_registry * registry, uint32_t name,
+		char const * interface, uint32_t version) {
+	auto ths = reinterpret_cast<loadgen_t *>(data);
+
+	if(strcmp(interface, "wl_compositor") == 0) {
+		ths->_compositor = reinterpret_cast<wl_compositor *>(
+				wl_registry_bind(registry, name, &wl_compositor_interface, 1));
+	} else if(strcmp(interface, "wl_shm") == 0) {
+		ths->_shm = reinterpret_cast<wl_shm *>(
+				wl_registry_bind(registry, name, &wl_shm_interface, 1));
+	} else if(strcmp(interface, "wl_seat") == 0 and ths->_seat == nullptr) {
+		ths->_seat = reinterpret_cast<wl_seat *>(
+				wl_registry_bind(registry, name, &wl_seat_interface, 1));
+	} else if(strcmp(interface, "zxdg_shell_v6") == 0) {
+		ths->_shell = reinterpret_cast<zxdg_shell_v6 *>(
+				wl_registry_bind(registry, name, &zxdg_shell_v6_interface, 1));
+		zxdg_shell_v6_add_listener(ths->_shell, &_shell_listener, ths);
+	}
+}
+
+void loadgen_t::_global_remove(void * data, wl_registry * registry, uint32_t name) {
+
+}
+
+void loadgen_t::_ping(void * data, zxdg_shell_v6 * shell, uint32_t serial) {
+	zxdg_shell_v6_pong(shell, serial);
+}
+
+void loadgen_t::_surface_configure(void * data, zxdg_surface_v6 * s, uint32_t serial) {
+	auto w = reinterpret_cast<window_t *>(data);
+	zxdg_surface_v6_ack_configure(s, serial);
+
+	if(not w->configured) {
+		w->configured = true;
+		w->lg->_configure.add(w->created);
+	}
+
+	/* the configure is applied with the next commit */
+	w->lg->_commit(w);
+}
+
+void loadgen_t::_toplevel_configure(void * data, zxdg_toplevel_v6 * t,
+		int32_t width, int32_t height, wl_array * states) {
+	auto w = reinterpret_cast<window_t *>(data);
+	/* 0 let the client choose */
+	w->lg->_resize_buffers(w, width > 0 ? width : w->width, height > 0 ? height : w->height);
+}
+
+void loadgen_t::_toplevel_close(void * data, zxdg_toplevel_v6 * t) {
+	auto w = reinterpret_cast<window_t *>(data);
+	w->closed = true;
+}
+
+void loadgen_t::_popup_configure(void * data, zxdg_popup_v6 * p,
+		int32_t x, int32_t y, int32_t width, int32_t height) {
+	auto w = reinterpret_cast<window_t *>(data);
+	w->lg->_resize_buffers(w, width > 0 ? width : w->width, height > 0 ? height : w->height);
+}
+
+void loadgen_t::_popup_done(void * data, zxdg_popup_v6 * p) {
+	auto w = reinterpret_cast<window_t *>(data);
+	w->closed = true;
+}
+
+void loadgen_t::_buffer_release(void * data, wl_buffer * buffer) {
+	auto b = reinterpret_cast<shm_buffer_t *>(data);
+	b->busy = false;
+}
+
+void loadgen_t::_frame_done(void * data, wl_callback * callback, uint32_t time) {
+	auto w = reinterpret_cast<window_t *>(data);
+	wl_callback_destroy(callback);
+	w->frame = nullptr;
+	w->lg->_frame.add(w->frame_start);
+}
+
+void loadgen_t::_sync_done(void * data, wl_callback * callback, uint32_t time) {
+	auto ths = reinterpret_cast<loadgen_t *>(data);
+	for(auto i = ths->_syncs.begin(); i != ths->_syncs.end(); ++i) {
+		if(i->first == callback) {
+			ths->_roundtrip.add(i->second);
+			ths->_syncs.erase(i);
+			break;
+		}
+	}
+	wl_callback_destroy(callback);
+}
+
+void loadgen_t::_release_buffers(window_t * w) {
+	for(auto & b: w->buffers) {
+		if(b.buffer)
+			wl_buffer_destroy(b.buffer);
+		b.buffer = nullptr;
+		b.data = nullptr;
+		b.busy = false;
+	}
+
+	if(w->pool_data)
+		munmap(w->pool_data, w->pool_size);
+	w->pool_data = nullptr;
+	w->pool_size = 0;
+}
+
+void loadgen_t::_resize_buffers(window_t * w, int width, int height) {
+	if(w->pool_data and width == w->width and height == w->height)
+		return;
+
+	_release_buffers(w);
+	w->width = width;
+	w->height = height;
+
+	int stride = width * 4;
+	size_t size = static_cast<size_t>(stride) * height;
+	int fd = create_anonymous_file("page-loadgen", size * 2);
+	if(fd < 0) {
+		fprintf(stderr, "cannot create buffer: %s\n", strerror(errno));
+		return;
+	}
+
+	auto data = mmap(nullptr, size * 2, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(data == MAP_FAILED) {
+		close(fd);
+		return;
+	}
+
+	auto pool = wl_shm_create_pool(_shm, fd, size * 2);
+	for(int i = 0; i < 2; ++i) {
+		auto & b = w->buffers[i];
+		b.buffer = wl_shm_pool_create_buffer(pool, size * i, width, height,
+				stride, WL_SHM_FORMAT_XRGB8888);
+		b.data = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(data) + size * i);
+		b.busy = false;
+		wl_buffer_add_listener(b.buffer, &_buffer_listener, &b);
+	}
+	wl_shm_pool_destroy(pool);
+	close(fd);
+
+	w->pool_data = data;
+	w->pool_size = size * 2;
+}
+
+bool loadgen_t::_commit(window_t * w) {
+	if(not w->configured or w->pool_data == nullptr)
+		return false;
+
+	shm_buffer_t * b = nullptr;
+	for(auto & x: w->buffers) {
+		if(not x.busy) {
+			b = &x;
+			break;
+		}
+	}
+
+	if(b == nullptr) {
+		_commits_dropped += 1;
+		return false;
+	}
+
+	/* a moving band, to damage a small part of large windows */
+	int band = max(1, w->height / 16);
+	int y0 = (w->commit_count * band) % w->height;
+	int y1 = min(w->height, y0 + band);
+	uint32_t color = 0xff000000u | ((w->id * 0x3f2a1bu + w->commit_count * 0x010203u) & 0xffffffu);
+	fill(b->data, b->data + w->width * w->height, 0xff202020u);
+	fill(b->data + y0 * w->width, b->data + y1 * w->width, color);
+
+	wl_surface_attach(w->surface, b->buffer, 0, 0);
+	wl_surface_damage(w->surface, 0, y0, w->width, y1 - y0);
+
+	if(w->frame == nullptr) {
+		w->frame = wl_surface_frame(w->surface);
+		wl_callback_add_listener(w->frame, &_frame_listener, w);
+		w->frame_start = time64_t::now();
+	}
+
+	wl_surface_commit(w->surface);
+	b->busy = true;
+	w->commit_count += 1;
+	return true;
+}
+
+auto loadgen_t::_create_window(window_t * parent) -> window_t * {
+	auto w = new window_t;
+	memset(w->buffers, 0, sizeof w->buffers);
+	w->lg = this;
+	w->id = _next_window++;
+	w->parent = parent;
+	w->toplevel = nullptr;
+	w->popup = nullptr;
+	w->width = parent ? max(1, _config.width / 3) : _config.width;
+	w->height = parent ? max(1, _config.height / 3) : _config.height;
+	w->pool_data = nullptr;
+	w->pool_size = 0;
+	w->configured = false;
+	w->closed = false;
+	w->frame = nullptr;
+	w->commit_count = 0;
+	w->title_count = 0;
+	w->popups_lost = 0;
+
+	w->surface = wl_compositor_create_surface(_compositor);
+	w->xdg_surface = zxdg_shell_v6_get_xdg_surface(_shell, w->surface);
+	zxdg_surface_v6_add_listener(w->xdg_surface, &_surface_listener, w);
+
+	if(parent == nullptr) {
+		w->toplevel = zxdg_surface_v6_get_toplevel(w->xdg_surface);
+		zxdg_toplevel_v6_add_listener(w->toplevel, &_toplevel_listener, w);
+		char title[64];
+		snprintf(title, sizeof title, "loadgen %u", w->id);
+		zxdg_toplevel_v6_set_title(w->toplevel, title);
+		zxdg_toplevel_v6_set_app_id(w->toplevel, "page-loadgen");
+	} else {
+		auto positioner = zxdg_shell_v6_create_positioner(_shell);
+		zxdg_positioner_v6_set_size(positioner, w->width, w->height);
+		zxdg_positioner_v6_set_anchor_rect(positioner, 0, 0,
+				max(1, parent->width / 2), max(1, parent->height / 2));
+		zxdg_positioner_v6_set_anchor(positioner, ZXDG_POSITIONER_V6_ANCHOR_BOTTOM
+				| ZXDG_POSITIONER_V6_ANCHOR_RIGHT);
+		zxdg_positioner_v6_set_gravity(positioner, ZXDG_POSITIONER_V6_GRAVITY_BOTTOM
+				| ZXDG_POSITIONER_V6_GRAVITY_RIGHT);
+		w->popup = zxdg_surface_v6_get_popup(w->xdg_surface, parent->xdg_surface,
+				positioner);
+		zxdg_popup_v6_add_listener(w->popup, &_popup_listener, w);
+		zxdg_positioner_v6_destroy(positioner);
+		parent->popups.push_back(w);
+	}
+
+	/* the initial commit ask for the first configure */
+	w->created = time64_t::now();
+	wl_surface_commit(w->surface);
+
+	_windows.push_back(unique_ptr<window_t>{w});
+	_created += 1;
+	return w;
+}
+
+void loadgen_t::_destroy_window(window_t * w) {
+	/* popups must be destroyed before their parent */
+	while(not w->popups.empty())
+		_destroy_window(w->popups.back());
+
+	if(w->parent)
+		w->parent->popups.remove(w);
+
+	if(w->frame)
+		wl_callback_destroy(w->frame);
+	if(w->popup)
+		zxdg_popup_v6_destroy(w->popup);
+	if(w->toplevel)
+		zxdg_toplevel_v6_destroy(w->toplevel);
+	zxdg_surface_v6_destroy(w->xdg_surface);
+	wl_surface_destroy(w->surface);
+	_release_buffers(w);
+
+	_windows.remove_if([w](unique_ptr<window_t> const & x) { return x.get() == w; });
+}
+
+void loadgen_t::_update_mapped() {
+	_mapped.clear();
+	for(auto & x: _windows) {
+		if(x->toplevel and x->configured and not x->closed)
+			_mapped.push_back(x.get());
+	}
+}
+
+/* round robin over configured toplevels */
+auto loadgen_t::_pick(unsigned long n) -> window_t * {
+	if(_mapped.empty())
+		return nullptr;
+	return _mapped[n % _mapped.size()];
+}
+
+void loadgen_t::_churn() {
+	auto w = _pick(_churns);
+	if(w == nullptr)
+		return;
+
+	size_t popups = w->popups.size();
+	_destroy_window(w);
+	auto n = _create_window(nullptr);
+	/* popups are created again once the new parent is configured */
+	n->popups_lost = popups;
+	_update_mapped();
+}
+
+void loadgen_t::_sync() {
+	auto callback = wl_display_sync(_dpy);
+	wl_callback_add_listener(callback, &_sync_listener, this);
+	_syncs.push_back(make_pair(callback, time64_t::now()));
+}
+
+bool loadgen_t::run() {
+	_dpy = wl_display_connect(nullptr);
+	if(_dpy == nullptr) {
+		fprintf(stderr, "cannot connect to the compositor\n");
+		return false;
+	}
+
+	_registry = wl_display_get_registry(_dpy);
+	wl_registry_add_listener(_registry, &_registry_listener, this);
+	wl_display_roundtrip(_dpy);
+
+	if(_compositor == nullptr or _shm == nullptr or _shell == nullptr) {
+		fprintf(stderr, "wl_compositor, wl_shm or zxdg_shell_v6 is missing\n");
+		return false;
+	}
+
+	_start = time64_t::now();
+	for(unsigned i = 0; i < _config.toplevels; ++i)
+		_create_window(nullptr);
+	wl_display_flush(_dpy);
+
+	/* popups are spread over the toplevels once they are configured */
+	unsigned popups_todo = _config.popups;
+	time64_t last_sync = _start;
+
+	for(;;) {
+		auto now = time64_t::now();
+		double elapsed = static_cast<double>(now - _start) / 1e9;
+		if(elapsed >= _config.duration)
+			break;
+
+		/* toplevels closed by the compositor are replaced */
+		for(auto & x: _windows) {
+			if(x->closed) {
+				bool toplevel = x->toplevel != nullptr;
+				_destroy_window(x.get());
+				if(toplevel)
+					_create_window(nullptr);
+				break;
+			}
+		}
+
+		_update_mapped();
+
+		/* popups lost with churned toplevels are created again */
+		for(auto w: _mapped) {
+			popups_todo += w->popups_lost;
+			w->popups_lost = 0;
+		}
+
+		while(popups_todo > 0) {
+			auto parent = _pick(popups_todo);
+			if(parent == nullptr)
+				break;
+			_create_window(parent);
+			popups_todo -= 1;
+		}
+
+		if(_config.commit_storm) {
+			for(auto & x: _windows) {
+				if(_commit(x.get()))
+					_commits += 1;
+			}
+		} else {
+			for(auto n = _due(_config.commit_rate, elapsed, _commits); n > 0; --n) {
+				auto w = _pick(_commits);
+				if(w == nullptr)
+					break;
+				/* busy buffers are counted as dropped */
+				_commit(w);
+				_commits += 1;
+			}
+		}
+
+		for(auto n = _due(_config.title_rate, elapsed, _titles); n > 0; --n) {
+			auto w = _pick(_titles);
+			if(w == nullptr)
+				break;
+			char title[64];
+			snprintf(title, sizeof title, "loadgen %u #%u", w->id, ++w->title_count);
+			zxdg_toplevel_v6_set_title(w->toplevel, title);
+			_titles += 1;
+		}
+
+		/* without a pressed button the compositor only validate them */
+		for(auto n = _due(_config.move_rate, elapsed, _moves); n > 0; --n) {
+			auto w = _pick(_moves);
+			if(w == nullptr or _seat == nullptr)
+				break;
+			zxdg_toplevel_v6_move(w->toplevel, _seat, 0);
+			_moves += 1;
+		}
+
+		for(auto n = _due(_config.resize_rate, elapsed, _resizes); n > 0; --n) {
+			auto w = _pick(_resizes);
+			if(w == nullptr or _seat == nullptr)
+				break;
+			zxdg_toplevel_v6_resize(w->toplevel, _seat, 0,
+					ZXDG_TOPLEVEL_V6_RESIZE_EDGE_BOTTOM_RIGHT);
+			_resizes += 1;
+		}
+
+		for(auto n = _due(_config.churn_rate, elapsed, _churns); n > 0; --n) {
+			_churn();
+			_churns += 1;
+		}
+
+		/* sample the roundtrip latency every 100 ms */
+		if(static_cast<int64_t>(now - last_sync) >= 100000000L) {
+			_sync();
+			last_sync = now;
+		}
+
+		if(wl_display_flush(_dpy) < 0 and errno != EAGAIN) {
+			fprintf(stderr, "connection lost: %s\n", strerror(errno));
+			return false;
+		}
+
+		pollfd fd{wl_display_get_fd(_dpy), POLLIN, 0};
+		/* storms only wait for buffer releases */
+		if(poll(&fd, 1, _config.commit_storm ? 0 : 1) > 0) {
+			if(wl_display_dispatch(_dpy) < 0) {
+				fprintf(stderr, "connection lost: %s\n",
+						strerror(wl_display_get_error(_dpy)));
+				return false;
+			}
+		} else {
+			wl_display_dispatch_pending(_dpy);
+		}
+	}
+
+	wl_display_roundtrip(_dpy);
+
+	double elapsed = static_cast<double>(time64_t::now() - _start) / 1e9;
+	unsigned long mapped = 0;
+	for(auto & x: _windows) {
+		if(x->configured)
+			mapped += 1;
+	}
+
+	printf("duration: %.1f s, %lu windows created, %lu mapped at end\n",
+			elapsed, _created, mapped);
+	printf("commits: %lu (%.0f/s), %lu dropped on busy buffers\n",
+			_commits, _commits / elapsed, _commits_dropped);
+	printf("titles: %lu (%.0f/s)\n", _titles, _titles / elapsed);
+	printf("moves: %lu, resizes: %lu, churn: %lu\n", _moves, _resizes, _churns);
+	_roundtrip.print();
+	_configure.print();
+	_frame.print();
+	return true;
+}
+
+}
+
+static void usage(char const * name) {
+	fprintf(stderr,
+			"usage: %s [options]\n"
+			"  --toplevels N      toplevels mapped at start (50)\n"
+			"  --popups N         popups spread over the toplevels (0)\n"
+			"  --size WxH         initial toplevel size (400x300)\n"
+			"  --commits R        commits per second (60)\n"
+			"  --commit-storm     commit as soon as a buffer is released\n"
+			"  --titles R         title changes per second (0)\n"
+			"  --moves R          move requests per second (0)\n"
+			"  --resizes R        resize requests per second (0)\n"
+			"  --churn R          toplevels destroyed and created per second (0)\n"
+			"  --duration S       duration in seconds (10)\n",
+			name);
+}
+
+int main(int argc, char ** argv) {
+	page::loadgen_config_t config;
+	config.toplevels = 50;
+	config.popups = 0;
+	config.width = 400;
+	config.height = 300;
+	config.commit_rate = 60.0;
+	config.title_rate = 0.0;
+	config.move_rate = 0.0;
+	config.resize_rate = 0.0;
+	config.churn_rate = 0.0;
+	config.commit_storm = false;
+	config.duration = 10.0;
+
+	for(int k = 1; k < argc; ++k) {
+		std::string x = argv[k];
+		bool has_value = k + 1 < argc;
+		if(x == "--toplevels" and has_value) {
+			config.toplevels = strtoul(argv[++k], nullptr, 10);
+		} else if(x == "--popups" and has_value) {
+			config.popups = strtoul(argv[++k], nullptr, 10);
+		} else if(x == "--size" and has_value) {
+			if(sscanf(argv[++k], "%dx%d", &config.width, &config.height) != 2
+					or config.width <= 0 or config.height <= 0) {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if(x == "--commits" and has_value) {
+			config.commit_rate = strtod(argv[++k], nullptr);
+		} else if(x == "--commit-storm") {
+			config.commit_storm = true;
+		} else if(x == "--titles" and has_value) {
+			config.title_rate = strtod(argv[++k], nullptr);
+		} else if(x == "--moves" and has_value) {
+			config.move_rate = strtod(argv[++k], nullptr);
+		} else if(x == "--resizes" and has_value) {
+			config.resize_rate = strtod(argv[++k], nullptr);
+		} else if(x == "--churn" and has_value) {
+			config.churn_rate = strtod(argv[++k], nullptr);
+		} else if(x == "--duration" and has_value) {
+			config.duration = strtod(argv[++k], nullptr);
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	page::loadgen_t loadgen{config};
+	return loadgen.run() ? 0 : 1;
+}
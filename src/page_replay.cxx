@@ -0,0 +1,852 @@
+/*
+ * page_replay.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Replay a protocol record of page --record against the compositor of
+ * WAYLAND_DISPLAY, usually page --headless. Each recorded client get its
+ * own connection and requests are sent again in the recorded order, as fast
+ * as possible or at the recorded pace with --realtime. Objects are matched
+ * by their recorded id, globals by interface name and configure serials by
+ * their rank on the object. Buffers content is a solid color derived from
+ * the recorded hash. The replay timing is written on stdout, --dump ask the
+ * compositor to write its tree and statistics at the end, in
+ * $XDG_RUNTIME_DIR/<WAYLAND_DISPLAY>.dump, so both can be compared between
+ * builds.
+ *
+ */
+
+#include <wayland-client.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "xdg-shell-unstable-v5-client-protocol.h"
+#include "xdg-shell-unstable-v6-client-protocol.h"
+#include "time.hxx"
+#include "anonymous_file.hxx"
+
+namespace page {
+
+using namespace std;
+
+/* globals that recorded clients may bind */
+static wl_interface const * const bindable_interfaces[] = {
+	&wl_compositor_interface,
+	&wl_subcompositor_interface,
+	&wl_shm_interface,
+	&wl_seat_interface,
+	&wl_output_interface,
+	&wl_data_device_manager_interface,
+	&wl_shell_interface,
+	&xdg_shell_interface,
+	&zxdg_shell_v6_interface
+};
+
+/* position of the serial argument in configure like messages */
+struct serial_arg_t {
+	char const * interface;
+	char const * message;
+	unsigned arg;
+};
+
+static serial_arg_t const serial_events[] = {
+	{"zxdg_surface_v6", "configure", 0},
+	{"zxdg_shell_v6", "ping", 0},
+	{"xdg_surface", "configure", 3},
+	{"xdg_shell", "ping", 0},
+	{"wl_shell_surface", "ping", 0}
+};
+
+static serial_arg_t const serial_requests[] = {
+	{"zxdg_surface_v6", "ack_configure", 0},
+	{"zxdg_shell_v6", "pong", 0},
+	{"xdg_surface", "ack_configure", 0},
+	{"xdg_shell", "pong", 0},
+	{"wl_shell_surface", "pong", 0}
+};
+
+template<size_t N>
+static bool find_serial_arg(serial_arg_t const (&table)[N],
+		char const * interface, char const * message, unsigned & arg) {
+	for(auto & x: table) {
+		if(strcmp(x.interface, interface) == 0 and strcmp(x.message, message) == 0) {
+			arg = x.arg;
+			return true;
+		}
+	}
+	return false;
+}
+
+struct record_t {
+	/* usec since the start of the record */
+	long time;
+	unsigned client;
+	char type;
+	uint32_t object;
+	string interface;
+	int opcode;
+	string message;
+	vector<string> args;
+};
+
+static bool parse_record(string const & line, record_t & r) {
+	istringstream is{line};
+	r.args.clear();
+
+	if(not (is >> r.time >> r.client >> r.type))
+		return false;
+
+	if(r.type == 'D')
+		return true;
+
+	/* buffer hash keep its fields as arguments */
+	if(r.type == 'H') {
+		if(not (is >> r.object))
+			return false;
+		string x;
+		while(is >> x)
+			r.args.push_back(x);
+		return r.args.size() == 5;
+	}
+
+	if(not (is >> r.object >> r.interface >> r.opcode >> r.message))
+		return false;
+
+	string x;
+	while(is >> x)
+		r.args.push_back(x);
+	return true;
+}
+
+static string decode_string(string const & s) {
+	string ret;
+	for(size_t i = 0; i < s.size(); ++i) {
+		if(s[i] == '%' and i + 2 < s.size()) {
+			ret.push_back(static_cast<char>(strtoul(s.substr(i+1, 2).c_str(), nullptr, 16)));
+			i += 2;
+		} else {
+			ret.push_back(s[i]);
+		}
+	}
+	return ret;
+}
+
+struct replay_pool_t {
+	int fd;
+	uint8_t * data;
+	size_t size;
+	/* buffers keep the memory alive after the pool is destroyed */
+	unsigned buffers;
+	bool destroyed;
+};
+
+struct replay_buffer_t {
+	uint32_t pool;
+	int32_t offset;
+	int32_t width;
+	int32_t height;
+	int32_t stride;
+};
+
+struct replay_object_t {
+	wl_proxy * proxy;
+	wl_interface const * interface;
+};
+
+class replayer_t;
+
+struct replay_client_t {
+	replayer_t * replayer;
+	wl_display * dpy;
+	bool failed;
+
+	map<uint32_t, replay_object_t> objects;
+	/* advertised globals, name and version by interface */
+	map<string, pair<uint32_t, uint32_t>> globals;
+	map<uint32_t, replay_pool_t> pools;
+	map<uint32_t, replay_buffer_t> buffers;
+
+	/* configure and ping serials by object, in the record and received */
+	map<uint32_t, vector<uint32_t>> recorded_serials;
+	map<uint32_t, vector<uint32_t>> live_serials;
+
+	/* requests sent since the last roundtrip */
+	unsigned pending;
+};
+
+class replayer_t {
+	bool _realtime;
+	bool _dump;
+	unsigned _sync_interval;
+
+	/* used for the final roundtrip and to find the compositor pid */
+	wl_display * _control;
+	map<unsigned, unique_ptr<replay_client_t>> _clients;
+	time64_t _start;
+
+	unsigned long _requests;
+	unsigned long _skipped;
+	map<string, unsigned long> _skipped_by_message;
+	unsigned long _roundtrip_count;
+	int64_t _roundtrip_sum;
+	int64_t _roundtrip_max;
+
+	static int _dispatch(void const * data, void * target, uint32_t opcode,
+			wl_message const * message, wl_argument * args);
+
+	auto _get_client(unsigned id) -> replay_client_t *;
+	void _disconnect(unsigned id);
+	void _roundtrip(replay_client_t * c);
+	void _wait_until(time64_t t);
+	void _skip(record_t const & r, char const * reason);
+	void _track(replay_client_t * c, uint32_t id, wl_proxy * proxy,
+			wl_interface const * interface);
+	void _forget(replay_client_t * c, uint32_t id);
+	void _release_pool(replay_client_t * c, uint32_t id);
+	auto _map_serial(replay_client_t * c, uint32_t object, uint32_t recorded) -> uint32_t;
+
+	void _request_dump();
+	void _event(record_t const & r);
+	void _fill_buffer(record_t const & r);
+	void _request(record_t const & r);
+
+public:
+	replayer_t(bool realtime, bool dump, unsigned sync_interval);
+	~replayer_t();
+
+	bool run(istream & in);
+
+};
+
+replayer_t::replayer_t(bool realtime, bool dump, unsigned sync_interval) :
+	_realtime{realtime},
+	_dump{dump},
+	_sync_interval{sync_interval},
+	_control{nullptr},
+	_requests{0},
+	_skipped{0},
+	_roundtrip_count{0},
+	_roundtrip_sum{0},
+	_roundtrip_max{0}
+{
+
+}
+
+replayer_t::~replayer_t() {
+	while(not _clients.empty())
+		_disconnect(_clients.begin()->first);
+	if(_control)
+		wl_display_disconnect(_control);
+}
+
+int replayer_t::_dispatch(void const * data, void * target, uint32_t opcode,
+		wl_message const * message, wl_argument * args) {
+	auto c = reinterpret_cast<replay_client_t *>(const_cast<void *>(data));
+	auto proxy = reinterpret_cast<wl_proxy *>(target);
+	auto interface = wl_proxy_get_class(proxy);
+	auto id = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(wl_proxy_get_user_data(proxy)));
+
+	if(strcmp(interface, "wl_registry") == 0 and strcmp(message->name, "global") == 0) {
+		c->globals[args[1].s] = make_pair(args[0].u, args[2].u);
+		return 0;
+	}
+
+	if(strcmp(interface, "wl_callback") == 0) {
+		c->replayer->_forget(c, id);
+		return 0;
+	}
+
+	unsigned arg;
+	if(find_serial_arg(serial_events, interface, message->name, arg))
+		c->live_serials[id].push_back(args[arg].u);
+
+	return 0;
+}
+
+auto replayer_t::_get_client(unsigned id) -> replay_client_t * {
+	auto x = _clients.find(id);
+	if(x != _clients.end())
+		return x->second.get();
+
+	auto dpy = wl_display_connect(nullptr);
+	if(dpy == nullptr) {
+		fprintf(stderr, "cannot connect client %u: %s\n", id, strerror(errno));
+		return nullptr;
+	}
+
+	auto c = new replay_client_t;
+	c->replayer = this;
+	c->dpy = dpy;
+	c->failed = false;
+	c->pending = 0;
+	c->objects[1] = replay_object_t{reinterpret_cast<wl_proxy *>(dpy), &wl_display_interface};
+	_clients[id] = unique_ptr<replay_client_t>{c};
+	return c;
+}
+
+void replayer_t::_disconnect(unsigned id) {
+	auto x = _clients.find(id);
+	if(x == _clients.end())
+		return;
+
+	auto c = x->second.get();
+	wl_display_flush(c->dpy);
+	for(auto & p: c->pools) {
+		munmap(p.second.data, p.second.size);
+		close(p.second.fd);
+	}
+	/* proxies are released with the display */
+	wl_display_disconnect(c->dpy);
+	_clients.erase(x);
+}
+
+void replayer_t::_roundtrip(replay_client_t * c) {
+	if(c->failed)
+		return;
+
+	auto start = time64_t::now();
+	if(wl_display_roundtrip(c->dpy) < 0) {
+		fprintf(stderr, "client connection failed: %s\n", strerror(wl_display_get_error(c->dpy)));
+		c->failed = true;
+		return;
+	}
+
+	int64_t latency = static_cast<int64_t>(time64_t::now() - start) / 1000L;
+	_roundtrip_count += 1;
+	_roundtrip_sum += latency;
+	_roundtrip_max = max(_roundtrip_max, latency);
+	c->pending = 0;
+}
+
+/* read and dispatch the events of all clients while waiting */
+void replayer_t::_wait_until(time64_t t) {
+	for(;;) {
+		int64_t remain = static_cast<int64_t>(t - time64_t::now());
+		if(remain <= 0)
+			return;
+
+		vector<pollfd> fds;
+		vector<replay_client_t *> clients;
+		for(auto & x: _clients) {
+			if(x.second->failed)
+				continue;
+			wl_display_dispatch_pending(x.second->dpy);
+			wl_display_flush(x.second->dpy);
+			fds.push_back(pollfd{wl_display_get_fd(x.second->dpy), POLLIN, 0});
+			clients.push_back(x.second.get());
+		}
+
+		int ret = poll(fds.empty()?nullptr:&fds[0], fds.size(),
+				static_cast<int>((remain + 999999L) / 1000000L));
+		if(ret <= 0)
+			continue;
+
+		for(size_t i = 0; i < fds.size(); ++i) {
+			if(fds[i].revents & POLLIN) {
+				if(wl_display_dispatch(clients[i]->dpy) < 0)
+					clients[i]->failed = true;
+			}
+		}
+	}
+}
+
+void replayer_t::_skip(record_t const & r, char const * reason) {
+	_skipped += 1;
+	_skipped_by_message[r.interface + "." + r.message + " (" + reason + ")"] += 1;
+}
+
+void replayer_t::_track(replay_client_t * c, uint32_t id, wl_proxy * proxy,
+		wl_interface const * interface) {
+	c->objects[id] = replay_object_t{proxy, interface};
+	wl_proxy_add_dispatcher(proxy, &replayer_t::_dispatch, c,
+			reinterpret_cast<void *>(static_cast<uintptr_t>(id)));
+}
+
+void replayer_t::_forget(replay_client_t * c, uint32_t id) {
+	auto x = c->objects.find(id);
+	if(x == c->objects.end())
+		return;
+
+	wl_proxy_destroy(x->second.proxy);
+	c->objects.erase(x);
+	c->live_serials.erase(id);
+	c->recorded_serials.erase(id);
+
+	auto b = c->buffers.find(id);
+	if(b != c->buffers.end()) {
+		auto p = c->pools.find(b->second.pool);
+		c->buffers.erase(b);
+		if(p != c->pools.end()) {
+			p->second.buffers -= 1;
+			_release_pool(c, p->first);
+		}
+	}
+
+	auto p = c->pools.find(id);
+	if(p != c->pools.end()) {
+		p->second.destroyed = true;
+		_release_pool(c, id);
+	}
+}
+
+void replayer_t::_release_pool(replay_client_t * c, uint32_t id) {
+	auto p = c->pools.find(id);
+	if(p == c->pools.end() or not p->second.destroyed or p->second.buffers > 0)
+		return;
+	munmap(p->second.data, p->second.size);
+	close(p->second.fd);
+	c->pools.erase(p);
+}
+
+auto replayer_t::_map_serial(replay_client_t * c, uint32_t object,
+		uint32_t recorded) -> uint32_t {
+	auto & rec = c->recorded_serials[object];
+	auto x = find(rec.rbegin(), rec.rend(), recorded);
+	if(x == rec.rend())
+		return recorded;
+
+	size_t rank = rec.rend() - x - 1;
+	auto & live = c->live_serials[object];
+	/* the configure may not be received yet */
+	if(live.size() <= rank)
+		_roundtrip(c);
+	if(live.size() > rank)
+		return live[rank];
+	if(not live.empty())
+		return live.back();
+	return recorded;
+}
+
+void replayer_t::_event(record_t const & r) {
+	auto x = _clients.find(r.client);
+	if(x == _clients.end())
+		return;
+
+	unsigned arg;
+	if(not find_serial_arg(serial_events, r.interface.c_str(), r.message.c_str(), arg))
+		return;
+	if(arg >= r.args.size() or r.args[arg].compare(0, 2, "u:") != 0)
+		return;
+
+	x->second->recorded_serials[r.object].push_back(
+			strtoul(r.args[arg].c_str() + 2, nullptr, 10));
+}
+
+void replayer_t::_fill_buffer(record_t const & r) {
+	auto x = _clients.find(r.client);
+	if(x == _clients.end())
+		return;
+	auto c = x->second.get();
+
+	auto b = c->buffers.find(r.object);
+	if(b == c->buffers.end())
+		return;
+	auto p = c->pools.find(b->second.pool);
+	if(p == c->pools.end())
+		return;
+
+	auto const & buf = b->second;
+	if(buf.offset < 0 or buf.stride < buf.width * 4
+			or static_cast<size_t>(buf.offset) + static_cast<size_t>(buf.stride) * buf.height > p->second.size)
+		return;
+
+	/* opaque color from the recorded content hash */
+	uint32_t color = 0xff000000u | (strtoull(r.args[4].c_str(), nullptr, 16) & 0xffffffu);
+	for(int32_t y = 0; y < buf.height; ++y) {
+		auto row = reinterpret_cast<uint32_t *>(p->second.data + buf.offset + y * buf.stride);
+		fill(row, row + buf.width, color);
+	}
+}
+
+void replayer_t::_request(record_t const & r) {
+	auto c = _get_client(r.client);
+	if(c == nullptr or c->failed) {
+		_skip(r, "no connection");
+		return;
+	}
+
+	auto o = c->objects.find(r.object);
+	if(o == c->objects.end()) {
+		_skip(r, "unknown object");
+		return;
+	}
+
+	auto proxy = o->second.proxy;
+	auto interface = o->second.interface;
+	if(r.opcode < 0 or r.opcode >= interface->method_count
+			or r.message != interface->methods[r.opcode].name) {
+		_skip(r, "unknown message");
+		return;
+	}
+
+	auto const & message = interface->methods[r.opcode];
+	uint32_t version = wl_proxy_get_version(proxy);
+	if(version == 0)
+		version = interface->version;
+	if(static_cast<uint32_t>(atoi(message.signature)) > version) {
+		_skip(r, "version");
+		return;
+	}
+
+	bool is_bind = r.interface == "wl_registry" and r.message == "bind";
+	unsigned serial_arg;
+	bool has_serial = find_serial_arg(serial_requests, r.interface.c_str(),
+			r.message.c_str(), serial_arg);
+
+	vector<wl_argument> args;
+	deque<string> strings;
+	deque<wl_array> arrays;
+	deque<vector<uint8_t>> array_data;
+	uint32_t new_id = 0;
+	wl_interface const * new_interface = nullptr;
+	uint32_t new_version = version;
+	int fd = -1;
+	int32_t pool_size = 0;
+
+	unsigned i = 0;
+	bool nullable = false;
+	for(char const * sig = message.signature; *sig; ++sig) {
+		if(*sig == '?') {
+			nullable = true;
+			continue;
+		}
+
+		if(isdigit(*sig))
+			continue;
+
+		if(i >= r.args.size() or r.args[i].size() < 2 or r.args[i][0] != *sig) {
+			_skip(r, "bad arguments");
+			if(fd >= 0)
+				close(fd);
+			return;
+		}
+
+		string value = r.args[i].substr(2);
+		wl_argument a;
+		memset(&a, 0, sizeof a);
+
+		switch(*sig) {
+		case 'i':
+			a.i = strtol(value.c_str(), nullptr, 10);
+			break;
+		case 'u':
+			a.u = strtoul(value.c_str(), nullptr, 10);
+			if(has_serial and i == serial_arg)
+				a.u = _map_serial(c, r.object, a.u);
+			break;
+		case 'f':
+			a.f = strtol(value.c_str(), nullptr, 10);
+			break;
+		case 's':
+			if(value == "~") {
+				a.s = nullptr;
+			} else {
+				strings.push_back(decode_string(value));
+				a.s = strings.back().c_str();
+			}
+			break;
+		case 'o': {
+			uint32_t id = strtoul(value.c_str(), nullptr, 10);
+			auto x = c->objects.find(id);
+			if(id != 0 and x != c->objects.end()) {
+				a.o = reinterpret_cast<wl_object *>(x->second.proxy);
+			} else if(not nullable or id != 0) {
+				_skip(r, "unknown argument object");
+				if(fd >= 0)
+					close(fd);
+				return;
+			}
+			break;
+		}
+		case 'n':
+			new_id = strtoul(value.c_str(), nullptr, 10);
+			new_interface = message.types[i];
+			a.o = nullptr;
+			break;
+		case 'a': {
+			array_data.push_back(vector<uint8_t>{});
+			for(size_t k = 0; k + 1 < value.size(); k += 2)
+				array_data.back().push_back(strtoul(value.substr(k, 2).c_str(), nullptr, 16));
+			arrays.push_back(wl_array{});
+			arrays.back().size = array_data.back().size();
+			arrays.back().alloc = array_data.back().size();
+			arrays.back().data = array_data.back().empty()?nullptr:&array_data.back()[0];
+			a.a = &arrays.back();
+			break;
+		}
+		case 'h':
+			/* only shm pools are replayed, with new memory */
+			if(r.interface != "wl_shm" or r.message != "create_pool" or r.args.size() < 3) {
+				_skip(r, "file descriptor");
+				return;
+			}
+			pool_size = strtol(r.args[2].c_str() + 2, nullptr, 10);
+			fd = create_anonymous_file("page-replay", pool_size);
+			if(fd < 0) {
+				_skip(r, "cannot create pool");
+				return;
+			}
+			a.h = fd;
+			break;
+		}
+
+		args.push_back(a);
+		nullable = false;
+		++i;
+	}
+
+	if(is_bind) {
+		/* bind the global with the same interface in this session */
+		auto g = c->globals.find(strings.empty()?string{}:strings.front());
+		wl_interface const * bound = nullptr;
+		for(auto x: bindable_interfaces) {
+			if(g != c->globals.end() and g->first == x->name)
+				bound = x;
+		}
+
+		if(bound == nullptr) {
+			_skip(r, "unknown global");
+			return;
+		}
+
+		args[0].u = g->second.first;
+		args[1].s = bound->name;
+		new_version = min<uint32_t>(min<uint32_t>(args[2].u, g->second.second), bound->version);
+		args[2].u = new_version;
+		new_interface = bound;
+	}
+
+	if(r.interface == "wl_shm_pool" and r.message == "resize") {
+		auto p = c->pools.find(r.object);
+		if(p != c->pools.end() and static_cast<size_t>(args[0].i) > p->second.size) {
+			/* a pool the compositor cannot map would kill the session */
+			if(ftruncate(p->second.fd, args[0].i) < 0) {
+				_skip(r, "cannot grow pool");
+				return;
+			}
+			auto data = mremap(p->second.data, p->second.size, args[0].i, MREMAP_MAYMOVE);
+			if(data != MAP_FAILED) {
+				p->second.data = reinterpret_cast<uint8_t *>(data);
+				p->second.size = args[0].i;
+			}
+		}
+	}
+
+	if(new_interface) {
+		auto np = wl_proxy_marshal_array_constructor_versioned(proxy, r.opcode,
+				&args[0], new_interface, new_version);
+		if(np == nullptr) {
+			_skip(r, "marshal");
+			if(fd >= 0)
+				close(fd);
+			return;
+		}
+		_track(c, new_id, np, new_interface);
+	} else if(new_id == 0) {
+		wl_proxy_marshal_array(proxy, r.opcode, args.empty()?nullptr:&args[0]);
+	} else {
+		_skip(r, "untyped new id");
+		return;
+	}
+
+	_requests += 1;
+	c->pending += 1;
+
+	if(fd >= 0) {
+		auto data = mmap(nullptr, pool_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if(data == MAP_FAILED) {
+			close(fd);
+		} else {
+			c->pools[new_id] = replay_pool_t{fd, reinterpret_cast<uint8_t *>(data),
+				static_cast<size_t>(pool_size), 0, false};
+		}
+	}
+
+	if(r.interface == "wl_shm_pool" and r.message == "create_buffer") {
+		auto p = c->pools.find(r.object);
+		if(p != c->pools.end()) {
+			p->second.buffers += 1;
+			c->buffers[new_id] = replay_buffer_t{r.object, args[1].i, args[2].i,
+				args[3].i, args[4].i};
+		}
+	}
+
+	/* destructors are not tagged in wl_message, rely on names */
+	if(r.message == "destroy" or r.message == "release")
+		_forget(c, r.object);
+
+	/* the registry content is needed by the following binds */
+	if(r.message == "get_registry" or c->pending >= _sync_interval)
+		_roundtrip(c);
+}
+
+bool replayer_t::run(istream & in) {
+	_control = wl_display_connect(nullptr);
+	if(_control == nullptr) {
+		fprintf(stderr, "cannot connect to the compositor\n");
+		return false;
+	}
+
+	unsigned long line_count = 0;
+	_start = time64_t::now();
+
+	string line;
+	record_t r;
+	while(getline(in, line)) {
+		line_count += 1;
+		if(line.empty() or line[0] == '#')
+			continue;
+
+		if(not parse_record(line, r)) {
+			fprintf(stderr, "line %lu: cannot parse record\n", line_count);
+			continue;
+		}
+
+		if(_realtime)
+			_wait_until(_start + time64_t{static_cast<int64_t>(r.time) * 1000L});
+
+		switch(r.type) {
+		case 'R':
+			_request(r);
+			break;
+		case 'E':
+			_event(r);
+			break;
+		case 'H':
+			_fill_buffer(r);
+			break;
+		case 'D':
+			_disconnect(r.client);
+			break;
+		}
+	}
+
+	for(auto & x: _clients)
+		_roundtrip(x.second.get());
+	wl_display_roundtrip(_control);
+
+	int64_t elapsed = static_cast<int64_t>(time64_t::now() - _start) / 1000L;
+
+	printf("replay: %lu requests in %ld ms (%.0f requests/s), %lu skipped\n",
+			_requests, static_cast<long>(elapsed / 1000L),
+			elapsed > 0 ? _requests * 1000000.0 / elapsed : 0.0, _skipped);
+	printf("roundtrip: %lu samples, avg %ld us, max %ld us\n", _roundtrip_count,
+			static_cast<long>(_roundtrip_count ? _roundtrip_sum / static_cast<int64_t>(_roundtrip_count) : 0L),
+			static_cast<long>(_roundtrip_max));
+	for(auto & x: _skipped_by_message)
+		printf("skipped %s: %lu\n", x.first.c_str(), x.second);
+
+	if(_dump)
+		_request_dump();
+
+	return true;
+}
+
+/* path of the compositor dump, see page_t::write_dump() */
+static string dump_path() {
+	char const * dir = getenv("XDG_RUNTIME_DIR");
+	char const * name = getenv("WAYLAND_DISPLAY");
+	if(name == nullptr)
+		name = "wayland-0";
+	if(name[0] == '/')
+		return string{name} + ".dump";
+	if(dir == nullptr)
+		return string{};
+	return string{dir} + "/" + name + ".dump";
+}
+
+/* ask the compositor to write its dump and wait until it is replaced */
+void replayer_t::_request_dump() {
+	auto path = dump_path();
+	ucred cred;
+	socklen_t len = sizeof cred;
+	if(path.empty() or getsockopt(wl_display_get_fd(_control), SOL_SOCKET,
+			SO_PEERCRED, &cred, &len) < 0) {
+		fprintf(stderr, "cannot request the compositor dump\n");
+		return;
+	}
+
+	struct stat before;
+	if(stat(path.c_str(), &before) < 0)
+		before.st_ino = 0;
+
+	kill(cred.pid, SIGUSR1);
+
+	/* the dump is renamed in place, thus it get a new inode */
+	auto deadline = time64_t::now() + time64_t{5.0};
+	while(time64_t::now() < deadline) {
+		struct stat after;
+		if(stat(path.c_str(), &after) == 0 and after.st_ino != before.st_ino) {
+			printf("dump: %s\n", path.c_str());
+			return;
+		}
+		usleep(10000);
+	}
+
+	fprintf(stderr, "no compositor dump in %s\n", path.c_str());
+}
+
+}
+
+static void usage(char const * name) {
+	fprintf(stderr, "usage: %s [--realtime] [--dump] [--sync N] <record>\n", name);
+}
+
+int main(int argc, char ** argv) {
+	bool realtime = false;
+	bool dump = false;
+	unsigned sync_interval = 64;
+	char const * file = nullptr;
+
+	for(int k = 1; k < argc; ++k) {
+		std::string x = argv[k];
+		if(x == "--realtime") {
+			realtime = true;
+		} else if(x == "--dump") {
+			dump = true;
+		} else if(x == "--sync" and k + 1 < argc) {
+			sync_interval = std::max(1, atoi(argv[++k]));
+		} else if(file == nullptr) {
+			file = argv[k];
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if(file == nullptr) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	std::ifstream in{file};
+	if(not in) {
+		fprintf(stderr, "cannot open %s\n", file);
+		return 1;
+	}
+
+	page::replayer_t replayer{realtime, dump, sync_interval};
+	return replayer.run(in) ? 0 : 1;
+}
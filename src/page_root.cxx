@@ -54,6 +54,10 @@ string page_root_t::get_node_name() const {
 	return _get_node_name<'P'>();
 }
 
+string page_root_t::get_dump_name() const {
+	return _get_dump_name<'P'>() + " " + _root_position.to_string();
+}
+
 void page_root_t::render(cairo_t * cr, region const & area) {
 //	auto pix = _ctx->theme()->get_background();
 //
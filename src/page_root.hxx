@@ -51,6 +51,7 @@ public:
 	//virtual void hide();
 	//virtual void show();
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	//virtual void remove(shared_ptr<tree_t> t);
 
 	//virtual void append_children(vector<shared_ptr<tree_t>> & out) const;
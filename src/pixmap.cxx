@@ -11,27 +11,100 @@
 #include "page.hxx"
 #include "buffer-manager-server-protocol.h"
 
+#include <wayland-version.h>
+
 namespace page {
 
+static uint32_t _shm_format(pixmap_format_e format) {
+	return format == PIXMAP_RGB ? WL_SHM_FORMAT_XRGB8888 : WL_SHM_FORMAT_ARGB8888;
+}
+
+static cairo_format_t _cairo_format(pixmap_format_e format) {
+	return format == PIXMAP_RGB ? CAIRO_FORMAT_RGB24 : CAIRO_FORMAT_ARGB32;
+}
+
 void pixmap_t::_request_buffer() {
 	/* test create buffer */
 	_serial = wl_display_next_serial(_ctx->_dpy);
+	_ctx->_pending_pixmaps[_serial] = this;
+	_request_time = time64_t::now();
 	zzz_buffer_manager_send_get_buffer(_ctx->_buffer_manager_resource, _serial,
-			_w, _h);
+			_w, _h, _shm_format(_format), _scale);
 	wl_display_flush_clients(_ctx->_dpy);
 }
 
+/**
+ * Create the shm buffer directly on the internal client, no protocol
+ * round trip is involved. The buffer resource is only known through the
+ * resource created signal, available since wayland 1.14.
+ **/
+bool pixmap_t::_create_local_buffer() {
+#if WAYLAND_VERSION_MAJOR > 1 or WAYLAND_VERSION_MINOR >= 14
+	if(_ctx->ec == nullptr or _ctx->_internal_client == nullptr)
+		return false;
+
+	auto start = time64_t::now();
+
+	struct _created_t {
+		wl_listener listener;
+		wl_resource * resource;
+	} created;
+
+	created.resource = nullptr;
+	created.listener.notify = [](wl_listener * l, void * data) {
+		_created_t * c = wl_container_of(l, c, listener);
+		c->resource = reinterpret_cast<wl_resource *>(data);
+	};
+
+	wl_client_add_resource_created_listener(_ctx->_internal_client, &created.listener);
+	auto b = wl_shm_buffer_create(_ctx->_internal_client, 0, _w, _h, _w * 4,
+			_shm_format(_format));
+	wl_list_remove(&created.listener.link);
+
+	if(b == nullptr or created.resource == nullptr)
+		return false;
+
+	_resource = created.resource;
+	_wbuffer = weston_buffer_from_resource(_resource);
+	_wsurface = weston_surface_create(_ctx->ec);
+	/* no commit will come, set what it would have set */
+	_wsurface->buffer_viewport.buffer.scale = _scale;
+	weston_surface_set_size(_wsurface, _w / _scale, _h / _scale);
+	if(_format == PIXMAP_RGB)
+		set_opaque_region(region{0, 0, static_cast<int>(_w / _scale), static_cast<int>(_h / _scale)});
+	_surf = cairo_image_surface_create_for_data((uint8_t*)wl_shm_buffer_get_data(b),
+			_cairo_format(_format), wl_shm_buffer_get_width(b),
+			wl_shm_buffer_get_height(b), wl_shm_buffer_get_stride(b));
+	/* draw in surface coordinates */
+	cairo_surface_set_device_scale(_surf, _scale, _scale);
+	_is_local = true;
+
+	weston_log("pixmap %ux%u ready in %ld us (local)\n", _w, _h,
+			static_cast<long>(static_cast<int64_t>(time64_t::now() - start) / 1000L));
+	return true;
+#else
+	return false;
+#endif
+}
+
 pixmap_t::
-pixmap_t(page_t * ctx, pixmap_format_e format, unsigned width, unsigned height) :
+pixmap_t(page_t * ctx, pixmap_format_e format, unsigned width, unsigned height, unsigned scale) :
 	_ctx{ctx},
+	_format{format},
+	_scale{max(1u, scale)},
 	_w{width},
 	_h{height},
 	_resource{nullptr},
 	_serial{0},
-	_surf{nullptr}
+	_surf{nullptr},
+	_wbuffer{nullptr},
+	_wsurface{nullptr},
+	_is_local{false}
 {
 
-	if(not _ctx->_buffer_manager_resource) {
+	if(_ctx->_pixmap_local_allocation and _create_local_buffer()) {
+		/* ready */
+	} else if(not _ctx->_buffer_manager_resource) {
 		/* wait for bind_buffer_manager call */
 	} else {
 		_request_buffer();
@@ -40,7 +113,18 @@ pixmap_t(page_t * ctx, pixmap_format_e format, unsigned width, unsigned height)
 }
 
 pixmap_t::~pixmap_t() {
+	if(_serial)
+		_ctx->_pending_pixmaps.erase(_serial);
+
 	cairo_surface_destroy(_surf);
+
+	/* loopback buffers cannot be released, the protocol has no request for it */
+	if(_is_local) {
+		weston_surface_destroy(_wsurface);
+		wl_resource_destroy(_resource);
+	}
+
+	_ctx->_client_accounting.pixmap_destroyed(static_cast<int64_t>(_w) * _h * 4);
 }
 
 cairo_surface_t * pixmap_t::get_cairo_surface() const {
@@ -55,8 +139,44 @@ unsigned pixmap_t::height() const {
 	return _h;
 }
 
+auto pixmap_t::format() const -> pixmap_format_e {
+	return _format;
+}
+
+void pixmap_t::set_opaque_region(region const & r) {
+	if(_wsurface == nullptr)
+		return;
+
+	region opaque = r & region{0, 0, static_cast<int>(_w / _scale), static_cast<int>(_h / _scale)};
+
+	pixman_region32_fini(&_wsurface->opaque);
+	pixman_region32_init(&_wsurface->opaque);
+	for(auto const & b: opaque.rects()) {
+		pixman_region32_union_rect(&_wsurface->opaque, &_wsurface->opaque,
+				b.x, b.y, b.w, b.h);
+	}
+
+	/* views cache the opaque region in their transform */
+	weston_view * v;
+	wl_list_for_each(v, &_wsurface->views, surface_link) {
+		weston_view_geometry_dirty(v);
+	}
+}
+
+unsigned pixmap_t::scale() const {
+	return _scale;
+}
+
+bool pixmap_t::is_ready() const {
+	return _surf != nullptr;
+}
+
+bool pixmap_t::is_local() const {
+	return _is_local;
+}
+
 void pixmap_t::bind_buffer_manager() {
-	if(not _resource)
+	if(not _resource and not _serial)
 		_request_buffer();
 }
 
@@ -70,8 +190,13 @@ void pixmap_t::ack_buffer(wl_client * client, wl_resource * resource,
 	_wsurface = reinterpret_cast<weston_surface*>(wl_resource_get_user_data(surface));
 
 	_surf = cairo_image_surface_create_for_data((uint8_t*)wl_shm_buffer_get_data(b),
-			CAIRO_FORMAT_ARGB32, wl_shm_buffer_get_width(b),
+			_cairo_format(_format), wl_shm_buffer_get_width(b),
 			wl_shm_buffer_get_height(b), wl_shm_buffer_get_stride(b));
+	cairo_surface_set_device_scale(_surf, _scale, _scale);
+
+	_ctx->_pending_pixmaps.erase(_serial);
+	weston_log("pixmap %ux%u ready in %ld us (loopback)\n", _w, _h,
+			static_cast<long>(static_cast<int64_t>(time64_t::now() - _request_time) / 1000L));
 
 	on_ack_buffer.signal(this);
 
@@ -13,6 +13,8 @@
 #include <memory>
 
 #include "utils.hxx"
+#include "time.hxx"
+#include "region.hxx"
 
 namespace page {
 
@@ -21,8 +23,8 @@ using namespace std;
 class page_t;
 
 enum pixmap_format_e {
-	PIXMAP_RGB,
-	PIXMAP_RGBA
+	PIXMAP_RGB, // XRGB8888, fully opaque
+	PIXMAP_RGBA // ARGB8888, premultiplied
 };
 
 /**
@@ -30,6 +32,9 @@ enum pixmap_format_e {
  **/
 class pixmap_t {
 	page_t * _ctx;
+	pixmap_format_e _format;
+	/* width and height are in buffer pixels, the surface size is divided by scale */
+	unsigned _scale;
 	uint32_t _serial;
 	wl_resource * _resource;
 	cairo_surface_t * _surf;
@@ -37,7 +42,12 @@ class pixmap_t {
 	weston_buffer * _wbuffer;
 	weston_surface * _wsurface;
 
+	/* buffer created in the compositor process instead of the loopback client */
+	bool _is_local;
+	time64_t _request_time;
+
 	void _request_buffer();
+	bool _create_local_buffer();
 
 	pixmap_t(pixmap_t const & x) = delete;
 	pixmap_t & operator=(pixmap_t const & x) = delete;
@@ -45,12 +55,28 @@ public:
 
 	signal_t<pixmap_t *> on_ack_buffer;
 
-	pixmap_t(page_t * ctx, pixmap_format_e format, unsigned width, unsigned height);
+	pixmap_t(page_t * ctx, pixmap_format_e format, unsigned width, unsigned height, unsigned scale = 1);
 	~pixmap_t();
 
 	cairo_surface_t * get_cairo_surface() const;
 	unsigned witdh() const;
 	unsigned height() const;
+	auto format() const -> pixmap_format_e;
+	unsigned scale() const;
+
+	/**
+	 * Set the opaque region of the surface, in surface coordinates. PIXMAP_RGB
+	 * pixmaps are fully opaque, for PIXMAP_RGBA it default to empty. Must be
+	 * called once the pixmap is ready.
+	 **/
+	void set_opaque_region(region const & r);
+
+	/**
+	 * Local pixmaps are ready at construction, otherwise on_ack_buffer is
+	 * emitted once the loopback client reply.
+	 **/
+	bool is_ready() const;
+	bool is_local() const;
 
 	void bind_buffer_manager();
 	void ack_buffer(wl_client * client, wl_resource * resource,
@@ -23,6 +23,8 @@
 
 #include <compositor.h>
 
+#include "cursor_shape.hxx"
+
 namespace page {
 
 /**
@@ -47,6 +49,9 @@ struct pointer_grab_handler_t {
 	virtual void frame() = 0;
 	virtual void cancel() = 0;
 
+	/* cursor shown during the grab, CURSOR_NONE keep the client cursor */
+	virtual auto cursor() const -> cursor_shape_e { return CURSOR_NONE; }
+
 };
 
 void pointer_start_grab(weston_pointer * pointer,
@@ -0,0 +1,96 @@
+/*
+ * popup_split.cxx
+ *
+ * copyright (2010-2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "popup_split.hxx"
+
+#include "page_context.hxx"
+
+namespace page {
+
+popup_split_t::popup_split_t(page_context_t * ctx, shared_ptr<split_t> split) :
+	_ctx{ctx},
+	_split{split},
+	_is_visible{false},
+	_current_split{-1.0}
+{
+	/* above page views, below the cursor */
+	weston_layer_init(&_layer, &_ctx->ec->cursor_layer.link);
+
+	for(unsigned i = 0; i < _surfaces.size(); ++i) {
+		_surfaces[i] = weston_surface_create(_ctx->ec);
+		weston_surface_set_color(_surfaces[i], 0.0f, 0.4f, 0.0f, 1.0f);
+		/* the outline never take input */
+		pixman_region32_fini(&_surfaces[i]->input);
+		pixman_region32_init(&_surfaces[i]->input);
+		_views[i] = weston_view_create(_surfaces[i]);
+	}
+
+	set_position(split->ratio());
+}
+
+popup_split_t::~popup_split_t() {
+	hide();
+	/* views are destroyed with their surfaces */
+	for(auto s: _surfaces)
+		weston_surface_destroy(s);
+	wl_list_remove(&_layer.link);
+}
+
+void popup_split_t::set_position(double split) {
+	if(_split.expired() or split == _current_split)
+		return;
+	_current_split = split;
+
+	rect rect0;
+	rect rect1;
+	_split.lock()->compute_children_root_allocation(split, rect0, rect1);
+
+	rect bars[8] = {
+		rect{rect0.x, rect0.y, rect0.w, border_width},
+		rect{rect0.x, rect0.y, border_width, rect0.h},
+		rect{rect0.x, rect0.y + rect0.h - border_width, rect0.w, border_width},
+		rect{rect0.x + rect0.w - border_width, rect0.y, border_width, rect0.h},
+		rect{rect1.x, rect1.y, rect1.w, border_width},
+		rect{rect1.x, rect1.y, border_width, rect1.h},
+		rect{rect1.x, rect1.y + rect1.h - border_width, rect1.w, border_width},
+		rect{rect1.x + rect1.w - border_width, rect1.y, border_width, rect1.h}
+	};
+
+	for(unsigned i = 0; i < _views.size(); ++i) {
+		weston_surface_set_size(_surfaces[i], max(1, bars[i].w), max(1, bars[i].h));
+		weston_view_set_position(_views[i], bars[i].x, bars[i].y);
+		weston_view_schedule_repaint(_views[i]);
+	}
+}
+
+void popup_split_t::show() {
+	if(_is_visible)
+		return;
+	_is_visible = true;
+	for(auto v: _views) {
+		weston_layer_entry_insert(&_layer.view_list, &v->layer_link);
+		weston_view_geometry_dirty(v);
+		weston_view_update_transform(v);
+		weston_view_schedule_repaint(v);
+	}
+}
+
+void popup_split_t::hide() {
+	if(not _is_visible)
+		return;
+	_is_visible = false;
+	for(auto v: _views) {
+		weston_view_damage_below(v);
+		weston_layer_entry_remove(&v->layer_link);
+		weston_view_geometry_dirty(v);
+	}
+	weston_compositor_schedule_repaint(_ctx->ec);
+}
+
+}
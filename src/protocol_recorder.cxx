@@ -0,0 +1,221 @@
+/*
+ * protocol_recorder.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "protocol_recorder.hxx"
+
+#include <compositor.h>
+
+#include <cctype>
+#include <cstring>
+
+namespace page {
+
+protocol_recorder_t::protocol_recorder_t() :
+	_file{nullptr},
+	_ignored{nullptr},
+	_next_client{0}
+#ifdef HAVE_WL_PROTOCOL_LOGGER
+	, _logger{nullptr}
+#endif
+{
+
+}
+
+protocol_recorder_t::~protocol_recorder_t() {
+	stop();
+}
+
+bool protocol_recorder_t::start(wl_display * dpy, string const & file,
+		wl_client * ignored) {
+#ifdef HAVE_WL_PROTOCOL_LOGGER
+	stop();
+
+	_file = fopen(file.c_str(), "w");
+	if(_file == nullptr) {
+		weston_log("cannot open protocol record %s: %m\n", file.c_str());
+		return false;
+	}
+
+	/* the recorder must not slow down clients more than needed */
+	setvbuf(_file, nullptr, _IOFBF, 1<<20);
+
+	_start = time64_t::now();
+	_ignored = ignored;
+	_logger = wl_display_add_protocol_logger(dpy, &protocol_recorder_t::_log, this);
+	weston_log("recording protocol to %s\n", file.c_str());
+	return true;
+#else
+	weston_log("protocol recording is not supported by this libwayland\n");
+	return false;
+#endif
+}
+
+void protocol_recorder_t::stop() {
+#ifdef HAVE_WL_PROTOCOL_LOGGER
+	if(_logger) {
+		wl_protocol_logger_destroy(_logger);
+		_logger = nullptr;
+	}
+#endif
+
+	_clients.clear();
+
+	if(_file) {
+		fclose(_file);
+		_file = nullptr;
+	}
+}
+
+auto protocol_recorder_t::_timestamp() const -> long {
+	return static_cast<int64_t>(time64_t::now() - _start) / 1000L;
+}
+
+auto protocol_recorder_t::_client_id(wl_client * client) -> unsigned {
+	auto x = _clients.find(client);
+	if(x != _clients.end())
+		return x->second->id;
+
+	auto c = new _client_t;
+	c->id = _next_client++;
+	c->on_destroy.client_add_destroy_listener(client, this,
+			&protocol_recorder_t::_client_destroyed);
+	_clients[client] = unique_ptr<_client_t>{c};
+	return c->id;
+}
+
+void protocol_recorder_t::_client_destroyed(wl_client * client) {
+	auto x = _clients.find(client);
+	if(x == _clients.end())
+		return;
+
+	fprintf(_file, "%ld %u D\n", _timestamp(), x->second->id);
+	/* keep the record usable if the compositor crash later */
+	fflush(_file);
+	_clients.erase(x);
+}
+
+/* FNV-1a, only used to tell buffer contents apart */
+static uint64_t _hash_bytes(uint64_t h, uint8_t const * data, size_t size) {
+	for(size_t i = 0; i < size; ++i) {
+		h ^= data[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+void protocol_recorder_t::_log_buffer(unsigned client, wl_resource * buffer) {
+	auto shm = wl_shm_buffer_get(buffer);
+	if(shm == nullptr)
+		return;
+
+	int32_t width = wl_shm_buffer_get_width(shm);
+	int32_t height = wl_shm_buffer_get_height(shm);
+	int32_t stride = wl_shm_buffer_get_stride(shm);
+	uint64_t hash = 14695981039346656037ULL;
+
+	/* the row padding is hashed too, bytes per pixel depend on the format */
+	wl_shm_buffer_begin_access(shm);
+	auto data = reinterpret_cast<uint8_t const *>(wl_shm_buffer_get_data(shm));
+	hash = _hash_bytes(hash, data, static_cast<size_t>(stride) * height);
+	wl_shm_buffer_end_access(shm);
+
+	fprintf(_file, "%ld %u H %u %d %d %d %u %016lx\n", _timestamp(), client,
+			wl_resource_get_id(buffer), width, height, stride,
+			wl_shm_buffer_get_format(shm), static_cast<unsigned long>(hash));
+}
+
+#ifdef HAVE_WL_PROTOCOL_LOGGER
+
+static void _print_string(FILE * f, char const * s) {
+	if(s == nullptr) {
+		fputs(" s:~", f);
+		return;
+	}
+
+	fputs(" s:", f);
+	for(; *s; ++s) {
+		if(isalnum(*s) or strchr("._-/", *s))
+			fputc(*s, f);
+		else
+			fprintf(f, "%%%02x", static_cast<unsigned>(static_cast<uint8_t>(*s)));
+	}
+}
+
+void protocol_recorder_t::_log(void * data, wl_protocol_logger_type type,
+		wl_protocol_logger_message const * m) {
+	auto ths = reinterpret_cast<protocol_recorder_t *>(data);
+	auto client = wl_resource_get_client(m->resource);
+
+	if(client == ths->_ignored)
+		return;
+
+	bool request = type == WL_PROTOCOL_LOGGER_REQUEST;
+	auto interface = wl_resource_get_class(m->resource);
+	auto id = ths->_client_id(client);
+	auto f = ths->_file;
+
+	if(request and strcmp(interface, "wl_surface") == 0
+			and strcmp(m->message->name, "attach") == 0
+			and m->arguments[0].o != nullptr)
+		ths->_log_buffer(id, reinterpret_cast<wl_resource *>(m->arguments[0].o));
+
+	fprintf(f, "%ld %u %c %u %s %d %s", ths->_timestamp(), id,
+			request?'R':'E', wl_resource_get_id(m->resource), interface,
+			m->message_opcode, m->message->name);
+
+	int i = 0;
+	for(char const * sig = m->message->signature; *sig; ++sig) {
+		auto const & a = m->arguments[i];
+		switch(*sig) {
+		case 'i':
+			fprintf(f, " i:%d", a.i);
+			break;
+		case 'u':
+			fprintf(f, " u:%u", a.u);
+			break;
+		case 'f':
+			fprintf(f, " f:%d", a.f);
+			break;
+		case 's':
+			_print_string(f, a.s);
+			break;
+		case 'o':
+			fprintf(f, " o:%u", a.o?wl_resource_get_id(reinterpret_cast<wl_resource *>(a.o)):0u);
+			break;
+		case 'n':
+			/* events carry the new resource, requests its id */
+			if(request)
+				fprintf(f, " n:%u", a.n);
+			else
+				fprintf(f, " n:%u", a.o?wl_resource_get_id(reinterpret_cast<wl_resource *>(a.o)):0u);
+			break;
+		case 'a':
+			fputs(" a:", f);
+			if(a.a) {
+				auto bytes = reinterpret_cast<uint8_t const *>(a.a->data);
+				for(size_t k = 0; k < a.a->size; ++k)
+					fprintf(f, "%02x", bytes[k]);
+			}
+			break;
+		case 'h':
+			fprintf(f, " h:%d", a.h);
+			break;
+		default:
+			/* version and nullable markers */
+			continue;
+		}
+		++i;
+	}
+
+	fputc('\n', f);
+}
+
+#endif
+
+}
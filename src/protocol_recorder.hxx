@@ -0,0 +1,83 @@
+/*
+ * protocol_recorder.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Record the protocol messages of clients with timestamps, to be replayed
+ * later by page-replay. One message per line:
+ *
+ *   <usec> <client> R|E <object id> <interface> <opcode> <message> <args>
+ *
+ * Arguments are prefixed by their type, e.g. u:12 or s:foo%20bar. The
+ * content of shm buffers is not recorded, only its hash, in a line written
+ * before the wl_surface.attach that use it:
+ *
+ *   <usec> <client> H <buffer id> <width> <height> <stride> <format> <hash>
+ *
+ * Disconnected clients get a line "<usec> <client> D".
+ *
+ */
+
+#ifndef SRC_PROTOCOL_RECORDER_HXX_
+#define SRC_PROTOCOL_RECORDER_HXX_
+
+#include <wayland-server.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "config.hxx"
+#include "time.hxx"
+#include "listener.hxx"
+
+namespace page {
+
+using namespace std;
+
+class protocol_recorder_t {
+
+	struct _client_t {
+		unsigned id;
+		listener_t<wl_client> on_destroy;
+	};
+
+	FILE * _file;
+	time64_t _start;
+	/* the buffer manager, its messages are not recorded */
+	wl_client * _ignored;
+
+	unsigned _next_client;
+	map<wl_client *, unique_ptr<_client_t>> _clients;
+
+#ifdef HAVE_WL_PROTOCOL_LOGGER
+	wl_protocol_logger * _logger;
+
+	static void _log(void * data, wl_protocol_logger_type type,
+			wl_protocol_logger_message const * message);
+#endif
+
+	protocol_recorder_t(protocol_recorder_t const &) = delete;
+	protocol_recorder_t & operator=(protocol_recorder_t const &) = delete;
+
+	auto _client_id(wl_client * client) -> unsigned;
+	auto _timestamp() const -> long;
+	void _client_destroyed(wl_client * client);
+	void _log_buffer(unsigned client, wl_resource * buffer);
+
+public:
+	protocol_recorder_t();
+	~protocol_recorder_t();
+
+	/* return false if the file cannot be opened or recording is unsupported */
+	bool start(wl_display * dpy, string const & file, wl_client * ignored);
+	void stop();
+
+};
+
+}
+
+#endif /* SRC_PROTOCOL_RECORDER_HXX_ */
@@ -0,0 +1,413 @@
+/*
+ * render_worker.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "render_worker.hxx"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils.hxx"
+
+namespace page {
+
+using namespace std;
+
+/* size in buffer pixels of the tiles compared between two results */
+static int const _tile_size = 64;
+
+/**
+ * Return the tiles of image that differ from prev, in logical pixels. Both
+ * images have the RGB24 layout, prev may be nullptr.
+ **/
+static region _diff(cairo_surface_t * prev, cairo_surface_t * image, unsigned scale) {
+	int width = cairo_image_surface_get_width(image);
+	int height = cairo_image_surface_get_height(image);
+	int s = max(1u, scale);
+
+	auto logical = [s](int x0, int y0, int x1, int y1) -> region {
+		return region{x0 / s, y0 / s, (x1 + s - 1) / s - x0 / s, (y1 + s - 1) / s - y0 / s};
+	};
+
+	if(prev == nullptr
+			or cairo_image_surface_get_width(prev) != width
+			or cairo_image_surface_get_height(prev) != height
+			or cairo_image_surface_get_stride(prev) != cairo_image_surface_get_stride(image))
+		return logical(0, 0, width, height);
+
+	int stride = cairo_image_surface_get_stride(image);
+	uint8_t const * a = cairo_image_surface_get_data(prev);
+	uint8_t const * b = cairo_image_surface_get_data(image);
+
+	region damaged;
+	for(int ty = 0; ty < height; ty += _tile_size) {
+		int th = min(_tile_size, height - ty);
+		/* adjacent dirty tiles of a band are merged */
+		int run = -1;
+		for(int tx = 0; tx < width; tx += _tile_size) {
+			bool dirty = false;
+			size_t len = min(_tile_size, width - tx) * 4;
+			for(int y = ty; y < ty + th and not dirty; ++y) {
+				size_t offset = static_cast<size_t>(y) * stride + tx * 4;
+				dirty = memcmp(a + offset, b + offset, len) != 0;
+			}
+
+			if(dirty and run < 0) {
+				run = tx;
+			} else if(not dirty and run >= 0) {
+				damaged += logical(run, ty, tx, ty + th);
+				run = -1;
+			}
+		}
+
+		if(run >= 0)
+			damaged += logical(run, ty, width, ty + th);
+	}
+
+	return damaged;
+}
+
+render_worker_t::render_worker_t() :
+	_stop{false},
+	_serial{0},
+	_open_batch{0},
+	_batch_serial{0},
+	_notify_fd{-1},
+	_source{nullptr}
+{
+
+}
+
+render_worker_t::~render_worker_t() {
+	stop();
+}
+
+void render_worker_t::start(wl_event_loop * loop, theme_factory_t create_theme,
+		unsigned max_threads) {
+	stop();
+
+	_create_theme = create_theme;
+	_notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if(_notify_fd < 0)
+		return;
+
+	_source = wl_event_loop_add_fd(loop, _notify_fd, WL_EVENT_READABLE,
+			[](int fd, uint32_t mask, void * data) -> int {
+		reinterpret_cast<render_worker_t *>(data)->_dispatch();
+		return 0;
+	}, this);
+
+	_stop = false;
+	unsigned n = min(max(1u, thread::hardware_concurrency()), max(1u, max_threads));
+	for(unsigned i = 0; i < n; ++i)
+		_threads.push_back(thread{&render_worker_t::_run, this});
+}
+
+void render_worker_t::stop() {
+	if(not _threads.empty()) {
+		{
+			lock_guard<mutex> lock{_lock};
+			_stop = true;
+		}
+		_cond.notify_all();
+		for(auto & t: _threads)
+			t.join();
+		_threads.clear();
+	}
+
+	if(_source) {
+		wl_event_source_remove(_source);
+		_source = nullptr;
+	}
+
+	if(_notify_fd >= 0) {
+		close(_notify_fd);
+		_notify_fd = -1;
+	}
+
+	_pending.clear();
+	_latest.clear();
+	_batches.clear();
+	_open_batch = 0;
+	for(auto & x: _done)
+		cairo_surface_destroy(x.image);
+	_done.clear();
+	for(auto & x: _reference)
+		cairo_surface_destroy(x.second);
+	_reference.clear();
+	for(auto x: _pool)
+		cairo_surface_destroy(x);
+	_pool.clear();
+}
+
+bool render_worker_t::is_running() const {
+	return not _threads.empty();
+}
+
+void render_worker_t::set_config(page_config_p config) {
+	lock_guard<mutex> lock{_lock};
+	_config = config;
+}
+
+void render_worker_t::begin_batch() {
+	lock_guard<mutex> lock{_lock};
+	_open_batch = ++_batch_serial;
+}
+
+void render_worker_t::end_batch() {
+	lock_guard<mutex> lock{_lock};
+	auto batch = _open_batch;
+	_open_batch = 0;
+	if(_is_batch_complete(batch))
+		_notify();
+}
+
+/* must be called with _lock held */
+void render_worker_t::_notify() {
+	/* the main loop drain the eventfd, only overflow may fail */
+	eventfd_notify(_notify_fd);
+}
+
+/* must be called with _lock held */
+bool render_worker_t::_is_batch_complete(uint64_t batch) const {
+	if(batch == _open_batch)
+		return false;
+	auto x = _batches.find(batch);
+	return x == _batches.end() or x->second <= 0;
+}
+
+/* must be called with _lock held */
+void render_worker_t::_job_finished(uint64_t batch) {
+	_batches[batch] -= 1;
+	if(_is_batch_complete(batch))
+		_notify();
+}
+
+void render_worker_t::submit(render_job_p job) {
+	{
+		lock_guard<mutex> lock{_lock};
+		job->serial = ++_serial;
+		job->batch = _open_batch?_open_batch:++_batch_serial;
+		job->config = _config;
+
+		auto x = _pending.find(job->owner);
+		if(x != _pending.end()) {
+			/* replaced before being rendered */
+			_job_finished(x->second->batch);
+			x->second = job;
+		} else {
+			_pending[job->owner] = job;
+		}
+
+		_latest[job->owner] = job->serial;
+		_batches[job->batch] += 1;
+	}
+	_cond.notify_one();
+}
+
+void render_worker_t::cancel(void const * owner) {
+	lock_guard<mutex> lock{_lock};
+	auto x = _pending.find(owner);
+	if(x != _pending.end()) {
+		_job_finished(x->second->batch);
+		_pending.erase(x);
+	}
+	_latest.erase(owner);
+
+	auto r = _reference.find(owner);
+	if(r != _reference.end()) {
+		_recycle(r->second);
+		_reference.erase(r);
+	}
+}
+
+/* must be called with _lock held */
+void render_worker_t::_recycle(cairo_surface_t * image) {
+	/* a worker still compare a new result with it */
+	if(cairo_surface_get_reference_count(image) > 1) {
+		cairo_surface_destroy(image);
+		return;
+	}
+
+	/* last results are kept as references, each thread need only one
+	 * spare image to render into */
+	_pool.push_front(image);
+	while(_pool.size() > max<size_t>(1, _threads.size())) {
+		cairo_surface_destroy(_pool.back());
+		_pool.pop_back();
+	}
+}
+
+/* must be called with _lock held */
+auto render_worker_t::_get_image(int width, int height) -> cairo_surface_t * {
+	for(auto i = _pool.begin(); i != _pool.end(); ++i) {
+		if(cairo_image_surface_get_width(*i) == width
+				and cairo_image_surface_get_height(*i) == height) {
+			auto image = *i;
+			_pool.erase(i);
+			return image;
+		}
+	}
+	/* same layout as the opaque back buffers, the copy is a plain blit */
+	return cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+}
+
+void render_worker_t::_run() {
+	/* one theme per thread, pango objects are not shared between threads */
+	page_config_p theme_config;
+	theme_t * theme = nullptr;
+
+	unique_lock<mutex> lock{_lock};
+	for(;;) {
+		_cond.wait(lock, [this]() { return _stop or not _pending.empty(); });
+		if(_stop)
+			break;
+
+		auto job = _pending.begin()->second;
+		_pending.erase(_pending.begin());
+		auto image = _get_image(job->width, job->height);
+		cairo_surface_t * prev = nullptr;
+		auto r = _reference.find(job->owner);
+		if(r != _reference.end())
+			prev = cairo_surface_reference(r->second);
+		lock.unlock();
+
+		if(theme == nullptr or theme_config != job->config) {
+			delete theme;
+			theme = nullptr;
+			theme_config = job->config;
+			try {
+				if(theme_config)
+					theme = _create_theme(*theme_config);
+			} catch(...) {
+				theme = nullptr;
+			}
+		}
+
+		/* pooled images may come from an output with another scale */
+		cairo_surface_set_device_scale(image, job->scale, job->scale);
+		cairo_t * cr = cairo_create(image);
+		if(theme) {
+			theme->set_background(job->background.get(), job->background_x,
+					job->background_y);
+			render(theme, cr, *job);
+			theme->set_background(nullptr, 0, 0);
+		} else {
+			cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+			cairo_paint(cr);
+		}
+		cairo_destroy(cr);
+		cairo_surface_flush(image);
+
+		auto damaged = _diff(prev, image, job->scale);
+		if(prev)
+			cairo_surface_destroy(prev);
+
+		lock.lock();
+		_done.push_back(_result_t{job, image, damaged});
+		_job_finished(job->batch);
+	}
+	lock.unlock();
+
+	delete theme;
+}
+
+void render_worker_t::_dispatch() {
+	if(not eventfd_drain(_notify_fd))
+		weston_log("render worker: cannot read notification: %m\n");
+
+	list<_result_t> ready;
+
+	{
+		lock_guard<mutex> lock{_lock};
+		/* keep results of incomplete batches until their last job is done */
+		for(auto i = _done.begin(); i != _done.end();) {
+			if(not _is_batch_complete(i->job->batch)) {
+				++i;
+				continue;
+			}
+
+			auto latest = _latest.find(i->job->owner);
+			if(latest != _latest.end() and latest->second == i->job->serial) {
+				_latest.erase(latest);
+				ready.push_back(*i);
+				/* the owner buffer will match it once on_done return */
+				auto & r = _reference[i->job->owner];
+				if(r)
+					_recycle(r);
+				r = i->image;
+			} else {
+				/* a newer layout has been submitted or the owner is gone */
+				_recycle(i->image);
+			}
+			i = _done.erase(i);
+		}
+
+		for(auto i = _batches.begin(); i != _batches.end();) {
+			if(_is_batch_complete(i->first))
+				i = _batches.erase(i);
+			else
+				++i;
+		}
+	}
+
+	/* the images stay referenced until the owner cancel or get a new one */
+	for(auto & x: ready)
+		x.job->on_done(x.image, x.damaged);
+}
+
+void render_worker_t::render_notebook(theme_t const * theme, cairo_t * cr,
+		notebook_render_state_t const & s) {
+	theme->render_notebook(cr, &s.notebook);
+
+	if(s.tabs.size() > 0) {
+		/* keep the tabs at the resolution of the target */
+		double sx, sy;
+		cairo_surface_get_device_scale(cairo_get_target(cr), &sx, &sy);
+		cairo_surface_t * pix = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+				(s.tabs.back().position.x + 100) * sx,
+				theme->notebook.tab_height * sy);
+		cairo_surface_set_device_scale(pix, sx, sy);
+		cairo_t * xcr = cairo_create(pix);
+
+		cairo_set_operator(xcr, CAIRO_OPERATOR_SOURCE);
+		cairo_set_source_rgba(xcr, 0.0, 0.0, 0.0, 0.0);
+		cairo_paint(xcr);
+
+		theme->render_iconic_notebook(xcr, s.tabs);
+		cairo_destroy(xcr);
+
+		cairo_save(cr);
+		cairo_set_source_surface(cr, pix,
+				s.tabs_area.x - s.tabs_offset,
+				s.tabs_area.y);
+		cairo_clip(cr, s.tabs_area);
+		cairo_paint(cr);
+
+		cairo_restore(cr);
+		cairo_surface_destroy(pix);
+	}
+}
+
+void render_worker_t::render(theme_t const * theme, cairo_t * cr,
+		render_job_t const & job) {
+	cairo_identity_matrix(cr);
+	cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+	cairo_paint(cr);
+
+	for(auto & s: job.splits)
+		theme->render_split(cr, &s);
+
+	for(auto & n: job.notebooks)
+		render_notebook(theme, cr, n);
+}
+
+}
@@ -0,0 +1,168 @@
+/*
+ * render_worker.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Rasterize notebook and split decorations out of the main loop. The main
+ * loop snapshot the theme descriptions of a viewport into a job, a pool of
+ * worker threads render jobs with one theme instance per thread, then the
+ * results are handed back to the main loop to be copied into the viewport
+ * buffers. Jobs submitted within a batch are handed back together.
+ *
+ * The worker keep the last image handed back to each owner and compare the
+ * new one with it by tiles, thus the main loop only copy and damage what
+ * changed since the previous result.
+ *
+ */
+
+#ifndef SRC_RENDER_WORKER_HXX_
+#define SRC_RENDER_WORKER_HXX_
+
+#include <cairo/cairo.h>
+#include <wayland-server.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <list>
+#include <map>
+
+#include "theme.hxx"
+#include "theme_split.hxx"
+#include "theme_notebook.hxx"
+#include "page_config.hxx"
+#include "wallpaper.hxx"
+#include "region.hxx"
+
+namespace page {
+
+using namespace std;
+
+/* everything needed to draw a notebook, copied from the notebook */
+struct notebook_render_state_t {
+	theme_notebook_t notebook;
+	vector<theme_tab_t> tabs;
+	rect tabs_area;
+	int tabs_offset;
+};
+
+struct render_job_t {
+	/* only the last job of an owner is rendered */
+	void const * owner;
+	/* size in buffer pixels, the theme draw in logical pixels */
+	int width;
+	int height;
+	unsigned scale;
+	vector<theme_split_t> splits;
+	vector<notebook_render_state_t> notebooks;
+	/* wallpaper of the output and its root position, may be nullptr */
+	wallpaper_image_p background;
+	int background_x;
+	int background_y;
+
+	/**
+	 * Called in the main loop with the rendered image and the area, in
+	 * logical pixels, that changed since the previous image of the owner.
+	 * The image is owned by the worker and only valid during the call.
+	 **/
+	function<void(cairo_surface_t *, region const &)> on_done;
+
+	/* set by the worker */
+	uint64_t serial;
+	uint64_t batch;
+	page_config_p config;
+};
+
+using render_job_p = shared_ptr<render_job_t>;
+
+class render_worker_t {
+	using theme_factory_t = function<theme_t *(page_config_t const &)>;
+
+	struct _result_t {
+		render_job_p job;
+		cairo_surface_t * image;
+		region damaged;
+	};
+
+	theme_factory_t _create_theme;
+
+	vector<thread> _threads;
+	mutex _lock;
+	condition_variable _cond;
+	bool _stop;
+
+	page_config_p _config;
+	uint64_t _serial;
+
+	/* batch currently open, 0 if none */
+	uint64_t _open_batch;
+	uint64_t _batch_serial;
+	/* jobs of a batch not yet rendered */
+	map<uint64_t, int> _batches;
+
+	/* at most one job per owner, newer jobs replace older ones */
+	map<void const *, render_job_p> _pending;
+	/* last serial submitted per owner, older results are dropped */
+	map<void const *, uint64_t> _latest;
+	list<_result_t> _done;
+	/* last image handed back per owner, new results are compared to it */
+	map<void const *, cairo_surface_t *> _reference;
+	/* images not used anymore, reused by the worker */
+	list<cairo_surface_t *> _pool;
+
+	int _notify_fd;
+	wl_event_source * _source;
+
+	render_worker_t(render_worker_t const &) = delete;
+	render_worker_t & operator=(render_worker_t const &) = delete;
+
+	void _run();
+	auto _get_image(int width, int height) -> cairo_surface_t *;
+	void _recycle(cairo_surface_t * image);
+	void _job_finished(uint64_t batch);
+	bool _is_batch_complete(uint64_t batch) const;
+	void _notify();
+	void _dispatch();
+
+public:
+	render_worker_t();
+	~render_worker_t();
+
+	void start(wl_event_loop * loop, theme_factory_t create_theme,
+			unsigned max_threads = 4);
+	void stop();
+	bool is_running() const;
+
+	/**
+	 * Jobs submitted between begin_batch and end_batch are handed back to
+	 * the main loop at once, when all of them are rendered, thus all
+	 * outputs are updated in the same frame.
+	 **/
+	void begin_batch();
+	void end_batch();
+
+	/* theme used for jobs submitted after this call */
+	void set_config(page_config_p config);
+
+	void submit(render_job_p job);
+	/**
+	 * Drop pending job and ignore the in flight result of owner. The next
+	 * result of owner will be fully damaged, e.g. when its buffer changed
+	 * or was drawn by the main loop.
+	 **/
+	void cancel(void const * owner);
+
+	static void render_notebook(theme_t const * theme, cairo_t * cr,
+			notebook_render_state_t const & s);
+	static void render(theme_t const * theme, cairo_t * cr, render_job_t const & job);
+
+};
+
+}
+
+#endif /* SRC_RENDER_WORKER_HXX_ */
@@ -0,0 +1,132 @@
+/*
+ * scaled_proxy.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "scaled_proxy.hxx"
+
+#include <algorithm>
+
+#include "downscale.hxx"
+
+namespace page {
+
+using namespace std;
+
+scaled_proxy_t::scaled_proxy_t(page_context_t * ctx, weston_surface * source,
+		unsigned width, unsigned height) :
+	_ctx{ctx},
+	_source{source},
+	_src_width{0},
+	_src_height{0},
+	_surface{nullptr},
+	_view{nullptr}
+{
+	weston_surface_get_content_size(_source, &_src_width, &_src_height);
+
+	/* the proxy is only used over opaque clients */
+	_pix = _ctx->create_pixmap(width, height, PIXMAP_RGB);
+
+	/* loopback pixmaps are never released, do not keep one per client */
+	if(not _pix->is_local()) {
+		_pix = nullptr;
+		return;
+	}
+
+	_surface = _pix->wsurface();
+	weston_surface_set_role(_surface, "page_scaled_proxy", nullptr, 0);
+	/* let the input go to the client view underneath */
+	pixman_region32_fini(&_surface->input);
+	pixman_region32_init(&_surface->input);
+	_view = weston_view_create(_surface);
+
+	_update(region{0, 0, _src_width, _src_height});
+
+	_on_source_commit.connect(&_source->commit_signal, this,
+			&scaled_proxy_t::_source_commited);
+	_on_source_destroy.connect(&_source->destroy_signal, this,
+			&scaled_proxy_t::_source_destroyed);
+}
+
+scaled_proxy_t::~scaled_proxy_t() {
+	if(_view) {
+		weston_view_destroy(_view);
+		_view = nullptr;
+	}
+}
+
+bool scaled_proxy_t::is_valid() const {
+	return _view != nullptr;
+}
+
+bool scaled_proxy_t::match(unsigned width, unsigned height) const {
+	if(_pix == nullptr or _source == nullptr)
+		return false;
+
+	if(_pix->witdh() != width or _pix->height() != height)
+		return false;
+
+	int w, h;
+	weston_surface_get_content_size(_source, &w, &h);
+	return w == _src_width and h == _src_height;
+}
+
+auto scaled_proxy_t::view() const -> weston_view * {
+	return _view;
+}
+
+void scaled_proxy_t::_source_commited(weston_surface * s) {
+	int w, h;
+	weston_surface_get_content_size(s, &w, &h);
+
+	/* the owner rebuild the proxy on resize */
+	if(w != _src_width or h != _src_height or s->width <= 0 or s->height <= 0)
+		return;
+
+	/* damage is in surface coordinates, the content may be scaled */
+	int sx = max(1, w / s->width);
+	int sy = max(1, h / s->height);
+
+	region damaged;
+	int n;
+	auto rects = pixman_region32_rectangles(&s->damage, &n);
+	for(int i = 0; i < n; ++i) {
+		damaged += region{rects[i].x1 * sx, rects[i].y1 * sy,
+			(rects[i].x2 - rects[i].x1) * sx, (rects[i].y2 - rects[i].y1) * sy};
+	}
+
+	_update(damaged);
+}
+
+void scaled_proxy_t::_source_destroyed(weston_surface * s) {
+	_on_source_commit.disconnect();
+	_on_source_destroy.disconnect();
+	_source = nullptr;
+}
+
+void scaled_proxy_t::_update(region const & damaged) {
+	if(_source == nullptr or _src_width <= 0 or _src_height <= 0)
+		return;
+
+	region updated;
+	auto image = _pix->get_cairo_surface();
+	for(auto & r: (damaged & region{0, 0, _src_width, _src_height}).rects()) {
+		updated += region{box_downscale(_source, _src_width, _src_height,
+				image, r, _copy_buffer)};
+	}
+
+	if(updated.empty())
+		return;
+
+	(*_ctx->ec->renderer->attach)(_surface, _pix->wbuffer());
+	for(auto & r: updated.rects())
+		pixman_region32_union_rect(&_surface->damage, &_surface->damage, r.x, r.y, r.w, r.h);
+	weston_surface_schedule_repaint(_surface);
+	(*_ctx->ec->renderer->flush_damage)(_surface);
+}
+
+}
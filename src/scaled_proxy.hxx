@@ -0,0 +1,76 @@
+/*
+ * scaled_proxy.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Downscaled copy of a client surface, shown over the client view instead
+ * of letting the renderer resample the client on every repaint. The copy is
+ * refreshed on client commit, only within the damaged area. The proxy is
+ * opaque and has no input, thus the renderer skip the client underneath
+ * while the client view still receive the input.
+ *
+ */
+
+#ifndef SRC_SCALED_PROXY_HXX_
+#define SRC_SCALED_PROXY_HXX_
+
+#include <compositor.h>
+
+#include <memory>
+#include <vector>
+
+#include "pixmap.hxx"
+#include "listener.hxx"
+#include "page_context.hxx"
+
+namespace page {
+
+using namespace std;
+
+class scaled_proxy_t {
+	page_context_t * _ctx;
+
+	weston_surface * _source;
+	/* content size of the source the proxy has been built for */
+	int _src_width;
+	int _src_height;
+
+	pixmap_p _pix;
+	weston_surface * _surface;
+	weston_view * _view;
+
+	/* reused between updates to avoid allocation */
+	vector<uint8_t> _copy_buffer;
+
+	listener_t<weston_surface> _on_source_commit;
+	listener_t<weston_surface> _on_source_destroy;
+
+	scaled_proxy_t(scaled_proxy_t const &) = delete;
+	scaled_proxy_t & operator=(scaled_proxy_t const &) = delete;
+
+	void _source_commited(weston_surface * s);
+	void _source_destroyed(weston_surface * s);
+	void _update(region const & damaged);
+
+public:
+	scaled_proxy_t(page_context_t * ctx, weston_surface * source,
+			unsigned width, unsigned height);
+	~scaled_proxy_t();
+
+	/* false if no in process buffer could be allocated */
+	bool is_valid() const;
+
+	/* true if built for this size and the current source content size */
+	bool match(unsigned width, unsigned height) const;
+
+	auto view() const -> weston_view *;
+
+};
+
+using scaled_proxy_p = shared_ptr<scaled_proxy_t>;
+
+}
+
+#endif /* SRC_SCALED_PROXY_HXX_ */
@@ -79,7 +79,7 @@ rect simple2_theme_t::compute_notebook_menu_position(
 }
 
 
-simple2_theme_t::simple2_theme_t(config_handler_t & conf) {
+simple2_theme_t::simple2_theme_t(simple_theme_config_t const & conf) {
 
 	notebook.margin.top = 4;
 	notebook.margin.bottom = 4;
@@ -119,103 +119,57 @@ simple2_theme_t::simple2_theme_t(config_handler_t & conf) {
 	split.margin.right = 0;
 	split.width = 10;
 
-	std::string conf_img_dir = conf.get_string("default", "theme_dir");
-
-	default_background_color.set(
-			conf.get_string("simple_theme", "default_background_color"));
-
-	popup_text_color.set(conf.get_string("simple_theme", "popup_text_color"));
-	popup_outline_color.set(
-			conf.get_string("simple_theme", "popup_outline_color"));
-	popup_background_color.set(
-			conf.get_string("simple_theme", "popup_background_color"));
-
-	grip_color.set(conf.get_string("simple_theme", "grip_color"));
-
-	notebook_mouse_over_background_color.set(conf.get_string("simple_theme", "notebook_mouse_over_background_color"));
-
-	notebook_active_text_color.set(
-			conf.get_string("simple_theme", "notebook_active_text_color"));
-	notebook_active_outline_color.set(
-			conf.get_string("simple_theme", "notebook_active_outline_color"));
-	notebook_active_border_color.set(
-			conf.get_string("simple_theme", "notebook_active_border_color"));
-	notebook_active_background_color.set(
-			conf.get_string("simple_theme",
-					"notebook_active_background_color"));
-
-	notebook_selected_text_color.set(
-			conf.get_string("simple_theme", "notebook_selected_text_color"));
-	notebook_selected_outline_color.set(
-			conf.get_string("simple_theme", "notebook_selected_outline_color"));
-	notebook_selected_border_color.set(
-			conf.get_string("simple_theme", "notebook_selected_border_color"));
-	notebook_selected_background_color.set(
-			conf.get_string("simple_theme",
-					"notebook_selected_background_color"));
-
-	notebook_attention_text_color.set(
-			conf.get_string("simple_theme", "notebook_attention_text_color"));
-	notebook_attention_outline_color.set(
-			conf.get_string("simple_theme", "notebook_attention_outline_color"));
-	notebook_attention_border_color.set(
-			conf.get_string("simple_theme", "notebook_attention_border_color"));
-	notebook_attention_background_color.set(
-			conf.get_string("simple_theme",
-					"notebook_attention_background_color"));
-
-	notebook_normal_text_color.set(
-			conf.get_string("simple_theme", "notebook_normal_text_color"));
-	notebook_normal_outline_color.set(
-			conf.get_string("simple_theme", "notebook_normal_outline_color"));
-	notebook_normal_border_color.set(
-			conf.get_string("simple_theme", "notebook_normal_border_color"));
-	notebook_normal_background_color.set(
-			conf.get_string("simple_theme",
-					"notebook_normal_background_color"));
-
-	floating_active_text_color.set(
-			conf.get_string("simple_theme", "floating_active_text_color"));
-	floating_active_outline_color.set(
-			conf.get_string("simple_theme", "floating_active_outline_color"));
-	floating_active_border_color.set(
-			conf.get_string("simple_theme", "floating_active_border_color"));
-	floating_active_background_color.set(
-			conf.get_string("simple_theme",
-					"floating_active_background_color"));
-
-	floating_attention_text_color.set(
-			conf.get_string("simple_theme", "floating_attention_text_color"));
-	floating_attention_outline_color.set(
-			conf.get_string("simple_theme", "floating_attention_outline_color"));
-	floating_attention_border_color.set(
-			conf.get_string("simple_theme", "floating_attention_border_color"));
-	floating_attention_background_color.set(
-			conf.get_string("simple_theme",
-					"floating_attention_background_color"));
-
-	floating_normal_text_color.set(
-			conf.get_string("simple_theme", "floating_normal_text_color"));
-	floating_normal_outline_color.set(
-			conf.get_string("simple_theme", "floating_normal_outline_color"));
-	floating_normal_border_color.set(
-			conf.get_string("simple_theme", "floating_normal_border_color"));
-	floating_normal_background_color.set(
-			conf.get_string("simple_theme",
-					"floating_normal_background_color"));
-
-	notebook.margin.top =
-			conf.get_long("simple_theme",
-					"notebook_margin_top");
-	notebook.margin.bottom =
-			conf.get_long("simple_theme",
-					"notebook_margin_bottom");
-	notebook.margin.left =
-			conf.get_long("simple_theme",
-					"notebook_margin_left");
-	notebook.margin.right =
-			conf.get_long("simple_theme",
-					"notebook_margin_right");
+	std::string conf_img_dir = conf.theme_dir;
+
+	default_background_color = conf.default_background_color;
+
+	popup_text_color = conf.popup_text_color;
+	popup_outline_color = conf.popup_outline_color;
+	popup_background_color = conf.popup_background_color;
+
+	grip_color = conf.grip_color;
+
+	notebook_mouse_over_background_color = conf.notebook_mouse_over_background_color;
+
+	notebook_active_text_color = conf.notebook_active_text_color;
+	notebook_active_outline_color = conf.notebook_active_outline_color;
+	notebook_active_border_color = conf.notebook_active_border_color;
+	notebook_active_background_color = conf.notebook_active_background_color;
+
+	notebook_selected_text_color = conf.notebook_selected_text_color;
+	notebook_selected_outline_color = conf.notebook_selected_outline_color;
+	notebook_selected_border_color = conf.notebook_selected_border_color;
+	notebook_selected_background_color = conf.notebook_selected_background_color;
+
+	notebook_attention_text_color = conf.notebook_attention_text_color;
+	notebook_attention_outline_color = conf.notebook_attention_outline_color;
+	notebook_attention_border_color = conf.notebook_attention_border_color;
+	notebook_attention_background_color = conf.notebook_attention_background_color;
+
+	notebook_normal_text_color = conf.notebook_normal_text_color;
+	notebook_normal_outline_color = conf.notebook_normal_outline_color;
+	notebook_normal_border_color = conf.notebook_normal_border_color;
+	notebook_normal_background_color = conf.notebook_normal_background_color;
+
+	floating_active_text_color = conf.floating_active_text_color;
+	floating_active_outline_color = conf.floating_active_outline_color;
+	floating_active_border_color = conf.floating_active_border_color;
+	floating_active_background_color = conf.floating_active_background_color;
+
+	floating_attention_text_color = conf.floating_attention_text_color;
+	floating_attention_outline_color = conf.floating_attention_outline_color;
+	floating_attention_border_color = conf.floating_attention_border_color;
+	floating_attention_background_color = conf.floating_attention_background_color;
+
+	floating_normal_text_color = conf.floating_normal_text_color;
+	floating_normal_outline_color = conf.floating_normal_outline_color;
+	floating_normal_border_color = conf.floating_normal_border_color;
+	floating_normal_background_color = conf.floating_normal_background_color;
+
+	notebook.margin.top = conf.notebook_margin_top;
+	notebook.margin.bottom = conf.notebook_margin_bottom;
+	notebook.margin.left = conf.notebook_margin_left;
+	notebook.margin.right = conf.notebook_margin_right;
 
 	vsplit_button_s = nullptr;
 	hsplit_button_s = nullptr;
@@ -228,15 +182,11 @@ simple2_theme_t::simple2_theme_t(config_handler_t & conf) {
 	left_scroll_arrow_button_s = nullptr;
 	right_scroll_arrow_button_s = nullptr;
 
-	has_background = conf.has_key("simple_theme", "background_png");
-	if(has_background)
-		background_file = conf.get_string("simple_theme", "background_png");
-	scale_mode = "center";
-
-	if(conf.has_key("simple_theme", "scale_mode"))
-		scale_mode = conf.get_string("simple_theme", "scale_mode");
-
-	create_background_img();
+	/* the wallpaper is decoded by the wallpaper engine, see set_background */
+	has_background = false;
+	backgroun_px = nullptr;
+	background_x = 0;
+	background_y = 0;
 
 	/* open icons */
 	if (hsplit_button_s == nullptr) {
@@ -319,16 +269,16 @@ simple2_theme_t::simple2_theme_t(config_handler_t & conf) {
 			throw std::runtime_error("file not found!");
 	}
 
-	notebook_active_font_name = conf.get_string("simple_theme", "notebook_active_font").c_str();
-	notebook_selected_font_name = conf.get_string("simple_theme", "notebook_selected_font").c_str();
-	notebook_attention_font_name = conf.get_string("simple_theme", "notebook_attention_font").c_str();
-	notebook_normal_font_name = conf.get_string("simple_theme", "notebook_normal_font").c_str();
+	notebook_active_font_name = conf.notebook_active_font;
+	notebook_selected_font_name = conf.notebook_selected_font;
+	notebook_attention_font_name = conf.notebook_attention_font;
+	notebook_normal_font_name = conf.notebook_normal_font;
 
-	floating_active_font_name = conf.get_string("simple_theme", "floating_active_font").c_str();
-	floating_attention_font_name = conf.get_string("simple_theme", "floating_attention_font").c_str();
-	floating_normal_font_name = conf.get_string("simple_theme", "floating_normal_font").c_str();
+	floating_active_font_name = conf.floating_active_font;
+	floating_attention_font_name = conf.floating_attention_font;
+	floating_normal_font_name = conf.floating_normal_font;
 
-	pango_popup_font_name = conf.get_string("simple_theme", "pango_popup_font").c_str();
+	pango_popup_font_name = conf.pango_popup_font;
 
 	notebook_active_font = pango_font_description_from_string(notebook_active_font_name.c_str());
 	notebook_selected_font = pango_font_description_from_string(notebook_selected_font_name.c_str());
@@ -347,8 +297,39 @@ simple2_theme_t::simple2_theme_t(config_handler_t & conf) {
 
 }
 
+void simple2_theme_t::warm_up_fonts(simple_theme_config_t const & conf) {
+	string const * fonts[] = {
+		&conf.notebook_active_font,
+		&conf.notebook_selected_font,
+		&conf.notebook_attention_font,
+		&conf.notebook_normal_font,
+		&conf.floating_active_font,
+		&conf.floating_attention_font,
+		&conf.floating_normal_font,
+		&conf.pango_popup_font
+	};
+
+	auto font_map = pango_cairo_font_map_new();
+	auto context = pango_font_map_create_context(font_map);
+
+	for(auto name: fonts) {
+		if(name->empty())
+			continue;
+		auto desc = pango_font_description_from_string(name->c_str());
+		auto font = pango_font_map_load_font(font_map, context, desc);
+		if(font)
+			g_object_unref(font);
+		pango_font_description_free(desc);
+	}
+
+	g_object_unref(context);
+	g_object_unref(font_map);
+}
+
 simple2_theme_t::~simple2_theme_t() {
 
+	set_background(nullptr, 0, 0);
+
 	warn(cairo_surface_get_reference_count(hsplit_button_s) == 1);
 	cairo_surface_destroy(hsplit_button_s);
 	warn(cairo_surface_get_reference_count(vsplit_button_s) == 1);
@@ -413,7 +394,7 @@ void simple2_theme_t::render_notebook(cairo_t * cr, theme_notebook_t const * n)
 	cairo_clip(cr, n->allocation);
 	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
 	if (backgroun_px != nullptr) {
-		CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, -n->root_x, -n->root_y));
+		CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, background_x - n->root_x, background_y - n->root_y));
 	} else {
 		CHECK_CAIRO(cairo_set_source_color_alpha(cr, default_background_color));
 	}
@@ -465,7 +446,7 @@ void simple2_theme_t::render_notebook(cairo_t * cr, theme_notebook_t const * n)
 			CHECK_CAIRO(cairo_save(cr));
 			cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
 			if (backgroun_px != nullptr) {
-				CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, -n->root_x, -n->root_y));
+				CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, background_x - n->root_x, background_y - n->root_y));
 			} else {
 				CHECK_CAIRO(cairo_set_source_color_alpha(cr, default_background_color));
 			}
@@ -1001,7 +982,7 @@ void simple2_theme_t::render_split(cairo_t * cr,
 
 	rect sarea = s->allocation;
 	if (backgroun_px != nullptr) {
-		CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, -s->root_x, -s->root_y));
+		CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, background_x - s->root_x, background_y - s->root_y));
 	} else {
 		CHECK_CAIRO(cairo_set_source_color_alpha(cr, default_background_color));
 	}
@@ -1059,7 +1040,7 @@ void simple2_theme_t::render_empty(cairo_t * cr, rect const & area) const {
 	cairo_clip(cr, area);
 	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
 	if (backgroun_px != nullptr) {
-		CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, 0.0, 0.0));
+		CHECK_CAIRO(cairo_set_source_surface(cr, backgroun_px, background_x, background_y));
 	} else {
 		CHECK_CAIRO(cairo_set_source_color_alpha(cr, default_background_color));
 	}
@@ -1556,197 +1537,18 @@ void simple2_theme_t::draw_hatched_i_rect(cairo_t * cr, int space, int x, int y,
 }
 
 void simple2_theme_t::update() {
-	create_background_img();
-}
 
-void simple2_theme_t::create_background_img() {
-
-	has_background = false;
-	backgroun_px = nullptr;
-
-//	if (has_background and false) {
-//
-//		cairo_surface_t * tmp = cairo_image_surface_create_from_png(
-//				background_file.c_str());
-//
-//		//xcb_get_geometry_cookie_t ck = xcb_get_geometry(_cnx->xcb(), _cnx->root());
-//		void * geometry = nullptr; //xcb_get_geometry_reply(_cnx->xcb(), ck, 0);
-//
-//		cairo_surface_t * image_background_s = nullptr; //cairo_image_surface_create(CAIRO_FORMAT_RGB24, geometry->width, geometry->height);
-//
-//		/**
-//		 * WARNING: transform order and set_source_surface have huge
-//		 * Consequence.
-//		 **/
-//
-//		double src_width = cairo_image_surface_get_width(tmp);
-//		double src_height = cairo_image_surface_get_height(tmp);
-//
-//		if (src_width > 0 and src_height > 0) {
-//
-//			if (scale_mode == "stretch") {
-//
-//				cairo_t * cr = cairo_create(image_background_s);
-//
-//				CHECK_CAIRO(::cairo_set_source_rgb(cr, 0.5, 0.5, 0.5));
-//				CHECK_CAIRO(cairo_rectangle(cr, 0, 0, geometry->width, geometry->height));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				double x_ratio = geometry->width / src_width;
-//				double y_ratio = geometry->height / src_height;
-//				CHECK_CAIRO(cairo_scale(cr, x_ratio, y_ratio));
-//				CHECK_CAIRO(cairo_set_source_surface(cr, tmp, 0, 0));
-//				CHECK_CAIRO(cairo_rectangle(cr, 0, 0, src_width, src_height));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				warn(cairo_get_reference_count(cr) == 1);
-//				cairo_destroy(cr);
-//
-//			} else if (scale_mode == "zoom") {
-//
-//				cairo_t * cr = cairo_create(image_background_s);
-//
-//				CHECK_CAIRO(::cairo_set_source_rgb(cr, 0.5, 0.5, 0.5));
-//				CHECK_CAIRO(cairo_rectangle(cr, 0, 0, geometry->width, geometry->height));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				double x_ratio = geometry->width / (double)src_width;
-//				double y_ratio = geometry->height / (double)src_height;
-//
-//				double x_offset;
-//				double y_offset;
-//
-//				if (x_ratio > y_ratio) {
-//
-//					double yp = geometry->height / x_ratio;
-//
-//					x_offset = 0;
-//					y_offset = (yp - src_height) / 2.0;
-//
-//					CHECK_CAIRO(cairo_scale(cr, x_ratio, x_ratio));
-//					CHECK_CAIRO(cairo_set_source_surface(cr, tmp, x_offset, y_offset));
-//					CHECK_CAIRO(cairo_rectangle(cr, 0, 0, src_width, yp));
-//					CHECK_CAIRO(cairo_fill(cr));
-//
-//				} else {
-//
-//					double xp = geometry->width / y_ratio;
-//
-//					x_offset = (xp - src_width) / 2.0;
-//					y_offset = 0;
-//
-//					CHECK_CAIRO(cairo_scale(cr, y_ratio, y_ratio));
-//					CHECK_CAIRO(cairo_set_source_surface(cr, tmp, x_offset, y_offset));
-//					CHECK_CAIRO(cairo_rectangle(cr, 0, 0, xp, src_height));
-//					CHECK_CAIRO(cairo_fill(cr));
-//				}
-//
-//				warn(cairo_get_reference_count(cr) == 1);
-//				cairo_destroy(cr);
-//
-//			} else if (scale_mode == "center") {
-//
-//				cairo_t * cr = cairo_create(image_background_s);
-//
-//				CHECK_CAIRO(::cairo_set_source_rgb(cr, 0.5, 0.5, 0.5));
-//				CHECK_CAIRO(cairo_rectangle(cr, 0, 0, geometry->width, geometry->height));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				double x_offset = (geometry->width - src_width) / 2.0;
-//				double y_offset = (geometry->height - src_height) / 2.0;
-//
-//				CHECK_CAIRO(cairo_set_source_surface(cr, tmp, x_offset, y_offset));
-//				CHECK_CAIRO(cairo_rectangle(cr, max<double>(0.0, x_offset),
-//						max<double>(0.0, y_offset),
-//						min<double>(src_width, geometry->width),
-//						min<double>(src_height, geometry->height)));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				warn(cairo_get_reference_count(cr) == 1);
-//				cairo_destroy(cr);
-//
-//			} else if (scale_mode == "scale" || scale_mode == "span") {
-//
-//				cairo_t * cr = cairo_create(image_background_s);
-//
-//				CHECK_CAIRO(::cairo_set_source_rgb(cr, 0.5, 0.5, 0.5));
-//				CHECK_CAIRO(cairo_rectangle(cr, 0, 0, geometry->width, geometry->height));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				double x_ratio = geometry->width / src_width;
-//				double y_ratio = geometry->height / src_height;
-//
-//				double x_offset, y_offset;
-//
-//				if (x_ratio < y_ratio) {
-//
-//					double yp = geometry->height / x_ratio;
-//
-//					x_offset = 0;
-//					y_offset = (yp - src_height) / 2.0;
-//
-//					CHECK_CAIRO(cairo_scale(cr, x_ratio, x_ratio));
-//					CHECK_CAIRO(cairo_set_source_surface(cr, tmp, x_offset, y_offset));
-//					CHECK_CAIRO(cairo_rectangle(cr, x_offset, y_offset, src_width, src_height));
-//					CHECK_CAIRO(cairo_fill(cr));
-//
-//				} else {
-//					double xp = geometry->width / y_ratio;
-//
-//					y_offset = 0;
-//					x_offset = (xp - src_width) / 2.0;
-//
-//					CHECK_CAIRO(cairo_scale(cr, y_ratio, y_ratio));
-//					CHECK_CAIRO(cairo_set_source_surface(cr, tmp, x_offset, y_offset));
-//					CHECK_CAIRO(cairo_rectangle(cr, x_offset, y_offset, src_width, src_height));
-//					CHECK_CAIRO(cairo_fill(cr));
-//				}
-//
-//				warn(cairo_get_reference_count(cr) == 1);
-//				cairo_destroy(cr);
-//
-//			} else if (scale_mode == "tile") {
-//
-//				cairo_t * cr = cairo_create(image_background_s);
-//				CHECK_CAIRO(::cairo_set_source_rgb(cr, 0.5, 0.5, 0.5));
-//				CHECK_CAIRO(cairo_rectangle(cr, 0, 0, geometry->width, geometry->height));
-//				CHECK_CAIRO(cairo_fill(cr));
-//
-//				for (double x = 0; x < geometry->width; x += src_width) {
-//					for (double y = 0; y < geometry->height; y += src_height) {
-//						CHECK_CAIRO(cairo_identity_matrix(cr));
-//						CHECK_CAIRO(cairo_translate(cr, x, y));
-//						CHECK_CAIRO(cairo_set_source_surface(cr, tmp, 0, 0));
-//						CHECK_CAIRO(cairo_rectangle(cr, 0, 0, geometry->width, geometry->height));
-//						CHECK_CAIRO(cairo_fill(cr));
-//					}
-//				}
-//
-//				warn(cairo_get_reference_count(cr) == 1);
-//				cairo_destroy(cr);
-//
-//			}
-//
-//		}
-//
-//		warn(cairo_surface_get_reference_count(tmp) == 1);
-//		cairo_surface_destroy(tmp);
-//
-//		/* copy background to pixmap */
-//		backgroun_px = nullptr; //make_shared<pixmap_t>(_cnx, PIXMAP_RGB, geometry->width, geometry->height);
-//
-//		cairo_t * cr = cairo_create(backgroun_px->get_cairo_surface());
-//		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-//		cairo_set_source_surface(cr, image_background_s, 0.0, 0.0);
-//		cairo_paint(cr);
-//		cairo_destroy(cr);
-//
-//		cairo_surface_destroy(image_background_s);
-//
-//		free(geometry);
-//
-//	}
+}
 
+void simple2_theme_t::set_background(cairo_surface_t * image, int x, int y) {
+	if(image)
+		cairo_surface_reference(image);
+	if(backgroun_px)
+		cairo_surface_destroy(backgroun_px);
+	backgroun_px = image;
+	has_background = (image != nullptr);
+	background_x = x;
+	background_y = y;
 }
 
 void simple2_theme_t::render_popup_split(cairo_t * cr, theme_split_t const * s,
@@ -18,7 +18,7 @@
 #include "utils.hxx"
 #include "theme.hxx"
 #include "color.hxx"
-#include "config_handler.hxx"
+#include "page_config.hxx"
 #include "renderable.hxx"
 #include "pixmap.hxx"
 
@@ -110,15 +110,23 @@ public:
 	color_t floating_normal_background_color;
 
 	bool has_background;
-	std::string background_file;
-	std::string scale_mode;
 
+	/* wallpaper of the output being drawn, and its root position */
 	cairo_surface_t * backgroun_px;
+	int background_x;
+	int background_y;
 
-	simple2_theme_t(config_handler_t & conf);
+	simple2_theme_t(simple_theme_config_t const & conf);
 
 	virtual ~simple2_theme_t();
 
+	/**
+	 * Load the theme fonts once, the fontconfig cache is shared by all font
+	 * maps thus the first render do not pay for it. Safe to call from
+	 * another thread.
+	 **/
+	static void warm_up_fonts(simple_theme_config_t const & conf);
+
 	rect compute_notebook_close_window_position(
 			rect const & allocation, int number_of_client,
 			int selected_client_index) const;
@@ -146,8 +154,6 @@ public:
 	static void rounded_i_rect(cairo_t * cr, double x, double y, double w,
 			double h, double r);
 
-	void create_background_img();
-
 	virtual void render_notebook(cairo_t * cr, theme_notebook_t const * n) const;
 	virtual void render_iconic_notebook(cairo_t * cr, vector<theme_tab_t> const & tabs) const;
 	virtual void render_split(cairo_t * cr, theme_split_t const * s) const;
@@ -208,6 +214,7 @@ public:
 	static void cairo_rounded_tab3(cairo_t * cr, double x, double y, double w, double h, double radius);
 
 	virtual cairo_surface_t * get_background() const;
+	virtual void set_background(cairo_surface_t * image, int x, int y);
 
 	virtual color_t const & get_focused_color() const;
 	virtual color_t const & get_selected_color() const;
@@ -206,6 +206,11 @@ void split_t::set_pack1(shared_ptr<page_component_t> x) {
 }
 
 void split_t::render_legacy(cairo_t * cr) const {
+	auto ts = get_theme_split();
+	_ctx->theme()->render_split(cr, &ts);
+}
+
+auto split_t::get_theme_split() const -> theme_split_t {
 	theme_split_t ts;
 	ts.split = _ratio;
 	ts.type = _type;
@@ -213,7 +218,7 @@ void split_t::render_legacy(cairo_t * cr) const {
 	ts.root_x = get_window_position().x;
 	ts.root_y = get_window_position().y;
 	ts.has_mouse_over = _has_mouse_over;
-	_ctx->theme()->render_split(cr, &ts);
+	return ts;
 }
 
 void split_t::activate() {
@@ -300,6 +305,11 @@ auto split_t::get_node_name() const -> string {
 	return _get_node_name<'S'>();
 }
 
+auto split_t::get_dump_name() const -> string {
+	return _get_dump_name<'S'>() + " " + _allocation.to_string()
+			+ xformat(" %s %.3f", _type == VERTICAL_SPLIT?"vertical":"horizontal", _ratio);
+}
+
 rect split_t::allocation() const {
 	return _allocation;
 }
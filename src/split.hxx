@@ -57,6 +57,7 @@ public:
 	auto ratio() const -> double { return _ratio; }
 	auto type() const -> split_type_e { return _type; }
 	void render_legacy(cairo_t * cr) const;
+	auto get_theme_split() const -> theme_split_t;
 
 	void set_split(double split);
 	void set_pack0(shared_ptr<page_component_t> x);
@@ -76,6 +77,7 @@ public:
 	virtual void hide();
 	virtual void show();
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	virtual void remove(shared_ptr<tree_t> t);
 
 	virtual void append_children(vector<shared_ptr<tree_t>> & out) const;
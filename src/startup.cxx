@@ -0,0 +1,168 @@
+/*
+ * startup.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "startup.hxx"
+
+#include <compositor.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace page {
+
+using namespace std;
+
+static long _ms(time64_t t) {
+	return static_cast<int64_t>(t) / 1000000L;
+}
+
+startup_t::startup_t() :
+	_origin{time64_t::now()},
+	_last_mark{_origin}
+{
+
+}
+
+startup_t::~startup_t() {
+	finish();
+}
+
+auto startup_t::_find(string const & name) -> _task_t * {
+	for(auto & t: _tasks) {
+		if(t.name == name)
+			return &t;
+	}
+	return nullptr;
+}
+
+auto startup_t::_next_ready() -> _task_t * {
+	for(auto & t: _tasks) {
+		if(t.is_running or t.is_done)
+			continue;
+		bool ready = all_of(t.deps.begin(), t.deps.end(), [this](string const & d) {
+			auto x = _find(d);
+			return x == nullptr or x->is_done;
+		});
+		if(ready)
+			return &t;
+	}
+	return nullptr;
+}
+
+bool startup_t::_all_started() const {
+	return all_of(_tasks.begin(), _tasks.end(), [](_task_t const & t) {
+		return t.is_running or t.is_done;
+	});
+}
+
+void startup_t::_worker() {
+	unique_lock<mutex> lock{_lock};
+	while(not _all_started()) {
+		auto t = _next_ready();
+		if(t == nullptr) {
+			_cond.wait(lock);
+			continue;
+		}
+
+		t->is_running = true;
+		lock.unlock();
+
+		t->start = time64_t::now();
+		try {
+			t->func();
+		} catch(...) {
+			t->error = current_exception();
+		}
+		t->end = time64_t::now();
+
+		lock.lock();
+		t->is_running = false;
+		t->is_done = true;
+		_cond.notify_all();
+	}
+}
+
+/* weston_log is not thread safe, only called from the main thread */
+void startup_t::_log(_task_t & t) {
+	if(t.is_logged)
+		return;
+	t.is_logged = true;
+	weston_log("startup: task %s took %ld ms (done at %ld ms)%s\n", t.name.c_str(),
+			_ms(t.end - t.start), _ms(t.end - _origin), t.error?" FAILED":"");
+}
+
+void startup_t::add(string const & name, vector<string> const & deps,
+		function<void()> func) {
+	assert(_workers.empty());
+	for(auto & d: deps)
+		assert(_find(d) != nullptr);
+	_tasks.push_back(_task_t{name, deps, func, false, false, false, {}, {}, nullptr});
+}
+
+void startup_t::start(unsigned max_workers) {
+	unsigned n = min<unsigned>(max(1u, thread::hardware_concurrency()), max(1u, max_workers));
+	n = min<unsigned>(n, _tasks.size());
+	for(unsigned i = 0; i < n; ++i)
+		_workers.push_back(thread{&startup_t::_worker, this});
+}
+
+void startup_t::wait(string const & name) {
+	exception_ptr error;
+
+	{
+		unique_lock<mutex> lock{_lock};
+		auto t = _find(name);
+		if(t == nullptr)
+			return;
+
+		if(_workers.empty() and not t->is_done) {
+			/* not started, nothing will run it */
+			lock.unlock();
+			start();
+			lock.lock();
+		}
+
+		auto wait_start = time64_t::now();
+		_cond.wait(lock, [t]() { return t->is_done; });
+		auto blocked = time64_t::now() - wait_start;
+		if(_ms(blocked) > 0)
+			weston_log("startup: main thread blocked %ld ms on %s\n",
+					_ms(blocked), name.c_str());
+
+		_log(*t);
+		error = t->error;
+	}
+
+	if(error)
+		rethrow_exception(error);
+}
+
+void startup_t::finish() {
+	for(auto & w: _workers)
+		w.join();
+	_workers.clear();
+
+	for(auto & t: _tasks) {
+		if(t.is_done)
+			_log(t);
+	}
+}
+
+void startup_t::mark(char const * phase) {
+	auto now = time64_t::now();
+	weston_log("startup: %s took %ld ms (at %ld ms)\n", phase,
+			_ms(now - _last_mark), _ms(now - _origin));
+	_last_mark = now;
+}
+
+auto startup_t::elapsed() const -> time64_t {
+	return time64_t::now() - _origin;
+}
+
+}
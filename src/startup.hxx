@@ -0,0 +1,87 @@
+/*
+ * startup.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Dependency graph of initialization tasks. Tasks that do not need the
+ * compositor (theme assets, fonts, keymaps) run on a small pool of threads
+ * while the main thread initialize the backend, the main thread wait for a
+ * task only when it need its result.
+ *
+ */
+
+#ifndef SRC_STARTUP_HXX_
+#define SRC_STARTUP_HXX_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <string>
+#include <vector>
+#include <list>
+
+#include "time.hxx"
+
+namespace page {
+
+using namespace std;
+
+class startup_t {
+
+	struct _task_t {
+		string name;
+		vector<string> deps;
+		function<void()> func;
+
+		bool is_running;
+		bool is_done;
+		bool is_logged;
+		time64_t start;
+		time64_t end;
+		exception_ptr error;
+	};
+
+	time64_t _origin;
+	time64_t _last_mark;
+
+	mutex _lock;
+	condition_variable _cond;
+	/* list keep references stable while workers run tasks */
+	list<_task_t> _tasks;
+	vector<thread> _workers;
+
+	startup_t(startup_t const &) = delete;
+	startup_t & operator=(startup_t const &) = delete;
+
+	auto _find(string const & name) -> _task_t *;
+	auto _next_ready() -> _task_t *;
+	bool _all_started() const;
+	void _worker();
+	void _log(_task_t & t);
+
+public:
+	startup_t();
+	~startup_t();
+
+	/* tasks must be added before start, deps must be added before */
+	void add(string const & name, vector<string> const & deps, function<void()> func);
+	void start(unsigned max_workers = 4);
+
+	/* block until the task is done, rethrow its exception if any */
+	void wait(string const & name);
+	/* wait all tasks and release the workers */
+	void finish();
+
+	/* log the time spent on the main thread since the previous mark */
+	void mark(char const * phase);
+	auto elapsed() const -> time64_t;
+
+};
+
+}
+
+#endif /* SRC_STARTUP_HXX_ */
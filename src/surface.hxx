@@ -52,6 +52,9 @@ struct surface_t {
 	virtual void send_close() = 0;
 	virtual void send_configure_popup(int32_t x, int32_t y, int32_t width, int32_t height) = 0;
 
+	/* true until the client ack the last configure, false if acks are not supported */
+	virtual bool has_pending_configure() const { return false; }
+
 };
 
 }
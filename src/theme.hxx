@@ -113,6 +113,12 @@ public:
 
 	virtual cairo_surface_t * get_background() const = 0;
 
+	/**
+	 * Wallpaper of the output being drawn, x and y are its root position.
+	 * The image is referenced until the next call, nullptr drop it.
+	 **/
+	virtual void set_background(cairo_surface_t * image, int x, int y) = 0;
+
 	virtual color_t const & get_focused_color() const = 0;
 	virtual color_t const & get_selected_color() const = 0;
 	virtual color_t const & get_normal_color() const = 0;
@@ -0,0 +1,249 @@
+/*
+ * thumbnail_cache.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "thumbnail_cache.hxx"
+
+#include <wayland-server.h>
+
+#include <algorithm>
+
+#include "downscale.hxx"
+
+namespace page {
+
+using namespace std;
+
+/* thumbnails not requested since this delay are refreshed on next get */
+static time64_t const _active_delay{1.0};
+
+thumbnail_cache_t::_thumbnail_t::_thumbnail_t(thumbnail_cache_t * owner,
+		weston_surface * surface) :
+	_owner{owner},
+	_surface{surface},
+	_image{nullptr},
+	_src_width{0},
+	_src_height{0},
+	_last_update{0L},
+	_last_request{0L}
+{
+	int w, h;
+	weston_surface_get_content_size(surface, &w, &h);
+	_damaged = region{0, 0, w, h};
+
+	on_commit.connect(&surface->commit_signal, this,
+			&_thumbnail_t::surface_commited);
+	on_destroy.connect(&surface->destroy_signal, this,
+			&_thumbnail_t::surface_destroyed);
+}
+
+thumbnail_cache_t::_thumbnail_t::~_thumbnail_t() {
+	if(_image)
+		cairo_surface_destroy(_image);
+}
+
+void thumbnail_cache_t::_thumbnail_t::surface_commited(weston_surface * s) {
+	int w, h;
+	weston_surface_get_content_size(s, &w, &h);
+
+	if(w != _src_width or h != _src_height) {
+		_damaged = region{0, 0, w, h};
+	} else {
+		int n;
+		auto rects = pixman_region32_rectangles(&s->damage, &n);
+		for(int i = 0; i < n; ++i) {
+			_damaged += region{rects[i].x1, rects[i].y1,
+				rects[i].x2 - rects[i].x1, rects[i].y2 - rects[i].y1};
+		}
+	}
+
+	/* only thumbnails currently shown are kept up to date */
+	auto now = time64_t::now();
+	if(not _damaged.empty() and now < _last_request + _active_delay)
+		_owner->_schedule(max<int64_t>(0L, _last_update + _owner->limits.min_interval - now));
+}
+
+void thumbnail_cache_t::_thumbnail_t::surface_destroyed(weston_surface * s) {
+	/* this will delete this, do not use this after */
+	_owner->_remove(s);
+}
+
+/**
+ * Downscale the damage by row bands until the budget is spent, the
+ * remaining damage is kept for the next call. Return true once the
+ * thumbnail is up to date.
+ **/
+bool thumbnail_cache_t::_thumbnail_t::refresh(int64_t & budget) {
+	int w, h;
+	weston_surface_get_content_size(_surface, &w, &h);
+	if(w <= 0 or h <= 0) {
+		_damaged = region{};
+		return true;
+	}
+
+	if(_image == nullptr or w != _src_width or h != _src_height) {
+		if(_image)
+			cairo_surface_destroy(_image);
+
+		double scale = min(1.0, static_cast<double>(_owner->limits.max_size)/max(w, h));
+		int tw = max(1, static_cast<int>(w * scale));
+		int th = max(1, static_cast<int>(h * scale));
+		_image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, tw, th);
+		_src_width = w;
+		_src_height = h;
+		_damaged = region{0, 0, w, h};
+	}
+
+	auto damaged = _damaged & region{0, 0, w, h};
+	_damaged = region{};
+
+	/* source rows of one thumbnail row, bands end on them to read them once */
+	int th = cairo_image_surface_get_height(_image);
+	int box = max(1, (h + th - 1) / th);
+
+	for(auto & r: damaged.rects()) {
+		int y = r.y;
+		int bottom = r.y + r.h;
+
+		while(y < bottom and budget > 0) {
+			int end = y + static_cast<int>(min<int64_t>(bottom - y,
+					max<int64_t>(box, budget / r.w)));
+			if(end < bottom)
+				end = min(bottom, max((end / box) * box, (y / box + 1) * box));
+			downscale(rect{r.x, y, r.w, end - y});
+			budget -= static_cast<int64_t>(r.w) * (end - y);
+			y = end;
+		}
+
+		if(y < bottom)
+			_damaged += region{r.x, y, r.w, bottom - y};
+	}
+
+	return _damaged.empty();
+}
+
+void thumbnail_cache_t::_thumbnail_t::downscale(rect const & damaged) {
+	box_downscale(_surface, _src_width, _src_height, _image, damaged,
+			_owner->_copy_buffer);
+}
+
+thumbnail_cache_t::thumbnail_cache_t() :
+	_ec{nullptr},
+	_timer{nullptr},
+	_is_scheduled{false}
+{
+
+}
+
+thumbnail_cache_t::~thumbnail_cache_t() {
+	clear();
+	if(_timer)
+		wl_event_source_remove(_timer);
+}
+
+void thumbnail_cache_t::start(weston_compositor * ec) {
+	_ec = ec;
+	_timer = wl_event_loop_add_timer(wl_display_get_event_loop(ec->wl_display),
+			[](void * data) -> int {
+		reinterpret_cast<thumbnail_cache_t *>(data)->_process();
+		return 0;
+	}, this);
+}
+
+void thumbnail_cache_t::_schedule(time64_t delay) {
+	if(_timer == nullptr)
+		return;
+
+	auto t = time64_t::now() + delay;
+	if(_is_scheduled and _scheduled_time <= t)
+		return;
+
+	_is_scheduled = true;
+	_scheduled_time = t;
+	/* 0 disarm the timer */
+	wl_event_source_timer_update(_timer, max<int64_t>(1L, static_cast<int64_t>(delay) / 1000000L));
+}
+
+void thumbnail_cache_t::_process() {
+	_is_scheduled = false;
+
+	auto now = time64_t::now();
+	int64_t budget = limits.budget;
+	int64_t next = -1;
+	vector<weston_surface *> updated;
+
+	for(auto & t: _lru) {
+		if(t->_damaged.empty())
+			continue;
+		if(now >= t->_last_request + _active_delay)
+			continue;
+
+		int64_t wait = t->_last_update + limits.min_interval - now;
+		if(wait > 0) {
+			next = (next < 0)?wait:min(next, wait);
+			continue;
+		}
+
+		if(budget <= 0) {
+			next = 0;
+			break;
+		}
+
+		/* large surfaces may need several iterations */
+		if(not t->refresh(budget)) {
+			next = 0;
+			break;
+		}
+
+		t->_last_update = now;
+		updated.push_back(t->_surface);
+	}
+
+	if(next >= 0)
+		_schedule(next);
+
+	/* handlers may request other thumbnails */
+	for(auto s: updated)
+		on_update.signal(s);
+}
+
+void thumbnail_cache_t::_remove(weston_surface * s) {
+	auto x = _thumbnails.find(s);
+	if(x == _thumbnails.end())
+		return;
+	_lru.erase(x->second);
+	_thumbnails.erase(x);
+}
+
+auto thumbnail_cache_t::get(weston_surface * s) -> cairo_surface_t * {
+	auto x = _thumbnails.find(s);
+	if(x != _thumbnails.end()) {
+		_lru.splice(_lru.begin(), _lru, x->second);
+	} else {
+		_lru.push_front(make_shared<_thumbnail_t>(this, s));
+		_thumbnails[s] = _lru.begin();
+		while(_lru.size() > static_cast<size_t>(max(1, limits.max_entries))) {
+			_thumbnails.erase(_lru.back()->_surface);
+			_lru.pop_back();
+		}
+	}
+
+	auto & t = _lru.front();
+	auto now = time64_t::now();
+	t->_last_request = now;
+	if(not t->_damaged.empty())
+		_schedule(max<int64_t>(0L, t->_last_update + limits.min_interval - now));
+	return t->_image;
+}
+
+void thumbnail_cache_t::clear() {
+	_thumbnails.clear();
+	_lru.clear();
+}
+
+}
@@ -0,0 +1,130 @@
+/*
+ * thumbnail_cache.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Keep downscaled copies of client surfaces for exposay and alt-tab. The
+ * thumbnails are refreshed from the commit damage in the main loop at a
+ * throttled rate, thus requesting a thumbnail never block.
+ *
+ */
+
+#ifndef SRC_THUMBNAIL_CACHE_HXX_
+#define SRC_THUMBNAIL_CACHE_HXX_
+
+#include <cairo/cairo.h>
+
+#include <memory>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <compositor.h>
+
+#include "utils.hxx"
+#include "region.hxx"
+#include "time.hxx"
+#include "listener.hxx"
+
+namespace page {
+
+using namespace std;
+
+struct thumbnail_limits_t {
+	/* largest dimension of a thumbnail in pixels */
+	int32_t max_size;
+	/* number of thumbnails kept */
+	int32_t max_entries;
+	/* minimum delay between two refresh of the same thumbnail */
+	time64_t min_interval;
+	/* source pixels read per main loop iteration, larger damages are
+	 * downscaled by row bands over several iterations */
+	int64_t budget;
+
+	thumbnail_limits_t() :
+		max_size{256},
+		max_entries{128},
+		min_interval{0.2},
+		budget{4L*1024L*1024L}
+	{ }
+
+};
+
+class thumbnail_cache_t {
+
+	struct _thumbnail_t {
+		thumbnail_cache_t * _owner;
+		weston_surface * _surface;
+
+		/* the downscaled copy, ARGB32 */
+		cairo_surface_t * _image;
+		int _src_width;
+		int _src_height;
+
+		/* in surface coordinates, not yet applied to _image */
+		region _damaged;
+		time64_t _last_update;
+		time64_t _last_request;
+
+		listener_t<weston_surface> on_commit;
+		listener_t<weston_surface> on_destroy;
+
+		_thumbnail_t(thumbnail_cache_t * owner, weston_surface * surface);
+		~_thumbnail_t();
+
+		void surface_commited(weston_surface * s);
+		void surface_destroyed(weston_surface * s);
+
+		bool refresh(int64_t & budget);
+		void downscale(rect const & damaged);
+
+	};
+
+	using _thumbnail_p = shared_ptr<_thumbnail_t>;
+
+	weston_compositor * _ec;
+	wl_event_source * _timer;
+	bool _is_scheduled;
+	time64_t _scheduled_time;
+
+	/* most recently requested first */
+	list<_thumbnail_p> _lru;
+	map<weston_surface *, list<_thumbnail_p>::iterator> _thumbnails;
+
+	/* reused between refresh to avoid allocation */
+	vector<uint8_t> _copy_buffer;
+
+	void _schedule(time64_t delay);
+	void _process();
+	void _remove(weston_surface * s);
+
+	thumbnail_cache_t(thumbnail_cache_t const &) = delete;
+	thumbnail_cache_t & operator=(thumbnail_cache_t const &) = delete;
+
+public:
+	thumbnail_limits_t limits;
+
+	/* emitted when the thumbnail of a surface has been refreshed */
+	signal_t<weston_surface *> on_update;
+
+	thumbnail_cache_t();
+	~thumbnail_cache_t();
+
+	void start(weston_compositor * ec);
+
+	/**
+	 * Return the current thumbnail of the surface and schedule its
+	 * refresh if it is out of date. The returned image may be nullptr or
+	 * outdated, on_update is emitted once it is refreshed. The image is
+	 * owned by the cache, reference it to keep it after the next get.
+	 **/
+	auto get(weston_surface * s) -> cairo_surface_t *;
+	void clear();
+
+};
+
+}
+
+#endif /* SRC_THUMBNAIL_CACHE_HXX_ */
@@ -21,7 +21,7 @@ namespace page {
 
 using namespace std;
 
-tiny_theme_t::tiny_theme_t(config_handler_t & conf) :
+tiny_theme_t::tiny_theme_t(simple_theme_config_t const & conf) :
 	simple2_theme_t{conf}
 {
 	notebook.tab_height = 15;
@@ -30,7 +30,7 @@ tiny_theme_t::tiny_theme_t(config_handler_t & conf) :
 	notebook.margin.left = 1;
 	notebook.margin.right = 1;
 
-	string conf_img_dir = conf.get_string("default", "theme_dir");
+	string conf_img_dir = conf.theme_dir;
 
 	{
 	cairo_surface_destroy(pop_button_s);
@@ -155,7 +155,7 @@ void tiny_theme_t::render_notebook(cairo_t * cr, theme_notebook_t const * n) con
 		cairo_save(cr);
 		cairo_clip(cr, tab_area);
 		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-		cairo_set_source_surface(cr, backgroun_px, -n->root_x, -n->root_y);
+		cairo_set_source_surface(cr, backgroun_px, background_x - n->root_x, background_y - n->root_y);
 		cairo_paint(cr);
 		cairo_restore(cr);
 
@@ -165,7 +165,7 @@ void tiny_theme_t::render_notebook(cairo_t * cr, theme_notebook_t const * n) con
 		cairo_save(cr);
 		cairo_clip(cr, body_area);
 		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-		cairo_set_source_surface(cr, backgroun_px, -n->root_x, -n->root_y);
+		cairo_set_source_surface(cr, backgroun_px, background_x - n->root_x, background_y - n->root_y);
 		cairo_paint(cr);
 		cairo_restore(cr);
 	} else {
@@ -219,7 +219,7 @@ void tiny_theme_t::render_notebook(cairo_t * cr, theme_notebook_t const * n) con
 			cairo_save(cr);
 			cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
 			if (backgroun_px != nullptr) {
-				cairo_set_source_surface(cr, backgroun_px, -n->root_x, -n->root_y);
+				cairo_set_source_surface(cr, backgroun_px, background_x - n->root_x, background_y - n->root_y);
 			} else {
 				cairo_set_source_color(cr, default_background_color);
 			}
@@ -449,7 +449,7 @@ void tiny_theme_t::render_notebook_selected(
 	cairo_clip(cr);
 
 	if(has_background) {
-		cairo_set_source_surface(cr, backgroun_px, -n.root_x, -n.root_y);
+		cairo_set_source_surface(cr, backgroun_px, background_x - n.root_x, background_y - n.root_y);
 	} else {
 		cairo_set_source_color(cr, default_background_color);
 	}
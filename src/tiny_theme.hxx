@@ -19,7 +19,7 @@
 #include "theme.hxx"
 #include "simple2_theme.hxx"
 #include "color.hxx"
-#include "config_handler.hxx"
+#include "page_config.hxx"
 #include "renderable.hxx"
 #include "pixmap.hxx"
 
@@ -58,7 +58,7 @@ class tiny_theme_t : public simple2_theme_t {
 	) const;
 
 public:
-	tiny_theme_t(config_handler_t & conf);
+	tiny_theme_t(simple_theme_config_t const & conf);
 	virtual ~tiny_theme_t();
 
 	virtual void render_notebook(cairo_t * cr, theme_notebook_t const * n) const;
@@ -10,6 +10,8 @@
 
 #include <memory>
 
+#include "lru_list.hxx"
+
 namespace page {
 
 using namespace std;
@@ -41,6 +43,12 @@ using notebook_w = weak_ptr<notebook_t>;
 class view_t;
 using view_p = shared_ptr<view_t>;
 using view_w = weak_ptr<view_t>;
+/* most recently focused first, linked through the view hooks */
+using focus_history_t = lru_list_t<view_t>;
+
+class workspace_switch_t;
+using workspace_switch_p = shared_ptr<workspace_switch_t>;
+using workspace_switch_w = weak_ptr<workspace_switch_t>;
 
 class xdg_shell_client_t;
 using xdg_shell_client_p = shared_ptr<xdg_shell_client_t>;
@@ -76,6 +76,10 @@ auto tree_t::get_node_name() const -> string {
 	return string { "RAW" };
 }
 
+auto tree_t::get_dump_name() const -> string {
+	return _get_dump_name<'R'>();
+}
+
 /**
  * Remove i from _direct_ child of this node *not recusively*
  **/
@@ -231,6 +235,24 @@ void tree_t::queue_redraw() {
 		_parent->queue_redraw();
 }
 
+/**
+ * Like queue_redraw, but only area, in the coordinates of the nearest back
+ * buffer, need to be redrawn.
+ **/
+void tree_t::queue_redraw_area(region const & area) {
+	if (_parent != nullptr)
+		_parent->queue_redraw_area(area);
+}
+
+/**
+ * Notify that the content shown by this node changed, workspace use it
+ * to drop cached snapshot.
+ **/
+void tree_t::invalidate_snapshot() {
+	if (_parent != nullptr)
+		_parent->invalidate_snapshot();
+}
+
 /**
  * Print the tree recursively using node names.
  **/
@@ -255,6 +277,13 @@ void tree_t::print_tree(int level) const {
 	}
 }
 
+void tree_t::dump_tree(FILE * f, int level) const {
+	fprintf(f, "%*s%s\n", level, "", get_dump_name().c_str());
+	for (auto i : children()) {
+		i->dump_tree(f, level + 1);
+	}
+}
+
 /**
  * Short cut to children(std::vector<tree_t *> & out)
  **/
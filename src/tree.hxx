@@ -10,6 +10,7 @@
 #ifndef TREE_HXX_
 #define TREE_HXX_
 
+#include <cstdio>
 #include <memory>
 #include <iostream>
 #include <map>
@@ -82,6 +83,11 @@ protected:
 		return xformat("%c(%ld) #%016lx #%016lx", c, shared_from_this().use_count(), _parent, (uintptr_t) this);
 	}
 
+	template<char const c>
+	string _get_dump_name() const {
+		return xformat("%c%s", c, _is_visible?"":" hidden");
+	}
+
 	/**
 	 * Parent must exist or beeing NULL, when a node is destroyed, he must
 	 * clear children _parent.
@@ -110,6 +116,8 @@ public:
 	bool is_visible() const;
 
 	void print_tree(int level = 0) const;
+	/* like print_tree without pointers nor counters, thus runs can be diffed */
+	void dump_tree(FILE * f, int level = 0) const;
 
 	vector<shared_ptr<tree_t>> children() const;
 	vector<shared_ptr<tree_t>> get_all_children() const;
@@ -140,6 +148,7 @@ public:
 	virtual void hide();
 	virtual void show();
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	virtual void remove(shared_ptr<tree_t> t);
 	virtual void clear();
 
@@ -166,6 +175,8 @@ public:
 	virtual auto get_parent_default_view() const -> weston_view *;
 	virtual rect get_window_position() const;
 	virtual void queue_redraw();
+	virtual void queue_redraw_area(region const & area);
+	virtual void invalidate_snapshot();
 
 	virtual auto get_default_view() const -> weston_view *;
 
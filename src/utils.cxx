@@ -7,6 +7,9 @@
 
 #include "utils.hxx"
 
+#include <unistd.h>
+#include <cerrno>
+
 namespace page {
 
 /**
@@ -74,5 +77,21 @@ void weston_surface_state_set_buffer(struct weston_surface_state *state,
 			      &state->buffer_destroy_listener);
 }
 
+bool eventfd_notify(int fd) {
+	uint64_t v = 1;
+	ssize_t n;
+	while((n = write(fd, &v, sizeof(v))) < 0 and errno == EINTR)
+		continue;
+	return n == sizeof(v);
+}
+
+bool eventfd_drain(int fd) {
+	uint64_t v;
+	ssize_t n;
+	while((n = read(fd, &v, sizeof(v))) < 0 and errno == EINTR)
+		continue;
+	return n == sizeof(v) or (n < 0 and errno == EAGAIN);
+}
+
 }
 
@@ -957,6 +957,14 @@ T * resource_get(wl_resource * r) {
 void weston_surface_state_set_buffer(struct weston_surface_state *state,
 				struct weston_buffer *buffer);
 
+/**
+ * Wake up the reader of an eventfd, or reset its counter once woken up.
+ * Both retry on EINTR, a drained non blocking eventfd is not an error.
+ * Return false on other errors.
+ **/
+bool eventfd_notify(int fd);
+bool eventfd_drain(int fd);
+
 inline double compute_ratio_to_fit(double src_width, double src_height,
 		double target_width, double target_height) {
 	double x_ratio = target_width / src_width;
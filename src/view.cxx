@@ -46,7 +46,15 @@ view_t::view_t(
 	_page_surface{xdg_surface},
 	_default_view{nullptr},
 	_has_keyboard_focus{false},
-	_has_change{true}
+	_has_change{true},
+	_has_sent_configure{false},
+	_sent_configure_width{0},
+	_sent_configure_height{0},
+	_is_configure_in_flight{false},
+	_has_deferred_configure{false},
+	_has_proxy_failed{false},
+	workspace_focus_hook{this},
+	global_focus_hook{this}
 {
 	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
 
@@ -83,6 +91,7 @@ view_t::view_t(
 
 view_t::~view_t() {
 	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
+	_proxy = nullptr;
 	if(_default_view) {
 		weston_view_destroy(_default_view);
 		_default_view = nullptr;
@@ -96,6 +105,8 @@ auto view_t::shared_from_this() -> view_p {
 void view_t::update_view() {
 	weston_log("call %s\n", __PRETTY_FUNCTION__);
 
+	invalidate_snapshot();
+
 	if (is(MANAGED_NOTEBOOK) or is(MANAGED_FULLSCREEN)) {
 		_wished_position = _notebook_wished_position;
 
@@ -125,8 +136,11 @@ void view_t::update_view() {
 		weston_view_set_position(_default_view, x, y);
 		weston_view_schedule_repaint(_default_view);
 
+		_update_proxy(ratio, x, y);
+
 	} else {
 		_wished_position = _floating_wished_position;
+		_proxy = nullptr;
 
 		if(_transform.link.next)
 			wl_list_remove(&_transform.link);
@@ -139,6 +153,49 @@ void view_t::update_view() {
 
 }
 
+/**
+ * The proxy hide the client underneath, thus the client must be fully
+ * opaque and must not have subsurfaces that the proxy would not show.
+ **/
+bool view_t::_can_use_proxy() const {
+	auto s = surface();
+	if(not _ctx->conf()._scaled_client_proxy or _has_proxy_failed)
+		return false;
+	if(s->width <= 0 or s->height <= 0 or not wl_list_empty(&s->subsurface_list))
+		return false;
+	pixman_box32_t box{0, 0, s->width, s->height};
+	return pixman_region32_contains_rectangle(&s->opaque, &box) == PIXMAN_REGION_IN;
+}
+
+void view_t::_update_proxy(double ratio, float x, float y) {
+	if(ratio >= 1.0 or not _can_use_proxy()) {
+		_proxy = nullptr;
+		return;
+	}
+
+	unsigned w = max(1, static_cast<int>(_page_surface->width() * ratio));
+	unsigned h = max(1, static_cast<int>(_page_surface->height() * ratio));
+
+	bool is_new = false;
+	if(_proxy == nullptr or not _proxy->match(w, h)) {
+		_proxy = make_shared<scaled_proxy_t>(_ctx, surface(), w, h);
+		if(not _proxy->is_valid()) {
+			weston_log("scaled proxy not available, fallback to transform\n");
+			_proxy = nullptr;
+			_has_proxy_failed = true;
+			return;
+		}
+		is_new = true;
+	}
+
+	weston_view_set_position(_proxy->view(), x, y);
+	weston_view_schedule_repaint(_proxy->view());
+
+	/* stack the new proxy over the client */
+	if(is_new)
+		_ctx->sync_tree_view();
+}
+
 void view_t::reconfigure() {
 
 	if (is(MANAGED_NOTEBOOK) or is(MANAGED_FULLSCREEN)) {
@@ -159,13 +216,44 @@ void view_t::reconfigure() {
 		state.insert(XDG_SURFACE_STATE_ACTIVATED);
 	}
 
+	update_view();
+
+	if(_has_sent_configure
+			and _sent_configure_width == _wished_position.w
+			and _sent_configure_height == _wished_position.h
+			and _sent_configure_state == state) {
+		_has_deferred_configure = false;
+		return;
+	}
+
+	if(_is_configure_in_flight) {
+		_has_deferred_configure = true;
+		return;
+	}
+
 	_page_surface->send_configure(_wished_position.w,
 			_wished_position.h, state);
 
-	update_view();
+	_has_sent_configure = true;
+	_sent_configure_width = _wished_position.w;
+	_sent_configure_height = _wished_position.h;
+	_sent_configure_state = state;
+	_has_deferred_configure = false;
+	/* surfaces without ack cannot be paced */
+	_is_configure_in_flight = _page_surface->has_pending_configure();
 
 }
 
+void view_t::configure_commited() {
+	_is_configure_in_flight = false;
+	if(_has_deferred_configure)
+		reconfigure();
+}
+
+bool view_t::is_configure_pending() const {
+	return _is_configure_in_flight or _has_deferred_configure;
+}
+
 
 void view_t::set_managed_type(managed_window_type_e type)
 {
@@ -204,6 +292,13 @@ string view_t::get_node_name() const {
 	return oss.str();
 }
 
+string view_t::get_dump_name() const {
+	ostringstream oss;
+	oss << _get_dump_name<'T'>() << " type = " << static_cast<int>(_managed_type)
+			<< " " << title();
+	return oss.str();
+}
+
 void view_t::update_layout(time64_t const time) {
 	if(not _is_visible)
 		return;
@@ -304,6 +399,10 @@ auto view_t::get_default_view() const -> weston_view * {
 	return _default_view;
 }
 
+auto view_t::get_proxy_view() const -> weston_view * {
+	return _proxy?_proxy->view():nullptr;
+}
+
 weston_surface * view_t::surface() const {
 	return _page_surface->surface();
 }
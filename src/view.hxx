@@ -12,6 +12,7 @@
 #include "page_context.hxx"
 #include "listener.hxx"
 #include "surface.hxx"
+#include "scaled_proxy.hxx"
 
 namespace page {
 
@@ -65,11 +66,36 @@ class view_t : public tree_t {
 	bool _has_change;
 	bool _has_keyboard_focus;
 
+	/* last configure sent, identical configures are not sent again */
+	bool _has_sent_configure;
+	int32_t _sent_configure_width;
+	int32_t _sent_configure_height;
+	set<uint32_t> _sent_configure_state;
+
+	/**
+	 * Only one configure is in flight until the client commit its reply,
+	 * newer configures are merged and sent after it. This avoid flooding
+	 * slow clients while the layout is changing continuously.
+	 **/
+	bool _is_configure_in_flight;
+	bool _has_deferred_configure;
+
+	/* shown instead of the client when it is scaled down to fit */
+	scaled_proxy_p _proxy;
+	bool _has_proxy_failed;
+
+	void _update_proxy(double ratio, float x, float y);
+	bool _can_use_proxy() const;
+
 public:
 
 	signal_t<view_t*> focus_change;
 	signal_t<view_t*> title_change;
 
+	/* links in the focus history of a workspace and in the global one */
+	lru_hook_t<view_t> workspace_focus_hook;
+	lru_hook_t<view_t> global_focus_hook;
+
 	void add_transient_child(view_p c);
 	virtual void add_popup_child(view_p child, int x, int y);
 
@@ -100,6 +126,11 @@ public:
 	void set_focus_state(bool is_focused);
 	void set_managed_type(managed_window_type_e type);
 
+	/* the client has committed its reply to the last configure */
+	void configure_commited();
+	/* true while the client has not caught up with the wished size */
+	bool is_configure_pending() const;
+
 	void send_close();
 
 	/**
@@ -109,6 +140,7 @@ public:
 	virtual void hide();
 	virtual void show();
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	// virtual void remove(shared_ptr<tree_t> t);
 
 	// virtual void children(vector<shared_ptr<tree_t>> & out) const;
@@ -137,6 +169,9 @@ public:
 	virtual void trigger_redraw();
 	virtual auto get_default_view() const -> weston_view *;
 
+	/* view to stack over the default view, nullptr if none */
+	auto get_proxy_view() const -> weston_view *;
+
 	/**
 	 * client base API
 	 **/
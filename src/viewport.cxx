@@ -11,6 +11,7 @@
 #include <typeinfo>
 #include "notebook.hxx"
 #include "viewport.hxx"
+#include "render_worker.hxx"
 
 namespace page {
 
@@ -22,6 +23,10 @@ viewport_t::viewport_t(page_context_t * ctx, rect const & area,
 		_raw_aera{area},
 		_effective_area{area},
 		_is_durty{true},
+		_has_job_in_flight{false},
+		_is_covered{false},
+		_backdrop_surface{nullptr},
+		_backdrop_view{nullptr},
 		//_win{XCB_NONE},
 		_back_surf{nullptr},
 		_exposed{false},
@@ -35,9 +40,6 @@ viewport_t::viewport_t(page_context_t * ctx, rect const & area,
 	_subtree->set_parent(this);
 	_subtree->set_allocation(_page_area);
 
-	_backbround_surface = nullptr;
-	_default_view = nullptr;
-
 	/** create the solid color background **/
 //	_backbround_surface = weston_surface_create(ctx->ec);
 //	weston_surface_set_color(_backbround_surface, 1.0f, 0.0f, 0.0f, 0.1f);
@@ -54,13 +56,12 @@ viewport_t::viewport_t(page_context_t * ctx, rect const & area,
 //	weston_view_set_position(_default_view, area.x, area.y);
 //	weston_view_geometry_dirty(_default_view);
 
-	_pix = _ctx->create_pixmap(area.w, area.h);
-	_pix_on_ack_buffer = _pix->on_ack_buffer.connect(this,
-			&viewport_t::_on_ack_buffer);
+	/* the back buffer is acquired on show */
 
 }
 
 viewport_t::~viewport_t() {
+	set_covered(false);
 	destroy_renderable();
 	//xcb_destroy_window(_ctx->dpy()->xcb(), _win);
 	//_win = XCB_NONE;
@@ -102,6 +103,66 @@ rect const & viewport_t::raw_area() const {
 	return _raw_aera;
 }
 
+/**
+ * While a fullscreen client cover the viewport the decorations are not
+ * redrawn, pending redraws are done when the viewport is uncovered. A black
+ * backdrop is stacked under the client, as the views underneath are removed
+ * from the scene graph.
+ **/
+void viewport_t::set_covered(bool covered) {
+	if(_is_covered == covered) {
+		/* the output may have been resized */
+		if(_backdrop_view)
+			_update_backdrop();
+		return;
+	}
+
+	_is_covered = covered;
+
+	if(_is_covered) {
+		/* the in flight rendering would be committed under the client */
+		if(_has_job_in_flight) {
+			_ctx->render_worker()->cancel(this);
+			_has_job_in_flight = false;
+			_is_durty = true;
+		}
+
+		_backdrop_surface = weston_surface_create(_ctx->ec);
+		weston_surface_set_color(_backdrop_surface, 0.0f, 0.0f, 0.0f, 1.0f);
+		/* input go to the fullscreen client only */
+		pixman_region32_fini(&_backdrop_surface->input);
+		pixman_region32_init(&_backdrop_surface->input);
+		_backdrop_view = weston_view_create(_backdrop_surface);
+		_update_backdrop();
+	} else {
+		/* the view is destroyed with its surface */
+		if(_backdrop_surface)
+			weston_surface_destroy(_backdrop_surface);
+		_backdrop_surface = nullptr;
+		_backdrop_view = nullptr;
+
+		if(_is_durty or not _partial_damage.empty())
+			_ctx->schedule_repaint();
+	}
+}
+
+void viewport_t::_update_backdrop() {
+	weston_surface_set_size(_backdrop_surface, _raw_aera.w, _raw_aera.h);
+	pixman_region32_fini(&_backdrop_surface->opaque);
+	pixman_region32_init_rect(&_backdrop_surface->opaque, 0, 0,
+			_raw_aera.w, _raw_aera.h);
+	weston_view_set_position(_backdrop_view, _raw_aera.x, _raw_aera.y);
+	weston_view_geometry_dirty(_backdrop_view);
+}
+
+bool viewport_t::is_covered() const {
+	return _is_covered;
+}
+
+auto viewport_t::get_backdrop_view() const -> weston_view * {
+	return _backdrop_view;
+}
+
 void viewport_t::activate() {
 	if(_parent != nullptr) {
 		_parent->activate(shared_from_this());
@@ -121,6 +182,10 @@ string viewport_t::get_node_name() const {
 	return _get_node_name<'V'>();
 }
 
+string viewport_t::get_dump_name() const {
+	return _get_dump_name<'V'>() + " " + _effective_area.to_string();
+}
+
 void viewport_t::update_layout(time64_t const time) {
 
 }
@@ -164,13 +229,60 @@ void viewport_t::show() {
 
 void viewport_t::destroy_renderable() {
 	_back_surf = nullptr;
+
+	if(_buffer == nullptr)
+		return;
+
+	/* the in flight rendering target the released buffer */
+	_ctx->render_worker()->cancel(this);
+	_has_job_in_flight = false;
+	_diverged.clear();
+
+	_buffer_on_ready = nullptr;
+	_ctx->release_viewport_buffer(_buffer);
+	_buffer = nullptr;
+}
+
+/* decorations are drawn at the output resolution, not resampled by weston */
+unsigned viewport_t::_buffer_scale() const {
+	if(_output == nullptr)
+		return 1;
+	return max(1, _output->current_scale);
+}
+
+/* nullptr until the wallpaper engine has scaled it for this output */
+auto viewport_t::_wallpaper() const -> wallpaper_image_p {
+	return _ctx->wallpaper()->get(_raw_aera.w, _raw_aera.h, _buffer_scale());
+}
+
+bool viewport_t::wants_buffer(unsigned width, unsigned height, unsigned scale) const {
+	auto s = _buffer_scale();
+	return scale == s and width == _effective_area.w * s
+			and height == _effective_area.h * s;
 }
 
 void viewport_t::update_renderable() {
-//	if(_ctx->cmp() != nullptr) {
-//		_back_surf = make_shared<pixmap_t>(PIXMAP_RGB, _page_area.w, _page_area.h);
-//	}
-	//_ctx->dpy()->move_resize(_win, _effective_area);
+	if(not _is_visible)
+		return;
+
+	auto scale = _buffer_scale();
+	if(_buffer != nullptr and wants_buffer(_buffer->width(),
+			_buffer->height(), _buffer->scale())) {
+		if(_buffer->is_ready()) {
+			weston_view_set_position(_buffer->view(), _effective_area.x, _effective_area.y);
+			weston_view_geometry_dirty(_buffer->view());
+		}
+		queue_redraw();
+		return;
+	}
+
+	destroy_renderable();
+	_buffer = _ctx->acquire_viewport_buffer(_effective_area.w * scale,
+			_effective_area.h * scale, scale);
+	_buffer_on_ready = _buffer->on_ready.connect(this,
+			&viewport_t::_on_buffer_ready);
+	if(_buffer->is_ready())
+		_on_buffer_ready(_buffer.get());
 }
 
 void viewport_t::create_window() {
@@ -225,13 +337,58 @@ void viewport_t::create_window() {
 void viewport_t::_redraw_back_buffer() {
 	//weston_log("call %s\n", __PRETTY_FUNCTION__);
 
-	if(_pix->get_cairo_surface() == nullptr)
+	if(_buffer == nullptr or not _buffer->is_ready())
+		return;
+
+	/* nothing is visible, keep the pending redraw for later */
+	if(_is_covered)
+		return;
+
+	if(not _is_durty) {
+		if(not _partial_damage.empty())
+			_redraw_partial();
 		return;
+	}
+
+	_partial_damage.clear();
+
+	auto splits = filter_class<split_t>(get_all_children());
+	auto notebooks = filter_class<notebook_t>(get_all_children());
 
-	if(not _is_durty)
+	/* exposay draw live thumbnails, keep it in the main loop */
+	bool has_exposay = any_of(notebooks.begin(), notebooks.end(),
+			[](notebook_p const & x) { return x->has_exposay(); });
+
+	auto worker = _ctx->render_worker();
+	if(worker->is_running() and not has_exposay) {
+		auto job = make_shared<render_job_t>();
+		job->owner = this;
+		job->width = _buffer->width();
+		job->height = _buffer->height();
+		job->scale = _buffer->scale();
+		for (auto x : splits)
+			job->splits.push_back(x->get_theme_split());
+		for (auto x : notebooks)
+			job->notebooks.push_back(x->get_render_state());
+		job->background = _wallpaper();
+		job->background_x = _raw_aera.x;
+		job->background_y = _raw_aera.y;
+		job->on_done = [this](cairo_surface_t * image, region const & damaged) {
+			_on_render_done(image, damaged);
+		};
+		worker->submit(job);
+		_has_job_in_flight = true;
+		_is_durty = false;
 		return;
+	}
+
+	/* the worker may have a pending job for an older layout */
+	worker->cancel(this);
+	_has_job_in_flight = false;
+	_diverged.clear();
 
-	cairo_t * cr = cairo_create(_pix->get_cairo_surface());
+	auto const & pix = _buffer->pixmap();
+	cairo_t * cr = cairo_create(pix->get_cairo_surface());
 	if(cairo_status(cr)) {
 		weston_log("XXX %s\n", cairo_status_to_string(cairo_status(cr)));
 	}
@@ -243,28 +400,149 @@ void viewport_t::_redraw_back_buffer() {
 	cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
 	cairo_paint(cr);
 
-	auto splits = filter_class<split_t>(get_all_children());
+	auto wallpaper = _wallpaper();
+	_ctx->set_theme_background(wallpaper.get(), _raw_aera.x, _raw_aera.y);
+
 	for (auto x : splits) {
 		x->render_legacy(cr);
 	}
 
-	auto notebooks = filter_class<notebook_t>(get_all_children());
 	for (auto x : notebooks) {
 		x->render_legacy(cr);
 	}
 
-	cairo_surface_flush(_pix->get_cairo_surface());
+	_ctx->set_theme_background(nullptr, 0, 0);
+
+	cairo_surface_flush(pix->get_cairo_surface());
 	warn(cairo_get_reference_count(cr) == 1);
 	cairo_destroy(cr);
 
 	_is_durty = false;
+	_commit_back_buffer(region{_page_area});
+
+}
+
+/**
+ * Redraw only the damaged part of the back buffer in the main loop, e.g.
+ * a tab title. Only the notebooks tabs under the damage are drawn.
+ **/
+void viewport_t::_redraw_partial() {
+	auto damaged = _partial_damage & region{_page_area};
+	_partial_damage.clear();
+	if(damaged.empty())
+		return;
+
+	auto splits = filter_class<split_t>(get_all_children());
+	auto notebooks = filter_class<notebook_t>(get_all_children());
+
+	/* exposay thumbnails are only drawn by the full redraw */
+	if(any_of(notebooks.begin(), notebooks.end(),
+			[](notebook_p const & x) { return x->has_exposay(); })) {
+		_is_durty = true;
+		_redraw_back_buffer();
+		return;
+	}
+
+	auto const & pix = _buffer->pixmap();
+	cairo_t * cr = cairo_create(pix->get_cairo_surface());
+	cairo_identity_matrix(cr);
+	for (auto & r : damaged.rects())
+		cairo_rectangle(cr, r.x, r.y, r.w, r.h);
+	cairo_clip(cr);
+
+	cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+	cairo_paint(cr);
+
+	auto wallpaper = _wallpaper();
+	_ctx->set_theme_background(wallpaper.get(), _raw_aera.x, _raw_aera.y);
+
+	for (auto x : splits) {
+		if(not (damaged & region{x->allocation()}).empty())
+			x->render_legacy(cr);
+	}
+
+	for (auto x : notebooks) {
+		if((damaged & region{x->allocation()}).empty())
+			continue;
+		auto state = x->get_render_state();
+		/* shaping tab titles is the expensive part, skip hidden tabs */
+		vector<theme_tab_t> tabs;
+		for (auto & t : state.tabs) {
+			rect pos = t.position;
+			pos.x += state.tabs_area.x - state.tabs_offset;
+			pos.y += state.tabs_area.y;
+			if(not (damaged & region{pos & state.tabs_area}).empty())
+				tabs.push_back(t);
+		}
+		state.tabs = tabs;
+		render_worker_t::render_notebook(_ctx->theme(), cr, state);
+	}
+
+	_ctx->set_theme_background(nullptr, 0, 0);
+
+	cairo_surface_flush(pix->get_cairo_surface());
+	warn(cairo_get_reference_count(cr) == 1);
+	cairo_destroy(cr);
+
+	/* the next worker result is not compared to this content */
+	_diverged += damaged;
+	_commit_back_buffer(damaged);
+}
+
+/**
+ * Only the area that changed since the previous result, or that the main
+ * loop drew since, is copied into the back buffer and damaged.
+ **/
+void viewport_t::_on_render_done(cairo_surface_t * image, region const & changed) {
+	_has_job_in_flight = false;
+	if(_buffer == nullptr or not _buffer->is_ready()
+			or cairo_image_surface_get_width(image) != static_cast<int>(_buffer->width())
+			or cairo_image_surface_get_height(image) != static_cast<int>(_buffer->height())) {
+		/* the worker reference do not match the buffer anymore */
+		_ctx->render_worker()->cancel(this);
+		queue_redraw();
+		return;
+	}
+
+	auto damaged = (changed + _diverged) & region{_page_area};
+	_diverged.clear();
+	if(damaged.empty())
+		return;
+
+	auto surf = _buffer->pixmap()->get_cairo_surface();
+	cairo_t * cr = cairo_create(surf);
+	for (auto & r : damaged.rects())
+		cairo_rectangle(cr, r.x, r.y, r.w, r.h);
+	cairo_clip(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface(cr, image, 0.0, 0.0);
+	cairo_paint(cr);
+	cairo_surface_flush(surf);
+	warn(cairo_get_reference_count(cr) == 1);
+	cairo_destroy(cr);
+	_commit_back_buffer(damaged);
+}
+
+/* damaged is in back buffer coordinates */
+void viewport_t::_commit_back_buffer(region const & damaged) {
 	_exposed = true;
-	_damaged += _effective_area;
+	auto root_damaged = damaged;
+	root_damaged.translate(_effective_area.x, _effective_area.y);
+	_damaged += root_damaged;
+	invalidate_snapshot();
 
-	(*_ctx->ec->renderer->attach)(_backbround_surface, _pix->wbuffer());
-	weston_surface_damage(_pix->wsurface());
-	(*_ctx->ec->renderer->flush_damage)(_backbround_surface);
+	/* let weston skip blending and views underneath opaque areas */
+	auto opaque = get_opaque_region();
+	opaque.translate(-_effective_area.x, -_effective_area.y);
+	_buffer->pixmap()->set_opaque_region(opaque);
 
+	(*_ctx->ec->renderer->attach)(_buffer->surface(), _buffer->pixmap()->wbuffer());
+	/* surface damage is in surface coordinates, i.e. logical pixels */
+	auto s = _buffer->surface();
+	for (auto & r : damaged.rects())
+		pixman_region32_union_rect(&s->damage, &s->damage, r.x, r.y, r.w, r.h);
+	weston_surface_schedule_repaint(s);
+	(*_ctx->ec->renderer->flush_damage)(s);
 }
 
 void viewport_t::trigger_redraw() {
@@ -285,6 +563,20 @@ void viewport_t::queue_redraw() {
 	_ctx->schedule_repaint();
 }
 
+void viewport_t::queue_redraw_area(region const & area) {
+	/* a pending full redraw already cover it */
+	if(_is_durty)
+		return;
+
+	if(_has_job_in_flight) {
+		queue_redraw();
+		return;
+	}
+
+	_partial_damage += area;
+	_ctx->schedule_repaint();
+}
+
 region viewport_t::get_damaged() {
 	return _damaged;
 }
@@ -366,33 +658,21 @@ auto viewport_t::get_output() const -> weston_output * {
 }
 
 auto viewport_t::get_default_view() const -> weston_view * {
-	return _default_view;
+	if(_buffer == nullptr)
+		return nullptr;
+	return _buffer->view();
 }
 
-void viewport_t::_on_ack_buffer(pixmap_t * p) {
-	assert(_pix.get() == p);
-
-	_backbround_surface = _pix->wsurface();
-//	pixman_region32_fini(&_backbround_surface->opaque);
-//	pixman_region32_init_rect(&_backbround_surface->opaque, 0, 0,
-//			_effective_area.w, _effective_area.h);
-//	pixman_region32_fini(&_backbround_surface->input);
-//	pixman_region32_init_rect(&_backbround_surface->input, 0, 0,
-//			_effective_area.w, _effective_area.h);
-	weston_surface_set_role(_backbround_surface, "page_viewport",
-			nullptr, 0);
-	weston_surface_damage(_backbround_surface);
+void viewport_t::_on_buffer_ready(viewport_buffer_t * b) {
+	assert(_buffer.get() == b);
 
-	_backbround_surface->timeline.force_refresh = 1;
-	_default_view = weston_view_create(_backbround_surface);
-	weston_view_set_position(_default_view, _effective_area.x, _effective_area.y);
-	//weston_view_set_mask_infinite(_default_view);
-	weston_view_geometry_dirty(_default_view);
+	/* the buffer may come from another workspace, always redraw it */
+	weston_view_set_position(_buffer->view(), _effective_area.x, _effective_area.y);
+	weston_view_geometry_dirty(_buffer->view());
 
 	queue_redraw();
 	_ctx->sync_tree_view();
 
-
 }
 
 }
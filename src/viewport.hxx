@@ -19,6 +19,8 @@
 #include "page_context.hxx"
 #include "page_component.hxx"
 #include "notebook.hxx"
+#include "viewport_buffer.hxx"
+#include "wallpaper.hxx"
 
 namespace page {
 
@@ -34,12 +36,25 @@ class viewport_t: public page_component_t {
 
 	bool _is_durty;
 	bool _exposed;
+	/* the worker may overwrite the back buffer with an older layout */
+	bool _has_job_in_flight;
+	/* area of the back buffer to redraw when not fully durty */
+	region _partial_damage;
+	/* area drawn by the main loop since the last worker result */
+	region _diverged;
+	/* a fullscreen client cover the viewport, decorations are not drawn */
+	bool _is_covered;
+
+	/* black opaque surface under the fullscreen client */
+	weston_surface * _backdrop_surface;
+	weston_view * _backdrop_view;
 
 	/** rendering tabs is time consuming, thus use back buffer **/
 	cairo_surface_t * _back_surf;
 
-	pixmap_p _pix;
-	signal_handler_t _pix_on_ack_buffer;
+	/* only available while visible, shared with other workspaces */
+	viewport_buffer_p _buffer;
+	signal_handler_t _buffer_on_ready;
 
 	/** area without considering dock windows **/
 	rect _raw_aera;
@@ -52,8 +67,6 @@ class viewport_t: public page_component_t {
 	shared_ptr<page_component_t> _subtree;
 
 	weston_output * _output;
-	weston_surface * _backbround_surface;
-	weston_view * _default_view;
 
 	viewport_t(viewport_t const & v) = delete;
 	viewport_t & operator= (viewport_t const &) = delete;
@@ -66,9 +79,15 @@ class viewport_t: public page_component_t {
 	void update_renderable();
 	void create_window();
 	void _redraw_back_buffer();
+	void _redraw_partial();
 	void paint_expose();
 
-	void _on_ack_buffer(pixmap_t * p);
+	void _on_buffer_ready(viewport_buffer_t * b);
+	void _on_render_done(cairo_surface_t * image, region const & changed);
+	void _commit_back_buffer(region const & damaged);
+	void _update_backdrop();
+	unsigned _buffer_scale() const;
+	auto _wallpaper() const -> wallpaper_image_p;
 
 public:
 
@@ -78,6 +97,13 @@ public:
 	auto raw_area() const -> rect const &;
 	void set_raw_area(rect const & area);
 
+	/* true if the back buffer of this viewport has this size */
+	bool wants_buffer(unsigned width, unsigned height, unsigned scale) const;
+
+	void set_covered(bool covered);
+	bool is_covered() const;
+	auto get_backdrop_view() const -> weston_view *;
+
 	/**
 	 * tree_t virtual API
 	 **/
@@ -85,6 +111,7 @@ public:
 	virtual void hide();
 	virtual void show();
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	virtual void remove(shared_ptr<tree_t> t);
 
 	virtual void append_children(vector<shared_ptr<tree_t>> & out) const;
@@ -110,6 +137,7 @@ public:
 	//virtual auto get_parent_xid() const -> xcb_window_t;
 	virtual rect get_window_position() const;
 	virtual void queue_redraw();
+	virtual void queue_redraw_area(region const & area);
 
 	virtual auto get_default_view() const -> weston_view *;
 
@@ -0,0 +1,99 @@
+/*
+ * viewport_buffer.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "viewport_buffer.hxx"
+
+#include <cassert>
+
+namespace page {
+
+using namespace std;
+
+viewport_buffer_t::viewport_buffer_t(page_context_t * ctx, unsigned width,
+		unsigned height, unsigned scale) :
+	_ctx{ctx},
+	_surface{nullptr},
+	_view{nullptr},
+	_is_used{false}
+{
+	/* the back buffer is always fully painted */
+	_pix = _ctx->create_pixmap(width, height, PIXMAP_RGB, scale);
+	_pix_on_ack_buffer = _pix->on_ack_buffer.connect(this,
+			&viewport_buffer_t::_on_ack_buffer);
+	/* local pixmaps are ready at creation, no ack will come */
+	if(_pix->is_ready())
+		_on_ack_buffer(_pix.get());
+}
+
+viewport_buffer_t::~viewport_buffer_t() {
+	if(_view) {
+		weston_view_destroy(_view);
+		_view = nullptr;
+	}
+}
+
+void viewport_buffer_t::_on_ack_buffer(pixmap_t * p) {
+	assert(_pix.get() == p);
+
+	_surface = _pix->wsurface();
+	weston_surface_set_role(_surface, "page_viewport", nullptr, 0);
+	weston_surface_damage(_surface);
+
+	_surface->timeline.force_refresh = 1;
+	_view = weston_view_create(_surface);
+
+	on_ready.signal(this);
+}
+
+unsigned viewport_buffer_t::width() const {
+	return _pix->witdh();
+}
+
+unsigned viewport_buffer_t::height() const {
+	return _pix->height();
+}
+
+unsigned viewport_buffer_t::scale() const {
+	return _pix->scale();
+}
+
+bool viewport_buffer_t::is_ready() const {
+	return _view != nullptr;
+}
+
+bool viewport_buffer_t::is_used() const {
+	return _is_used;
+}
+
+void viewport_buffer_t::acquire() {
+	_is_used = true;
+}
+
+void viewport_buffer_t::release() {
+	_is_used = false;
+	/* the next user will place it, do not show the old content meanwhile */
+	if(_view) {
+		weston_view_damage_below(_view);
+		weston_layer_entry_remove(&_view->layer_link);
+	}
+}
+
+auto viewport_buffer_t::pixmap() const -> pixmap_p const & {
+	return _pix;
+}
+
+auto viewport_buffer_t::surface() const -> weston_surface * {
+	return _surface;
+}
+
+auto viewport_buffer_t::view() const -> weston_view * {
+	return _view;
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * viewport_buffer.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#ifndef SRC_VIEWPORT_BUFFER_HXX_
+#define SRC_VIEWPORT_BUFFER_HXX_
+
+#include <memory>
+
+#include <compositor.h>
+
+#include "utils.hxx"
+#include "pixmap.hxx"
+#include "page_context.hxx"
+
+namespace page {
+
+using namespace std;
+
+/**
+ * Back buffer of a viewport, with its surface and view.
+ *
+ * Only viewports of the current workspace are visible, thus buffers are
+ * pooled by page and given to viewports on show, instead of keeping one
+ * full screen buffer per workspace and output.
+ **/
+class viewport_buffer_t {
+	page_context_t * _ctx;
+
+	pixmap_p _pix;
+	signal_handler_t _pix_on_ack_buffer;
+
+	weston_surface * _surface;
+	weston_view * _view;
+
+	bool _is_used;
+
+	viewport_buffer_t(viewport_buffer_t const &) = delete;
+	viewport_buffer_t & operator=(viewport_buffer_t const &) = delete;
+
+	void _on_ack_buffer(pixmap_t * p);
+
+public:
+
+	/* emitted once the buffer is available from the buffer manager */
+	signal_t<viewport_buffer_t *> on_ready;
+
+	/* width and height in buffer pixels */
+	viewport_buffer_t(page_context_t * ctx, unsigned width, unsigned height, unsigned scale);
+	~viewport_buffer_t();
+
+	unsigned width() const;
+	unsigned height() const;
+	unsigned scale() const;
+
+	bool is_ready() const;
+	bool is_used() const;
+	void acquire();
+	void release();
+
+	auto pixmap() const -> pixmap_p const &;
+	auto surface() const -> weston_surface *;
+	auto view() const -> weston_view *;
+
+};
+
+using viewport_buffer_p = shared_ptr<viewport_buffer_t>;
+using viewport_buffer_w = weak_ptr<viewport_buffer_t>;
+
+}
+
+#endif /* SRC_VIEWPORT_BUFFER_HXX_ */
@@ -0,0 +1,530 @@
+/*
+ * wallpaper.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "config.hxx"
+
+#include "wallpaper.hxx"
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <csetjmp>
+#include <algorithm>
+#include <vector>
+
+#include <glib.h>
+#include <compositor.h>
+
+#ifdef HAVE_JPEG
+#include <jpeglib.h>
+#endif
+
+namespace page {
+
+using namespace std;
+
+/* images of outputs no longer in use are dropped past this count */
+static size_t const _max_images = 8;
+
+/* cache files are a header followed by the RGB24 image data */
+static char const _cache_magic[8] = {'P', 'A', 'G', 'E', 'W', 'P', '0', '1'};
+static size_t const _cache_data_offset = 64;
+
+struct _cache_header_t {
+	char magic[8];
+	int32_t width;
+	int32_t height;
+	int32_t stride;
+};
+
+/* mapping released with the last reference of the image */
+struct _cache_mapping_t {
+	void * addr;
+	size_t size;
+};
+
+static cairo_user_data_key_t const _cache_mapping_key = { };
+
+struct _png_reader_t {
+	string const * data;
+	size_t offset;
+};
+
+static cairo_status_t _read_png(void * closure, unsigned char * out,
+		unsigned int length) {
+	auto reader = reinterpret_cast<_png_reader_t *>(closure);
+	if(reader->data->size() - reader->offset < length)
+		return CAIRO_STATUS_READ_ERROR;
+	memcpy(out, reader->data->data() + reader->offset, length);
+	reader->offset += length;
+	return CAIRO_STATUS_SUCCESS;
+}
+
+#ifdef HAVE_JPEG
+
+/* libjpeg call exit() on error by default */
+struct _jpeg_error_t {
+	jpeg_error_mgr mgr;
+	jmp_buf jump;
+};
+
+static void _jpeg_error_exit(j_common_ptr cinfo) {
+	longjmp(reinterpret_cast<_jpeg_error_t *>(cinfo->err)->jump, 1);
+}
+
+/* nothing with a destructor must live here, longjmp skip them */
+static auto _decode_jpeg(string const & data) -> cairo_surface_t * {
+	jpeg_decompress_struct cinfo;
+	_jpeg_error_t err;
+	cairo_surface_t * volatile image = nullptr;
+
+	cinfo.err = jpeg_std_error(&err.mgr);
+	err.mgr.error_exit = &_jpeg_error_exit;
+	if(setjmp(err.jump)) {
+		jpeg_destroy_decompress(&cinfo);
+		if(image)
+			cairo_surface_destroy(image);
+		return nullptr;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, reinterpret_cast<unsigned char *>(const_cast<char *>(data.data())), data.size());
+	jpeg_read_header(&cinfo, TRUE);
+	cinfo.out_color_space = JCS_RGB;
+	jpeg_start_decompress(&cinfo);
+
+	image = cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+			cinfo.output_width, cinfo.output_height);
+	if(cairo_surface_status(image) != CAIRO_STATUS_SUCCESS) {
+		jpeg_destroy_decompress(&cinfo);
+		cairo_surface_destroy(image);
+		return nullptr;
+	}
+
+	/* freed by jpeg_destroy_decompress */
+	JSAMPARRAY row = (*cinfo.mem->alloc_sarray)(reinterpret_cast<j_common_ptr>(&cinfo),
+			JPOOL_IMAGE, cinfo.output_width * 3, 1);
+
+	cairo_surface_flush(image);
+	uint8_t * pixels = cairo_image_surface_get_data(image);
+	int stride = cairo_image_surface_get_stride(image);
+	while(cinfo.output_scanline < cinfo.output_height) {
+		auto out = reinterpret_cast<uint32_t *>(pixels + cinfo.output_scanline * stride);
+		jpeg_read_scanlines(&cinfo, row, 1);
+		JSAMPROW src = row[0];
+		for(unsigned x = 0; x < cinfo.output_width; ++x)
+			out[x] = (src[x*3+0] << 16) | (src[x*3+1] << 8) | src[x*3+2];
+	}
+	cairo_surface_mark_dirty(image);
+
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+	return image;
+}
+
+#endif
+
+wallpaper_t::wallpaper_t() :
+	_stop{false},
+	_serial{0},
+	_notify_fd{-1},
+	_source{nullptr}
+{
+	char const * cache = getenv("XDG_CACHE_HOME");
+	char const * home = getenv("HOME");
+	if(cache != nullptr and cache[0] != '\0')
+		_cache_dir = string{cache} + "/page/wallpapers";
+	else if(home != nullptr)
+		_cache_dir = string{home} + "/.cache/page/wallpapers";
+}
+
+wallpaper_t::~wallpaper_t() {
+	stop();
+}
+
+void wallpaper_t::start(wl_event_loop * loop) {
+	stop();
+
+	_notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if(_notify_fd < 0)
+		return;
+
+	_source = wl_event_loop_add_fd(loop, _notify_fd, WL_EVENT_READABLE,
+			[](int fd, uint32_t mask, void * data) -> int {
+		reinterpret_cast<wallpaper_t *>(data)->_dispatch();
+		return 0;
+	}, this);
+
+	_stop = false;
+	_thread = thread{&wallpaper_t::_run, this};
+}
+
+void wallpaper_t::stop() {
+	if(_thread.joinable()) {
+		{
+			lock_guard<mutex> lock{_lock};
+			_stop = true;
+		}
+		_cond.notify_all();
+		_thread.join();
+	}
+
+	if(_source) {
+		wl_event_source_remove(_source);
+		_source = nullptr;
+	}
+
+	if(_notify_fd >= 0) {
+		close(_notify_fd);
+		_notify_fd = -1;
+	}
+
+	_pending.clear();
+	_requested.clear();
+	for(auto & x: _done) {
+		if(x.image)
+			cairo_surface_destroy(x.image);
+	}
+	_done.clear();
+}
+
+void wallpaper_t::set_source(string const & file, string const & scale_mode) {
+	if(file == _file and scale_mode == _scale_mode)
+		return;
+
+	_file = file;
+	_scale_mode = scale_mode;
+	_serial += 1;
+	_images.clear();
+	_requested.clear();
+
+	lock_guard<mutex> lock{_lock};
+	_pending.clear();
+}
+
+auto wallpaper_t::get(int width, int height, unsigned scale) -> wallpaper_image_p {
+	if(_file.empty() or width <= 0 or height <= 0)
+		return nullptr;
+
+	for(auto i = _images.begin(); i != _images.end(); ++i) {
+		if(i->width == width and i->height == height and i->scale == scale) {
+			_images.splice(_images.begin(), _images, i);
+			return _images.front().image;
+		}
+	}
+
+	for(auto & r: _requested) {
+		if(r.width == width and r.height == height and r.scale == scale)
+			return nullptr;
+	}
+
+	if(not _thread.joinable())
+		return nullptr;
+
+	_request_t r{_serial, _file, _scale_mode, width, height, scale};
+	_requested.push_back(r);
+
+	{
+		lock_guard<mutex> lock{_lock};
+		_pending.push_back(r);
+	}
+	_cond.notify_one();
+
+	return nullptr;
+}
+
+void wallpaper_t::_run() {
+	/* the file is read and decoded once for all outputs of a source */
+	uint64_t serial = 0;
+	string data;
+	string hash;
+	cairo_surface_t * decoded = nullptr;
+
+	unique_lock<mutex> lock{_lock};
+	for(;;) {
+		_cond.wait(lock, [this]() { return _stop or not _pending.empty(); });
+		if(_stop)
+			break;
+
+		auto r = _pending.front();
+		_pending.pop_front();
+		lock.unlock();
+
+		if(r.serial != serial) {
+			serial = r.serial;
+			if(decoded)
+				cairo_surface_destroy(decoded);
+			decoded = nullptr;
+			data.clear();
+			hash.clear();
+
+			gchar * contents = nullptr;
+			gsize length = 0;
+			if(g_file_get_contents(r.file.c_str(), &contents, &length, nullptr)) {
+				data.assign(contents, length);
+				g_free(contents);
+				gchar * checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA1,
+						reinterpret_cast<guchar const *>(data.data()), data.size());
+				hash = checksum;
+				g_free(checksum);
+			}
+		}
+
+		cairo_surface_t * image = nullptr;
+		if(not hash.empty()) {
+			auto path = _cache_path(hash, r);
+			image = _load_cache(path);
+			if(image == nullptr) {
+				if(decoded == nullptr)
+					decoded = _decode(data);
+				if(decoded) {
+					image = _scale(decoded, r);
+					_save_cache(path, image);
+				}
+			}
+		}
+
+		if(image)
+			cairo_surface_set_device_scale(image, r.scale, r.scale);
+
+		lock.lock();
+		_done.push_back(_result_t{r, image});
+		/* the main loop drain the eventfd, only overflow may fail */
+		eventfd_notify(_notify_fd);
+
+		/* do not keep the decoded file once every output is served */
+		if(_pending.empty()) {
+			if(decoded)
+				cairo_surface_destroy(decoded);
+			decoded = nullptr;
+			serial = 0;
+			data.clear();
+			hash.clear();
+		}
+	}
+	lock.unlock();
+
+	if(decoded)
+		cairo_surface_destroy(decoded);
+}
+
+void wallpaper_t::_dispatch() {
+	if(not eventfd_drain(_notify_fd))
+		weston_log("wallpaper: cannot read notification: %m\n");
+
+	list<_result_t> done;
+	{
+		lock_guard<mutex> lock{_lock};
+		done.swap(_done);
+	}
+
+	bool has_new_image = false;
+	for(auto & x: done) {
+		auto & r = x.request;
+		if(r.serial != _serial) {
+			/* the source changed in the meantime */
+			if(x.image)
+				cairo_surface_destroy(x.image);
+			continue;
+		}
+
+		/* failed requests stay requested, they are not retried */
+		if(x.image == nullptr) {
+			weston_log("wallpaper: cannot load %s\n", r.file.c_str());
+			continue;
+		}
+
+		_requested.remove_if([&r](_request_t const & y) -> bool {
+			return y.width == r.width and y.height == r.height and y.scale == r.scale;
+		});
+		_images.push_front(_entry_t{r.width, r.height, r.scale,
+			wallpaper_image_p{x.image, &cairo_surface_destroy}});
+		has_new_image = true;
+	}
+
+	while(_images.size() > _max_images)
+		_images.pop_back();
+
+	if(has_new_image)
+		on_ready.signal();
+}
+
+auto wallpaper_t::_cache_path(string const & hash, _request_t const & r) const -> string {
+	string mode = r.scale_mode;
+	replace_if(mode.begin(), mode.end(), [](char c) -> bool {
+		return not g_ascii_isalnum(c);
+	}, '_');
+
+	/* center and tile modes draw at the output scale, not only its size */
+	return _cache_dir + "/" + hash + "-" + to_string(r.width * r.scale) + "x"
+			+ to_string(r.height * r.scale) + "@" + to_string(r.scale)
+			+ "-" + mode + ".rgb";
+}
+
+auto wallpaper_t::_load_cache(string const & path) const -> cairo_surface_t * {
+	if(_cache_dir.empty())
+		return nullptr;
+
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		return nullptr;
+
+	struct stat st;
+	if(fstat(fd, &st) < 0 or st.st_size < static_cast<off_t>(_cache_data_offset)) {
+		close(fd);
+		return nullptr;
+	}
+
+	/* private mapping, the file is never written through it */
+	size_t size = st.st_size;
+	void * addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(addr == MAP_FAILED)
+		return nullptr;
+
+	auto header = reinterpret_cast<_cache_header_t const *>(addr);
+	if(memcmp(header->magic, _cache_magic, sizeof(_cache_magic)) != 0
+			or header->width <= 0 or header->height <= 0
+			or header->stride != cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, header->width)
+			or size != _cache_data_offset + static_cast<size_t>(header->stride) * header->height) {
+		munmap(addr, size);
+		return nullptr;
+	}
+
+	auto image = cairo_image_surface_create_for_data(
+			reinterpret_cast<unsigned char *>(addr) + _cache_data_offset,
+			CAIRO_FORMAT_RGB24, header->width, header->height, header->stride);
+	auto mapping = new _cache_mapping_t{addr, size};
+	if(cairo_surface_set_user_data(image, &_cache_mapping_key, mapping,
+			[](void * data) {
+		auto m = reinterpret_cast<_cache_mapping_t *>(data);
+		munmap(m->addr, m->size);
+		delete m;
+	}) != CAIRO_STATUS_SUCCESS) {
+		cairo_surface_destroy(image);
+		munmap(addr, size);
+		delete mapping;
+		return nullptr;
+	}
+
+	return image;
+}
+
+void wallpaper_t::_save_cache(string const & path, cairo_surface_t * image) const {
+	if(_cache_dir.empty())
+		return;
+
+	if(g_mkdir_with_parents(_cache_dir.c_str(), 0700) < 0)
+		return;
+
+	cairo_surface_flush(image);
+
+	vector<char> header(_cache_data_offset, 0);
+	_cache_header_t h;
+	memcpy(h.magic, _cache_magic, sizeof(_cache_magic));
+	h.width = cairo_image_surface_get_width(image);
+	h.height = cairo_image_surface_get_height(image);
+	h.stride = cairo_image_surface_get_stride(image);
+	memcpy(&header[0], &h, sizeof(h));
+
+	/* write aside then rename, a reader never see a partial file */
+	string tmp = path + "." + to_string(getpid()) + ".tmp";
+	FILE * f = fopen(tmp.c_str(), "wb");
+	if(f == nullptr)
+		return;
+
+	size_t data_size = static_cast<size_t>(h.stride) * h.height;
+	bool ok = fwrite(&header[0], header.size(), 1, f) == 1
+			and fwrite(cairo_image_surface_get_data(image), data_size, 1, f) == 1;
+	ok = (fclose(f) == 0) and ok;
+
+	if(not ok or rename(tmp.c_str(), path.c_str()) < 0)
+		unlink(tmp.c_str());
+}
+
+auto wallpaper_t::_decode(string const & data) -> cairo_surface_t * {
+	static unsigned char const png_magic[4] = {0x89, 'P', 'N', 'G'};
+
+	cairo_surface_t * image = nullptr;
+	if(data.size() > 4 and memcmp(data.data(), png_magic, 4) == 0) {
+		_png_reader_t reader{&data, 0};
+		image = cairo_image_surface_create_from_png_stream(&_read_png, &reader);
+#ifdef HAVE_JPEG
+	} else if(data.size() > 2 and static_cast<unsigned char>(data[0]) == 0xff
+			and static_cast<unsigned char>(data[1]) == 0xd8) {
+		image = _decode_jpeg(data);
+#endif
+	}
+
+	if(image and cairo_surface_status(image) != CAIRO_STATUS_SUCCESS) {
+		cairo_surface_destroy(image);
+		image = nullptr;
+	}
+
+	return image;
+}
+
+/* the scale modes of the former theme background */
+auto wallpaper_t::_scale(cairo_surface_t * source, _request_t const & r) -> cairo_surface_t * {
+	int width = r.width * r.scale;
+	int height = r.height * r.scale;
+	double src_width = cairo_image_surface_get_width(source);
+	double src_height = cairo_image_surface_get_height(source);
+
+	auto image = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+	cairo_t * cr = cairo_create(image);
+
+	cairo_set_source_rgb(cr, 0.5, 0.5, 0.5);
+	cairo_paint(cr);
+
+	if(src_width > 0 and src_height > 0) {
+		if(r.scale_mode == "tile") {
+			cairo_scale(cr, r.scale, r.scale);
+			cairo_set_source_surface(cr, source, 0.0, 0.0);
+			cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_REPEAT);
+			cairo_paint(cr);
+		} else {
+			double x_ratio = width / src_width;
+			double y_ratio = height / src_height;
+
+			double sx, sy;
+			if(r.scale_mode == "stretch") {
+				sx = x_ratio;
+				sy = y_ratio;
+			} else if(r.scale_mode == "zoom") {
+				sx = sy = max(x_ratio, y_ratio);
+			} else if(r.scale_mode == "scale" or r.scale_mode == "span") {
+				sx = sy = min(x_ratio, y_ratio);
+			} else {
+				/* center, keep the image size in logical pixels */
+				sx = sy = r.scale;
+			}
+
+			cairo_translate(cr, (width - src_width * sx) / 2.0,
+					(height - src_height * sy) / 2.0);
+			cairo_scale(cr, sx, sy);
+			cairo_set_source_surface(cr, source, 0.0, 0.0);
+			cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+			cairo_rectangle(cr, 0.0, 0.0, src_width, src_height);
+			cairo_fill(cr);
+		}
+	}
+
+	cairo_destroy(cr);
+	cairo_surface_flush(image);
+	return image;
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * wallpaper.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ * Decode and scale the wallpaper out of the main loop, once per output size
+ * and scale mode. Scaled images are stored in an on-disk cache keyed by the
+ * file content hash, the output size and scale and the scale mode, later
+ * startups map them instead of decoding the file again.
+ *
+ */
+
+#ifndef SRC_WALLPAPER_HXX_
+#define SRC_WALLPAPER_HXX_
+
+#include <cairo/cairo.h>
+#include <wayland-server.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <list>
+
+#include "utils.hxx"
+
+namespace page {
+
+using namespace std;
+
+/* scaled image of one output, mapped images are unmapped with the surface */
+using wallpaper_image_p = shared_ptr<cairo_surface_t>;
+
+class wallpaper_t {
+
+	struct _request_t {
+		/* source generation, results of older sources are dropped */
+		uint64_t serial;
+		string file;
+		string scale_mode;
+		/* in logical pixels */
+		int width;
+		int height;
+		unsigned scale;
+	};
+
+	struct _result_t {
+		_request_t request;
+		cairo_surface_t * image;
+	};
+
+	struct _entry_t {
+		int width;
+		int height;
+		unsigned scale;
+		wallpaper_image_p image;
+	};
+
+	thread _thread;
+	mutex _lock;
+	condition_variable _cond;
+	bool _stop;
+
+	string _cache_dir;
+
+	/* main loop only */
+	string _file;
+	string _scale_mode;
+	uint64_t _serial;
+	/* most recently used first */
+	list<_entry_t> _images;
+	list<_request_t> _requested;
+
+	/* shared with the worker */
+	list<_request_t> _pending;
+	list<_result_t> _done;
+
+	int _notify_fd;
+	wl_event_source * _source;
+
+	wallpaper_t(wallpaper_t const &) = delete;
+	wallpaper_t & operator=(wallpaper_t const &) = delete;
+
+	void _run();
+	void _dispatch();
+
+	auto _cache_path(string const & hash, _request_t const & r) const -> string;
+	auto _load_cache(string const & path) const -> cairo_surface_t *;
+	void _save_cache(string const & path, cairo_surface_t * image) const;
+
+	static auto _decode(string const & data) -> cairo_surface_t *;
+	static auto _scale(cairo_surface_t * source, _request_t const & r) -> cairo_surface_t *;
+
+public:
+	wallpaper_t();
+	~wallpaper_t();
+
+	void start(wl_event_loop * loop);
+	void stop();
+
+	/* an empty file disable the wallpaper */
+	void set_source(string const & file, string const & scale_mode);
+
+	/**
+	 * Image of an output of width x height logical pixels, the image has the
+	 * output scale as device scale. Return nullptr while the image is not
+	 * ready, on_ready is emitted once it is.
+	 **/
+	auto get(int width, int height, unsigned scale) -> wallpaper_image_p;
+
+	signal_t<> on_ready;
+
+};
+
+}
+
+#endif /* SRC_WALLPAPER_HXX_ */
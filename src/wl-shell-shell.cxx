@@ -36,7 +36,7 @@ wl_shell_client_t::wl_shell_client_t(page_context_t * ctx, wl_client * client, u
 	 * Define the implementation of the resource and the user_data,
 	 * i.e. callbacks that must be used for this resource.
 	 **/
-	wl_shell_vtable::set_implementation(_wl_shell_resource);
+	wl_shell_dispatch::set_implementation(_wl_shell_resource);
 
 }
 
@@ -29,7 +29,7 @@ namespace page {
 
 using namespace wcxx;
 
-struct wl_shell_client_t : public connectable_t, public wl_shell_vtable {
+struct wl_shell_client_t : public connectable_t, public wl_shell_dispatch<wl_shell_client_t> {
 	page_context_t * _ctx;
 	wl_client * _client;
 	uint32_t _id;
@@ -41,8 +41,8 @@ struct wl_shell_client_t : public connectable_t, public wl_shell_vtable {
 	wl_shell_client_t(page_context_t * ctx, wl_client * client, uint32_t id);
 	virtual ~wl_shell_client_t() = default;
 
-	virtual void wl_shell_get_shell_surface(struct wl_client * client, struct wl_resource * resource, uint32_t id, struct wl_resource * surface) override;
-	virtual void wl_shell_delete_resource(struct wl_resource * resource) override;
+	void wl_shell_get_shell_surface(struct wl_client * client, struct wl_resource * resource, uint32_t id, struct wl_resource * surface);
+	void wl_shell_delete_resource(struct wl_resource * resource);
 
 };
 
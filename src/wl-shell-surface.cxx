@@ -68,7 +68,7 @@ wl_shell_surface_t::wl_shell_surface_t(
 	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
 
 	_resource = wl_resource_create(_client, &wl_shell_surface_interface, 1, _id);
-	wl_shell_surface_vtable::set_implementation(_resource);
+	wl_shell_surface_dispatch::set_implementation(_resource);
 
 	on_surface_destroy.connect(&_surface->destroy_signal, this, &wl_shell_surface_t::surface_destroyed);
 	on_surface_commit.connect(&_surface->commit_signal, this, &wl_shell_surface_t::surface_commited);
@@ -84,7 +84,7 @@ wl_shell_surface_t::~wl_shell_surface_t() {
 }
 
 auto wl_shell_surface_t::get(struct wl_resource * r) -> wl_shell_surface_t * {
-	return dynamic_cast<wl_shell_surface_t*>(resource_get<wl_shell_surface_vtable>(r));
+	return wl_shell_surface_dispatch::get(r);
 }
 
 void wl_shell_surface_t::surface_commited(struct weston_surface * s) {
@@ -213,6 +213,8 @@ void wl_shell_surface_t::wl_shell_surface_set_maximized(wl_client *client,
 void wl_shell_surface_t::wl_shell_surface_set_title(wl_client *client,
 		  wl_resource *resource,
 		  const char *title) {
+	if(_current.title == title)
+		return;
 	_current.title = title;
 
 	if(not _master_view.expired()) {
@@ -48,7 +48,7 @@ using namespace wcxx;
 using namespace std;
 
 struct wl_shell_surface_t :
-	public wl_shell_surface_vtable,
+	public wl_shell_surface_dispatch<wl_shell_surface_t>,
 	public surface_t {
 
 	friend class page::page_t;
@@ -112,17 +112,17 @@ struct wl_shell_surface_t :
 	edge_e edge_map(uint32_t edge);
 
 	/* wl_shell_surface */
-	virtual void wl_shell_surface_pong(struct wl_client * client, struct wl_resource * resource, uint32_t serial) override;
-	virtual void wl_shell_surface_move(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial) override;
-	virtual void wl_shell_surface_resize(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, uint32_t edges) override;
-	virtual void wl_shell_surface_set_toplevel(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void wl_shell_surface_set_transient(struct wl_client * client, struct wl_resource * resource, struct wl_resource * parent, int32_t x, int32_t y, uint32_t flags) override;
-	virtual void wl_shell_surface_set_fullscreen(struct wl_client * client, struct wl_resource * resource, uint32_t method, uint32_t framerate, struct wl_resource * output) override;
-	virtual void wl_shell_surface_set_popup(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, struct wl_resource * parent, int32_t x, int32_t y, uint32_t flags) override;
-	virtual void wl_shell_surface_set_maximized(struct wl_client * client, struct wl_resource * resource, struct wl_resource * output) override;
-	virtual void wl_shell_surface_set_title(struct wl_client * client, struct wl_resource * resource, const char * title) override;
-	virtual void wl_shell_surface_set_class(struct wl_client * client, struct wl_resource * resource, const char * class_) override;
-	virtual void wl_shell_surface_delete_resource(struct wl_resource * resource) override;
+	void wl_shell_surface_pong(struct wl_client * client, struct wl_resource * resource, uint32_t serial);
+	void wl_shell_surface_move(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial);
+	void wl_shell_surface_resize(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, uint32_t edges);
+	void wl_shell_surface_set_toplevel(struct wl_client * client, struct wl_resource * resource);
+	void wl_shell_surface_set_transient(struct wl_client * client, struct wl_resource * resource, struct wl_resource * parent, int32_t x, int32_t y, uint32_t flags);
+	void wl_shell_surface_set_fullscreen(struct wl_client * client, struct wl_resource * resource, uint32_t method, uint32_t framerate, struct wl_resource * output);
+	void wl_shell_surface_set_popup(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, struct wl_resource * parent, int32_t x, int32_t y, uint32_t flags);
+	void wl_shell_surface_set_maximized(struct wl_client * client, struct wl_resource * resource, struct wl_resource * output);
+	void wl_shell_surface_set_title(struct wl_client * client, struct wl_resource * resource, const char * title);
+	void wl_shell_surface_set_class(struct wl_client * client, struct wl_resource * resource, const char * class_);
+	void wl_shell_surface_delete_resource(struct wl_resource * resource);
 
 	/* page_surface_interface */
 	virtual weston_surface * surface() const override;
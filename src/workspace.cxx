@@ -18,8 +18,6 @@ namespace page {
 
 using namespace std;
 
-time64_t const workspace_t::_switch_duration{0.5};
-
 workspace_t::workspace_t(page_context_t * ctx, unsigned id) :
 	_ctx{ctx},
 	//_allocation{},
@@ -27,9 +25,7 @@ workspace_t::workspace_t(page_context_t * ctx, unsigned id) :
 	_workarea{},
 	_primary_viewport{},
 	_id{id},
-	_switch_renderable{nullptr},
-	_switch_direction{WORKSPACE_SWITCH_LEFT},
-	_switch_screenshot{nullptr}
+	_snapshot_is_valid{false}
 {
 	_viewport_layer = make_shared<tree_t>();
 	_floating_layer = make_shared<tree_t>();
@@ -41,6 +37,10 @@ workspace_t::workspace_t(page_context_t * ctx, unsigned id) :
 
 }
 
+workspace_t::~workspace_t() {
+	drop_snapshot();
+}
+
 static bool is_dock(shared_ptr<tree_t> const & x) {
 	auto c = dynamic_pointer_cast<view_t>(x);
 	if(c != nullptr) {
@@ -53,31 +53,13 @@ string workspace_t::get_node_name() const {
 	return _get_node_name<'D'>();
 }
 
+string workspace_t::get_dump_name() const {
+	return _get_dump_name<'D'>() + xformat(" %u", _id);
+}
+
 void workspace_t::update_layout(time64_t const time) {
 	if(not _is_visible)
 		return;
-//
-//	if (_switch_renderable != nullptr and time < (_switch_start_time + _switch_duration)) {
-//		double ratio = (static_cast<double>(time - _switch_start_time) / static_cast<double const>(_switch_duration));
-//		ratio = ratio*1.05 - 0.025;
-//		ratio = min(1.0, max(0.0, ratio));
-//		int new_x = _ctx->left_most_border();
-//		if(_switch_direction == WORKSPACE_SWITCH_LEFT) {
-//			new_x += ratio*_switch_screenshot->witdh();
-//		} else {
-//			new_x -= ratio*_switch_screenshot->witdh();
-//		}
-//		_switch_renderable->move(new_x, _ctx->top_most_border());
-//	} else if (_switch_renderable != nullptr) {
-////		for(auto x: get_viewports()) {
-////			_ctx->add_global_damage(x->raw_area());
-////		}
-//
-//		remove(_switch_renderable);
-//		_switch_screenshot = nullptr;
-//		_switch_renderable = nullptr;
-//	}
-
 }
 
 void workspace_t::activate() {
@@ -89,6 +71,12 @@ void workspace_t::activate(shared_ptr<tree_t> t) {
 	/* do no reorder layers */
 }
 
+void workspace_t::invalidate_snapshot() {
+	if(not _snapshot_is_valid)
+		return;
+	drop_snapshot();
+}
+
 //rect workspace_t::allocation() const {
 //	return _allocation;
 //}
@@ -102,7 +90,12 @@ auto workspace_t::set_layout(vector<shared_ptr<viewport_t>> const & new_layout)
 	_viewport_layer->clear();
 	for(auto x: _viewport_outputs) {
 		_viewport_layer->push_back(x);
-		x->show();
+		/* hidden workspaces do not hold back buffers */
+		if(_is_visible) {
+			x->show();
+		} else {
+			x->hide();
+		}
 	}
 
 	if(_viewport_outputs.size() > 0) {
@@ -183,21 +176,132 @@ int workspace_t::id() {
 	return _id;
 }
 
-void workspace_t::start_switch(workspace_switch_direction_e direction) {
-//	if(_ctx->cmp() == nullptr)
-//		return;
-//
-//	if(_switch_renderable != nullptr) {
-//		remove(_switch_renderable);
-//		_switch_renderable = nullptr;
-//	}
-//
-//	_switch_direction = direction;
-//	_switch_start_time.update_to_current_time();
-//	_switch_screenshot = nullptr; //TODO _ctx->cmp()->create_screenshot();
-//	//_switch_renderable = make_shared<renderable_pixmap_t>(_ctx, _switch_screenshot, _ctx->left_most_border(), _ctx->top_most_border());
-//	push_back(_switch_renderable);
-//	_switch_renderable->show();
+void workspace_t::start_switch(workspace_switch_direction_e direction, workspace_p from) {
+	for(auto v: get_viewports()) {
+		auto area = v->raw_area();
+		/* no slide on viewports that changed since a snapshot was taken */
+		auto from_snapshot = from->get_snapshot(area);
+		auto to_snapshot = get_snapshot(area);
+		if(from_snapshot == nullptr or to_snapshot == nullptr)
+			continue;
+		auto sw = _ctx->get_workspace_switch(v->get_output(), area);
+		if(sw == nullptr)
+			continue;
+		/* a switch is above every thing else of the workspace */
+		push_back(sw);
+		sw->show();
+		sw->start(from_snapshot, to_snapshot, direction);
+	}
+}
+
+/**
+ * Paint the current content of each viewport into an image, scaled by
+ * scale. The content is copied from surfaces, thus this is not cheap and
+ * must be done only when the snapshot is not valid. Hidden viewports do
+ * not hold their back buffer, thus only a shown workspace is captured.
+ **/
+void workspace_t::take_snapshot(double scale) {
+	drop_snapshot();
+	if(not _is_visible)
+		return;
+
+	auto children = get_all_children();
+	for(auto v: get_viewports()) {
+		auto area = v->raw_area();
+		int w = max(1, static_cast<int>(area.w * scale));
+		int h = max(1, static_cast<int>(area.h * scale));
+
+		auto surf = cairo_image_surface_create(CAIRO_FORMAT_RGB24, w, h);
+		cairo_t * cr = cairo_create(surf);
+		cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+		cairo_paint(cr);
+		cairo_scale(cr, static_cast<double>(w)/area.w,
+				static_cast<double>(h)/area.h);
+		cairo_translate(cr, -area.x, -area.y);
+
+		/* children are root first, i.e. the last one is on top */
+		for(auto x: children) {
+			if(dynamic_pointer_cast<workspace_switch_t>(x))
+				continue;
+			auto view = x->get_default_view();
+			if(view == nullptr or view->surface == nullptr)
+				continue;
+
+			int cw, ch;
+			weston_surface_get_content_size(view->surface, &cw, &ch);
+			if(cw <= 0 or ch <= 0)
+				continue;
+
+			weston_view_update_transform(view);
+			auto box = pixman_region32_extents(&view->transform.boundingbox);
+			if(not area.has_intersection(rect(box->x1, box->y1, box->x2-box->x1, box->y2-box->y1)))
+				continue;
+
+			auto content = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, cw, ch);
+			cairo_surface_flush(content);
+			auto data = cairo_image_surface_get_data(content);
+			auto stride = cairo_image_surface_get_stride(content);
+			if(stride != cw * 4 or weston_surface_copy_content(view->surface,
+					data, stride * ch, 0, 0, cw, ch) < 0) {
+				cairo_surface_destroy(content);
+				continue;
+			}
+
+			/* weston give RGBA bytes, cairo want native endian ARGB */
+			auto pixels = reinterpret_cast<uint32_t *>(data);
+			for(int k = 0; k < cw * ch; ++k) {
+				uint32_t r = data[k*4+0];
+				uint32_t g = data[k*4+1];
+				uint32_t b = data[k*4+2];
+				uint32_t a = data[k*4+3];
+				pixels[k] = (a << 24) | (r << 16) | (g << 8) | b;
+			}
+			cairo_surface_mark_dirty(content);
+
+			cairo_save(cr);
+			cairo_translate(cr, box->x1, box->y1);
+			cairo_scale(cr, static_cast<double>(box->x2-box->x1)/cw,
+					static_cast<double>(box->y2-box->y1)/ch);
+			cairo_set_source_surface(cr, content, 0, 0);
+			cairo_paint(cr);
+			cairo_restore(cr);
+			cairo_surface_destroy(content);
+		}
+
+		cairo_destroy(cr);
+		cairo_surface_flush(surf);
+		_snapshots.push_back(workspace_snapshot_t{area, surf});
+	}
+
+	_snapshot_is_valid = true;
+}
+
+void workspace_t::drop_snapshot() {
+	for(auto & x: _snapshots)
+		cairo_surface_destroy(x.surface);
+	_snapshots.clear();
+	_snapshot_is_valid = false;
+}
+
+bool workspace_t::has_valid_snapshot() const {
+	return _snapshot_is_valid;
+}
+
+auto workspace_t::get_snapshot(rect const & area) const -> cairo_surface_t * {
+	for(auto & x: _snapshots) {
+		if(x.area == area)
+			return x.surface;
+	}
+	return nullptr;
+}
+
+auto workspace_t::snapshot_size() const -> size_t {
+	size_t size = 0;
+	for(auto & x: _snapshots) {
+		size += cairo_image_surface_get_stride(x.surface)
+				* cairo_image_surface_get_height(x.surface);
+	}
+	return size;
 }
 
 auto workspace_t::get_visible_region() -> region {
@@ -224,6 +328,11 @@ void workspace_t::hide() {
 		x->hide();
 	}
 
+	/* layers do not forward hide, release viewports back buffers */
+	for(auto x: _viewport_outputs) {
+		x->hide();
+	}
+
 	_is_visible = false;
 }
 
@@ -233,26 +342,31 @@ void workspace_t::show() {
 	for(auto x: children()) {
 		x->show();
 	}
+
+	for(auto x: _viewport_outputs) {
+		x->show();
+	}
 }
 
 bool workspace_t::client_focus_history_front(view_p & out) {
 	if(not client_focus_history_is_empty()) {
-		out = _client_focus_history.front().lock();
+		out = _client_focus_history.front()->shared_from_this();
 		return true;
 	}
 	return false;
 }
 
 void workspace_t::client_focus_history_remove(view_p in) {
-	_client_focus_history.remove_if([in](tree_w w) { return w.expired() or w.lock() == in; });
+	_client_focus_history.remove(in->workspace_focus_hook);
 }
 
+/* a view is in the history of one workspace at most */
 void workspace_t::client_focus_history_move_front(view_p in) {
-	move_front(_client_focus_history, in);
+	_client_focus_history.move_front(in->workspace_focus_hook);
 }
 
+/* destroyed views unlink themselves */
 bool workspace_t::client_focus_history_is_empty() {
-	_client_focus_history.remove_if([](tree_w const & w) { return w.expired(); });
 	return _client_focus_history.empty();
 }
 
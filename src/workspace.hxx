@@ -17,6 +17,7 @@
 #include "page_context.hxx"
 #include "viewport.hxx"
 #include "renderable_pixmap.hxx"
+#include "workspace_switch.hxx"
 #include "xdg-shell-v5-surface-popup.hxx"
 #include "xdg-shell-v5-surface-toplevel.hxx"
 
@@ -24,9 +25,13 @@ namespace page {
 
 using namespace std;
 
-enum workspace_switch_direction_e {
-	WORKSPACE_SWITCH_LEFT,
-	WORKSPACE_SWITCH_RIGHT
+/**
+ * Cached image of what a workspace show on one viewport, possibly
+ * downscaled.
+ **/
+struct workspace_snapshot_t {
+	rect area;
+	cairo_surface_t * surface;
 };
 
 struct workspace_t: public tree_t {
@@ -52,20 +57,16 @@ private:
 	workspace_t(workspace_t const & v) = delete;
 	workspace_t & operator= (workspace_t const &) = delete;
 
-	static time64_t const _switch_duration;
+	/* snapshots are valid until a view or viewport of this workspace change */
+	vector<workspace_snapshot_t> _snapshots;
+	bool _snapshot_is_valid;
 
-	time64_t _switch_start_time;
-	cairo_surface_t * _switch_screenshot;
-	cairo_surface_t * _switch_renderable;
-
-	workspace_switch_direction_e _switch_direction;
-
-	list<view_w> _client_focus_history;
+	focus_history_t _client_focus_history;
 
 public:
 
 	workspace_t(page_context_t * ctx, unsigned id);
-	~workspace_t() { }
+	~workspace_t();
 
 
 	auto get_any_viewport() const -> shared_ptr<viewport_t>;
@@ -73,7 +74,7 @@ public:
 	auto default_pop() -> shared_ptr<notebook_t>;
 	int  id();
 	auto primary_viewport() const -> shared_ptr<viewport_t>;
-	void start_switch(workspace_switch_direction_e direction);
+	void start_switch(workspace_switch_direction_e direction, shared_ptr<workspace_t> from);
 	void set_workarea(rect const & r);
 	auto workarea() -> rect const &;
 	auto get_viewports() const -> vector<shared_ptr<viewport_t>> ;
@@ -88,6 +89,12 @@ public:
 	void client_focus_history_move_front(view_p in);
 	bool client_focus_history_is_empty();
 
+	void take_snapshot(double scale);
+	void drop_snapshot();
+	bool has_valid_snapshot() const;
+	auto get_snapshot(rect const & area) const -> cairo_surface_t *;
+	auto snapshot_size() const -> size_t;
+
 	/**
 	 * tree_t virtual API
 	 **/
@@ -95,6 +102,7 @@ public:
 	virtual void hide();
 	virtual void show();
 	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
 	//virtual void remove(shared_ptr<tree_t> t);
 
 	//virtual void append_children(vector<shared_ptr<tree_t>> & out) const;
@@ -107,6 +115,7 @@ public:
 
 	virtual void activate();
 	virtual void activate(shared_ptr<tree_t> t);
+	virtual void invalidate_snapshot();
 	//virtual bool button_press(xcb_button_press_event_t const * ev);
 	//virtual bool button_release(xcb_button_release_event_t const * ev);
 	//virtual bool button_motion(xcb_motion_notify_event_t const * ev);
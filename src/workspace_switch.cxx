@@ -0,0 +1,238 @@
+/*
+ * workspace_switch.cxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#include "workspace_switch.hxx"
+
+#include <cassert>
+#include <algorithm>
+
+namespace page {
+
+using namespace std;
+
+time64_t const workspace_switch_t::_duration{0.5};
+
+workspace_switch_t::workspace_switch_t(page_context_t * ctx,
+		weston_output * output, rect const & area) :
+	_ctx{ctx},
+	_output{output},
+	_area{area},
+	_surface{nullptr},
+	_default_view{nullptr},
+	_from{nullptr},
+	_to{nullptr},
+	_direction{WORKSPACE_SWITCH_LEFT},
+	_is_pending{false},
+	_is_running{false}
+{
+
+}
+
+workspace_switch_t::~workspace_switch_t() {
+	_on_output_frame.disconnect();
+	_release_snapshots();
+	if(_default_view) {
+		weston_view_destroy(_default_view);
+		_default_view = nullptr;
+	}
+}
+
+void workspace_switch_t::_create_strip() {
+	/* the strip hold both snapshots side by side */
+	_pix = _ctx->create_pixmap(_area.w * 2, _area.h, PIXMAP_RGB);
+	_pix_on_ack_buffer = _pix->on_ack_buffer.connect(this,
+			&workspace_switch_t::_on_ack_buffer);
+	/* local pixmaps are ready at creation, no ack will come */
+	if(_pix->is_ready())
+		_on_ack_buffer(_pix.get());
+}
+
+/**
+ * The strip is twice the output size and is not part of the snapshot
+ * budget, free it between switches. Loopback pixmaps are never released,
+ * those are kept for the next switch instead.
+ **/
+void workspace_switch_t::_release_strip() {
+	if(_pix == nullptr or not _pix->is_local())
+		return;
+
+	if(_default_view) {
+		weston_view_destroy(_default_view);
+		_default_view = nullptr;
+	}
+
+	_surface = nullptr;
+	_pix_on_ack_buffer = nullptr;
+	_pix = nullptr;
+}
+
+auto workspace_switch_t::area() const -> rect const & {
+	return _area;
+}
+
+bool workspace_switch_t::is_running() const {
+	return _is_running;
+}
+
+void workspace_switch_t::_release_snapshots() {
+	if(_from)
+		cairo_surface_destroy(_from);
+	if(_to)
+		cairo_surface_destroy(_to);
+	_from = nullptr;
+	_to = nullptr;
+}
+
+void workspace_switch_t::start(cairo_surface_t * from, cairo_surface_t * to,
+		workspace_switch_direction_e direction) {
+	_on_output_frame.disconnect();
+	_release_snapshots();
+	_is_running = false;
+
+	_from = from?cairo_surface_reference(from):nullptr;
+	_to = to?cairo_surface_reference(to):nullptr;
+	_direction = direction;
+	_is_pending = true;
+
+	if(_pix == nullptr)
+		_create_strip();
+
+	/* the buffer may not be ready yet, in that case start on ack */
+	if(_surface)
+		_compose();
+}
+
+void workspace_switch_t::finish() {
+	auto ths = shared_from_this();
+
+	_is_pending = false;
+	_is_running = false;
+	_on_output_frame.disconnect();
+	_release_snapshots();
+
+	if(_parent) {
+		_parent->remove(ths);
+		_ctx->sync_tree_view();
+	}
+
+	_release_strip();
+}
+
+void workspace_switch_t::_on_ack_buffer(pixmap_t * p) {
+	assert(_pix.get() == p);
+
+	_surface = _pix->wsurface();
+	weston_surface_set_role(_surface, "page_workspace_switch", nullptr, 0);
+	_surface->timeline.force_refresh = 1;
+	_default_view = weston_view_create(_surface);
+
+	if(_is_pending)
+		_compose();
+}
+
+void workspace_switch_t::_compose() {
+	auto surf = _pix->get_cairo_surface();
+	if(surf == nullptr)
+		return;
+
+	cairo_t * cr = cairo_create(surf);
+	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+	cairo_paint(cr);
+
+	/* snapshots may be downscaled, scale them back to the output size */
+	auto paint = [this, cr](cairo_surface_t * s, int x) {
+		if(s == nullptr)
+			return;
+		cairo_save(cr);
+		cairo_translate(cr, x, 0);
+		cairo_scale(cr,
+				static_cast<double>(_area.w)/cairo_image_surface_get_width(s),
+				static_cast<double>(_area.h)/cairo_image_surface_get_height(s));
+		cairo_set_source_surface(cr, s, 0, 0);
+		cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+		cairo_paint(cr);
+		cairo_restore(cr);
+	};
+
+	if(_direction == WORKSPACE_SWITCH_RIGHT) {
+		paint(_from, 0);
+		paint(_to, _area.w);
+	} else {
+		paint(_to, 0);
+		paint(_from, _area.w);
+	}
+
+	cairo_surface_flush(surf);
+	warn(cairo_get_reference_count(cr) == 1);
+	cairo_destroy(cr);
+
+	/* snapshots are not needed anymore */
+	_release_snapshots();
+
+	(*_ctx->ec->renderer->attach)(_surface, _pix->wbuffer());
+	weston_surface_damage(_surface);
+	(*_ctx->ec->renderer->flush_damage)(_surface);
+
+	_is_pending = false;
+	_is_running = true;
+	_start_time = time64_t::now();
+	_update_position(0.0);
+
+	_on_output_frame.connect(&_output->frame_signal, this,
+			&workspace_switch_t::_on_frame);
+
+	_ctx->sync_tree_view();
+}
+
+void workspace_switch_t::_on_frame(weston_output * output) {
+	time64_t now = time64_t::now();
+	double ratio = static_cast<double>(now - _start_time)
+			/ static_cast<double>(_duration);
+
+	if(ratio >= 1.0) {
+		finish();
+		return;
+	}
+
+	_update_position(ratio);
+}
+
+void workspace_switch_t::_update_position(double ratio) {
+	ratio = min(1.0, max(0.0, ratio));
+	/* smooth start and stop */
+	ratio = ratio * ratio * (3.0 - 2.0 * ratio);
+	int offset = static_cast<int>(ratio * _area.w);
+
+	if(_direction == WORKSPACE_SWITCH_RIGHT) {
+		weston_view_set_position(_default_view, _area.x - offset, _area.y);
+		weston_view_set_mask(_default_view, offset, 0, _area.w, _area.h);
+	} else {
+		weston_view_set_position(_default_view, _area.x - _area.w + offset, _area.y);
+		weston_view_set_mask(_default_view, _area.w - offset, 0, _area.w, _area.h);
+	}
+
+	weston_view_schedule_repaint(_default_view);
+}
+
+auto workspace_switch_t::get_node_name() const -> string {
+	return _get_node_name<'W'>();
+}
+
+auto workspace_switch_t::get_dump_name() const -> string {
+	return _get_dump_name<'W'>() + " " + _area.to_string();
+}
+
+auto workspace_switch_t::get_default_view() const -> weston_view * {
+	if(_is_running)
+		return _default_view;
+	return nullptr;
+}
+
+}
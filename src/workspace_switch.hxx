@@ -0,0 +1,96 @@
+/*
+ * workspace_switch.hxx
+ *
+ * copyright (2017) Benoit Gschwind
+ *
+ * This code is licensed under the GPLv3. see COPYING file for more details.
+ *
+ */
+
+#ifndef SRC_WORKSPACE_SWITCH_HXX_
+#define SRC_WORKSPACE_SWITCH_HXX_
+
+#include <cairo/cairo.h>
+
+#include "tree.hxx"
+#include "page_context.hxx"
+#include "listener.hxx"
+#include "pixmap.hxx"
+
+namespace page {
+
+using namespace std;
+
+enum workspace_switch_direction_e {
+	WORKSPACE_SWITCH_LEFT,
+	WORKSPACE_SWITCH_RIGHT
+};
+
+/**
+ * Slide animation between two workspace snapshots on one output.
+ *
+ * Both snapshots are composed once side by side into a strip twice the
+ * width of the output, then each frame only move and mask the strip
+ * view, i.e. the workspaces are not laid out nor rendered during the
+ * animation.
+ **/
+class workspace_switch_t : public tree_t {
+	page_context_t * _ctx;
+
+	static time64_t const _duration;
+
+	weston_output * _output;
+	rect _area;
+
+	pixmap_p _pix;
+	signal_handler_t _pix_on_ack_buffer;
+
+	weston_surface * _surface;
+	weston_view * _default_view;
+
+	listener_t<weston_output> _on_output_frame;
+
+	cairo_surface_t * _from;
+	cairo_surface_t * _to;
+	workspace_switch_direction_e _direction;
+
+	time64_t _start_time;
+	bool _is_pending;
+	bool _is_running;
+
+	workspace_switch_t(workspace_switch_t const &) = delete;
+	workspace_switch_t & operator=(workspace_switch_t const &) = delete;
+
+	void _create_strip();
+	void _release_strip();
+	void _on_ack_buffer(pixmap_t * p);
+	void _on_frame(weston_output * output);
+	void _compose();
+	void _update_position(double ratio);
+	void _release_snapshots();
+
+public:
+
+	workspace_switch_t(page_context_t * ctx, weston_output * output, rect const & area);
+	virtual ~workspace_switch_t();
+
+	auto area() const -> rect const &;
+	bool is_running() const;
+
+	/* from and to are referenced until the end of the switch */
+	void start(cairo_surface_t * from, cairo_surface_t * to, workspace_switch_direction_e direction);
+	void finish();
+
+	/**
+	 * tree_t virtual API
+	 **/
+
+	virtual auto get_node_name() const -> string;
+	virtual auto get_dump_name() const -> string;
+	virtual auto get_default_view() const -> weston_view *;
+
+};
+
+}
+
+#endif /* SRC_WORKSPACE_SWITCH_HXX_ */
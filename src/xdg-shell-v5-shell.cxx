@@ -80,7 +80,7 @@ void xdg_shell_client_t::xdg_shell_pong(struct wl_client *client,
 }
 
 auto xdg_shell_client_t::get(wl_resource * resource) -> xdg_shell_client_t * {
-	return dynamic_cast<xdg_shell_client_t *>(resource_get<xdg_shell_vtable>(resource));
+	return xdg_shell_dispatch::get(resource);
 }
 
 void xdg_shell_client_t::xdg_shell_delete_resource(struct wl_resource *resource) {
@@ -104,7 +104,7 @@ xdg_shell_client_t::xdg_shell_client_t(
 	 * Define the implementation of the resource and the user_data,
 	 * i.e. callbacks that must be used for this resource.
 	 **/
-	xdg_shell_vtable::set_implementation(xdg_shell_resource);
+	xdg_shell_dispatch::set_implementation(xdg_shell_resource);
 
 }
 
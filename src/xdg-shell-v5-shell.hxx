@@ -22,7 +22,7 @@ namespace page {
 using namespace std;
 
 struct xdg_shell_client_t : protected connectable_t,
-public xdg_shell_vtable {
+public xdg_shell_dispatch<xdg_shell_client_t> {
 	page_context_t * _ctx;
 
 	wl_client * client;
@@ -50,21 +50,19 @@ public xdg_shell_vtable {
 
 	static auto get(wl_resource * resource) -> xdg_shell_client_t *;
 
-	virtual void xdg_shell_destroy(wl_client * client, wl_resource * resource)
-			override;
-	virtual void xdg_shell_use_unstable_version(wl_client * client,
-			wl_resource * resource, int32_t version) override;
-	virtual void xdg_shell_get_xdg_surface(wl_client * client,
-			wl_resource * resource, uint32_t id, wl_resource * surface_resource)
-					override;
-	virtual void xdg_shell_get_xdg_popup(wl_client * client,
+	void xdg_shell_destroy(wl_client * client, wl_resource * resource);
+	void xdg_shell_use_unstable_version(wl_client * client,
+			wl_resource * resource, int32_t version);
+	void xdg_shell_get_xdg_surface(wl_client * client,
+			wl_resource * resource, uint32_t id, wl_resource * surface_resource);
+	void xdg_shell_get_xdg_popup(wl_client * client,
 			wl_resource * resource, uint32_t id, wl_resource * surface,
 			wl_resource * parent, wl_resource* seat_resource, uint32_t serial,
-			int32_t x, int32_t y) override;
-	virtual void xdg_shell_pong(wl_client * client, wl_resource * resource,
-			uint32_t serial) override;
+			int32_t x, int32_t y);
+	void xdg_shell_pong(wl_client * client, wl_resource * resource,
+			uint32_t serial);
 
-	virtual void xdg_shell_delete_resource(wl_resource * resource);
+	void xdg_shell_delete_resource(wl_resource * resource);
 
 };
 
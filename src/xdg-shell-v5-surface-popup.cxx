@@ -19,7 +19,7 @@ namespace page {
 using namespace std;
 
 auto xdg_surface_popup_t::get(wl_resource * r) -> xdg_surface_popup_t * {
-	return dynamic_cast<xdg_surface_popup_t*>(resource_get<xdg_popup_vtable>(r));
+	return xdg_popup_dispatch::get(r);
 }
 
 void xdg_surface_popup_t::surface_first_commited(weston_surface * es)
@@ -65,7 +65,7 @@ xdg_surface_popup_t::xdg_surface_popup_t(
 	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
 
 	_resource = wl_resource_create(client, &xdg_popup_interface, 1, _id);
-	xdg_popup_vtable::set_implementation(_resource);
+	xdg_popup_dispatch::set_implementation(_resource);
 
 	on_surface_commit.connect(&_surface->commit_signal, this, &xdg_surface_popup_t::surface_first_commited);
 	on_surface_destroy.connect(&_surface->destroy_signal, this, &xdg_surface_popup_t::surface_destroyed);
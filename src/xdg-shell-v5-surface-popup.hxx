@@ -30,7 +30,7 @@ using namespace std;
 
 struct xdg_surface_popup_t :
 		public xdg_surface_base_t,
-		public xdg_popup_vtable,
+		public xdg_popup_dispatch<xdg_surface_popup_t>,
 		public surface_t {
 
 	wl_client * client;
@@ -69,9 +69,9 @@ struct xdg_surface_popup_t :
 
 	virtual surface_t * page_surface();
 
-	/* xdg_popup_vtable */
-	virtual void xdg_popup_destroy(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void xdg_popup_delete_resource(struct wl_resource * resource) override;
+	/* xdg_popup_dispatch */
+	void xdg_popup_destroy(struct wl_client * client, struct wl_resource * resource);
+	void xdg_popup_delete_resource(struct wl_resource * resource);
 
 	/* page_surface_interface */
 	virtual weston_surface * surface() const override;
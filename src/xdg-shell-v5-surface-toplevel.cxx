@@ -60,7 +60,7 @@ xdg_surface_toplevel_t::xdg_surface_toplevel_t(
 	weston_log("window default position = %s\n", pos.to_string().c_str());
 
 	_resource = wl_resource_create(_client, &xdg_surface_interface, 1, _id);
-	xdg_surface_vtable::set_implementation(_resource);
+	xdg_surface_dispatch::set_implementation(_resource);
 
 	on_surface_commit.connect(&_surface->commit_signal, this, &xdg_surface_toplevel_t::surface_first_commited);
 	on_surface_destroy.connect(&_surface->destroy_signal, this, &xdg_surface_toplevel_t::surface_destroyed);
@@ -136,12 +136,13 @@ void xdg_surface_toplevel_t::surface_commited(struct weston_surface * es)
 		}
 	}
 
+	_current = _pending;
+
 	if(not _master_view.expired()) {
 		_master_view.lock()->update_view();
+		_master_view.lock()->configure_commited();
 	}
 
-	_current = _pending;
-
 }
 
 edge_e xdg_surface_toplevel_t::edge_map(uint32_t edge) {
@@ -154,7 +155,7 @@ edge_e xdg_surface_toplevel_t::edge_map(uint32_t edge) {
 }
 
 auto xdg_surface_toplevel_t::get(wl_resource * r) -> xdg_surface_toplevel_t * {
-	return dynamic_cast<xdg_surface_toplevel_t*>(resource_get<xdg_surface_vtable>(r));
+	return xdg_surface_dispatch::get(r);
 }
 
 auto xdg_surface_toplevel_t::resource() const -> wl_resource * {
@@ -346,5 +347,9 @@ void xdg_surface_toplevel_t::send_configure_popup(int32_t x, int32_t y, int32_t
 	/* should not be called */
 }
 
+bool xdg_surface_toplevel_t::has_pending_configure() const {
+	return _ack_serial != 0;
+}
+
 }
 
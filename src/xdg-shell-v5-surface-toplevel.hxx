@@ -37,7 +37,7 @@ using namespace std;
 
 struct xdg_surface_toplevel_t :
 	public xdg_surface_base_t,
-	public xdg_surface_vtable,
+	public xdg_surface_dispatch<xdg_surface_toplevel_t>,
 	public surface_t {
 
 	friend class page::page_t;
@@ -109,39 +109,37 @@ struct xdg_surface_toplevel_t :
 	/**
 	 * xdg-surface-interface (request)
 	 **/
-	virtual void xdg_surface_destroy(wl_client * client, wl_resource * resource)
-			override;
-	virtual void xdg_surface_set_parent(wl_client * client,
-			wl_resource * resource, wl_resource * parent_resource) override;
-	virtual void xdg_surface_set_app_id(wl_client * client,
-			wl_resource * resource, const char * app_id) override;
-	virtual void xdg_surface_show_window_menu(wl_client * client,
+	void xdg_surface_destroy(wl_client * client, wl_resource * resource);
+	void xdg_surface_set_parent(wl_client * client,
+			wl_resource * resource, wl_resource * parent_resource);
+	void xdg_surface_set_app_id(wl_client * client,
+			wl_resource * resource, const char * app_id);
+	void xdg_surface_show_window_menu(wl_client * client,
 			wl_resource * surface_resource, wl_resource * seat_resource,
-			uint32_t serial, int32_t x, int32_t y) override;
-	virtual void xdg_surface_set_title(wl_client * client,
-			wl_resource * resource, const char * title) override;
-	virtual void xdg_surface_move(wl_client * client, wl_resource * resource,
-			wl_resource* seat_resource, uint32_t serial) override;
-	virtual void xdg_surface_resize(wl_client* client, wl_resource * resource,
-			wl_resource * seat_resource, uint32_t serial, uint32_t edges)
-					override;
-	virtual void xdg_surface_ack_configure(wl_client * client,
-			wl_resource * resource, uint32_t serial) override;
-	virtual void xdg_surface_set_window_geometry(wl_client * client,
+			uint32_t serial, int32_t x, int32_t y);
+	void xdg_surface_set_title(wl_client * client,
+			wl_resource * resource, const char * title);
+	void xdg_surface_move(wl_client * client, wl_resource * resource,
+			wl_resource* seat_resource, uint32_t serial);
+	void xdg_surface_resize(wl_client* client, wl_resource * resource,
+			wl_resource * seat_resource, uint32_t serial, uint32_t edges);
+	void xdg_surface_ack_configure(wl_client * client,
+			wl_resource * resource, uint32_t serial);
+	void xdg_surface_set_window_geometry(wl_client * client,
 			wl_resource * resource, int32_t x, int32_t y, int32_t width,
-			int32_t height) override;
-	virtual void xdg_surface_set_maximized(wl_client * client,
-			wl_resource * resource) override;
-	virtual void xdg_surface_unset_maximized(wl_client* client,
-			wl_resource* resource) override;
-	virtual void xdg_surface_set_fullscreen(wl_client * client,
-			wl_resource * resource, wl_resource * output_resource) override;
-	virtual void xdg_surface_unset_fullscreen(wl_client * client,
-			wl_resource * resource) override;
-	virtual void xdg_surface_set_minimized(wl_client * client,
-			wl_resource * resource) override;
-
-	virtual void xdg_surface_delete_resource(wl_resource *resource) override;
+			int32_t height);
+	void xdg_surface_set_maximized(wl_client * client,
+			wl_resource * resource);
+	void xdg_surface_unset_maximized(wl_client* client,
+			wl_resource* resource);
+	void xdg_surface_set_fullscreen(wl_client * client,
+			wl_resource * resource, wl_resource * output_resource);
+	void xdg_surface_unset_fullscreen(wl_client * client,
+			wl_resource * resource);
+	void xdg_surface_set_minimized(wl_client * client,
+			wl_resource * resource);
+
+	void xdg_surface_delete_resource(wl_resource *resource);
 
 	/* page_surface_interface */
 	virtual weston_surface * surface() const override;
@@ -152,6 +150,7 @@ struct xdg_surface_toplevel_t :
 	virtual void send_configure(int32_t width, int32_t height, set<uint32_t> const & states) override;
 	virtual void send_close() override;
 	virtual void send_configure_popup(int32_t x, int32_t y, int32_t width, int32_t height) override;
+	virtual bool has_pending_configure() const override;
 
 };
 
@@ -33,7 +33,7 @@ xdg_popup_v6_t::xdg_popup_v6_t(
 	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
 
 	self_resource = wl_resource_create(client, &zxdg_popup_v6_interface, 1, id);
-	zxdg_popup_v6_vtable::set_implementation(self_resource);
+	zxdg_popup_v6_dispatch::set_implementation(self_resource);
 
 	connect(_base->destroy, this, &xdg_popup_v6_t::surface_destroyed);
 	connect(_base->commited, this, &xdg_popup_v6_t::surface_first_commited);
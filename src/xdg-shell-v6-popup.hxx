@@ -17,7 +17,7 @@ namespace page {
 using namespace std;
 using namespace wcxx;
 
-struct xdg_popup_v6_t : public connectable_t, public zxdg_popup_v6_vtable, public surface_t {
+struct xdg_popup_v6_t : public connectable_t, public zxdg_popup_v6_dispatch<xdg_popup_v6_t>, public surface_t {
 	xdg_surface_v6_t *     _base;
 
 	page_context_t *       _ctx;
@@ -47,10 +47,10 @@ struct xdg_popup_v6_t : public connectable_t, public zxdg_popup_v6_vtable, publi
 
 	virtual ~xdg_popup_v6_t();
 
-	/* zxdg_popup_v6_vtable */
-	virtual void zxdg_popup_v6_destroy(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_popup_v6_grab(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial) override;
-	virtual void zxdg_popup_v6_delete_resource(struct wl_resource * resource) override;
+	/* zxdg_popup_v6_dispatch */
+	void zxdg_popup_v6_destroy(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_popup_v6_grab(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial);
+	void zxdg_popup_v6_delete_resource(struct wl_resource * resource);
 
 	/* page_surface_interface */
 	virtual weston_surface * surface() const override;
@@ -24,12 +24,12 @@ xdg_positioner_v6_t::xdg_positioner_v6_t(
 {
 
 	self_resource = wl_resource_create(client, &zxdg_positioner_v6_interface, 1, id);
-	zxdg_positioner_v6_vtable::set_implementation(self_resource);
+	zxdg_positioner_v6_dispatch::set_implementation(self_resource);
 
 }
 
 auto xdg_positioner_v6_t::get(struct wl_resource * r) -> xdg_positioner_v6_t * {
-	return dynamic_cast<xdg_positioner_v6_t *>(resource_get<zxdg_positioner_v6_vtable>(r));
+	return zxdg_positioner_v6_dispatch::get(r);
 }
 
 void xdg_positioner_v6_t::zxdg_positioner_v6_destroy(struct wl_client * client, struct wl_resource * resource)
@@ -16,7 +16,7 @@ namespace page {
 using namespace std;
 using namespace wcxx;
 
-struct xdg_positioner_v6_t : public zxdg_positioner_v6_vtable {
+struct xdg_positioner_v6_t : public zxdg_positioner_v6_dispatch<xdg_positioner_v6_t> {
 
 	page_context_t *       _ctx;
 	wl_client *            _client;
@@ -40,14 +40,14 @@ struct xdg_positioner_v6_t : public zxdg_positioner_v6_vtable {
 
 	virtual ~xdg_positioner_v6_t() = default;
 
-	virtual void zxdg_positioner_v6_destroy(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_positioner_v6_set_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height) override;
-	virtual void zxdg_positioner_v6_set_anchor_rect(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y, int32_t width, int32_t height) override;
-	virtual void zxdg_positioner_v6_set_anchor(struct wl_client * client, struct wl_resource * resource, uint32_t anchor) override;
-	virtual void zxdg_positioner_v6_set_gravity(struct wl_client * client, struct wl_resource * resource, uint32_t gravity) override;
-	virtual void zxdg_positioner_v6_set_constraint_adjustment(struct wl_client * client, struct wl_resource * resource, uint32_t constraint_adjustment) override;
-	virtual void zxdg_positioner_v6_set_offset(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y) override;
-	virtual void zxdg_positioner_v6_delete_resource(struct wl_resource * resource) override;
+	void zxdg_positioner_v6_destroy(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_positioner_v6_set_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height);
+	void zxdg_positioner_v6_set_anchor_rect(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y, int32_t width, int32_t height);
+	void zxdg_positioner_v6_set_anchor(struct wl_client * client, struct wl_resource * resource, uint32_t anchor);
+	void zxdg_positioner_v6_set_gravity(struct wl_client * client, struct wl_resource * resource, uint32_t gravity);
+	void zxdg_positioner_v6_set_constraint_adjustment(struct wl_client * client, struct wl_resource * resource, uint32_t constraint_adjustment);
+	void zxdg_positioner_v6_set_offset(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y);
+	void zxdg_positioner_v6_delete_resource(struct wl_resource * resource);
 
 };
 
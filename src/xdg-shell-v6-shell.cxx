@@ -42,7 +42,7 @@ xdg_shell_v6_client_t::xdg_shell_v6_client_t(
 	 * Define the implementation of the resource and the user_data,
 	 * i.e. callbacks that must be used for this resource.
 	 **/
-	zxdg_shell_v6_vtable::set_implementation(self_resource);
+	zxdg_shell_v6_dispatch::set_implementation(self_resource);
 
 }
 
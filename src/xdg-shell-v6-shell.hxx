@@ -25,7 +25,7 @@ namespace page {
 
 using namespace std;
 
-struct xdg_shell_v6_client_t : protected connectable_t, public zxdg_shell_v6_vtable {
+struct xdg_shell_v6_client_t : protected connectable_t, public zxdg_shell_v6_dispatch<xdg_shell_v6_client_t> {
 	page_context_t * _ctx;
 
 	wl_client * client;
@@ -43,12 +43,12 @@ struct xdg_shell_v6_client_t : protected connectable_t, public zxdg_shell_v6_vta
 
 	virtual ~xdg_shell_v6_client_t() = default;
 
-	/* zxdg_shell_v6_vtable */
-	virtual void zxdg_shell_v6_destroy(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_shell_v6_create_positioner(struct wl_client * client, struct wl_resource * resource, uint32_t id) override;
-	virtual void zxdg_shell_v6_get_xdg_surface(struct wl_client * client, struct wl_resource * resource, uint32_t id, struct wl_resource * surface) override;
-	virtual void zxdg_shell_v6_pong(struct wl_client * client, struct wl_resource * resource, uint32_t serial) override;
-	virtual void zxdg_shell_v6_delete_resource(struct wl_resource * resource) override;
+	/* zxdg_shell_v6_dispatch */
+	void zxdg_shell_v6_destroy(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_shell_v6_create_positioner(struct wl_client * client, struct wl_resource * resource, uint32_t id);
+	void zxdg_shell_v6_get_xdg_surface(struct wl_client * client, struct wl_resource * resource, uint32_t id, struct wl_resource * surface);
+	void zxdg_shell_v6_pong(struct wl_client * client, struct wl_resource * resource, uint32_t serial);
+	void zxdg_shell_v6_delete_resource(struct wl_resource * resource);
 
 
 };
@@ -36,7 +36,7 @@ xdg_surface_v6_t::xdg_surface_v6_t(
 	 * Define the implementation of the resource and the user_data,
 	 * i.e. callbacks that must be used for this resource.
 	 **/
-	zxdg_surface_v6_vtable::set_implementation(_resource);
+	zxdg_surface_v6_dispatch::set_implementation(_resource);
 
 	on_surface_destroy.connect(&_surface->destroy_signal, this,
 			&xdg_surface_v6_t::surface_destroyed);
@@ -67,7 +67,7 @@ void xdg_surface_v6_t::popup_destroyed(xdg_popup_v6_t * s) {
 }
 
 auto xdg_surface_v6_t::get(struct wl_resource * r) -> xdg_surface_v6_t * {
-	return dynamic_cast<xdg_surface_v6_t*>(resource_get<zxdg_surface_v6_vtable>(r));
+	return zxdg_surface_v6_dispatch::get(r);
 }
 
 auto xdg_surface_v6_t::create_view() -> view_p {
@@ -43,7 +43,7 @@ using namespace wcxx;
  * client_base_t handle all foreign windows, it's the base of
  * client_managed_t and client_not_managed_t.
  **/
-struct xdg_surface_v6_t : public connectable_t, public zxdg_surface_v6_vtable {
+struct xdg_surface_v6_t : public connectable_t, public zxdg_surface_v6_dispatch<xdg_surface_v6_t> {
 
 	page_context_t *       _ctx;
 
@@ -83,13 +83,13 @@ struct xdg_surface_v6_t : public connectable_t, public zxdg_surface_v6_vtable {
 
 	virtual ~xdg_surface_v6_t();
 
-	/* zxdg_surface_v6_vtable */
-	virtual void zxdg_surface_v6_destroy(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_surface_v6_get_toplevel(struct wl_client * client, struct wl_resource * resource, uint32_t id) override;
-	virtual void zxdg_surface_v6_get_popup(struct wl_client * client, struct wl_resource * resource, uint32_t id, struct wl_resource * parent, struct wl_resource * positioner) override;
-	virtual void zxdg_surface_v6_set_window_geometry(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y, int32_t width, int32_t height) override;
-	virtual void zxdg_surface_v6_ack_configure(struct wl_client * client, struct wl_resource * resource, uint32_t serial) override;
-	virtual void zxdg_surface_v6_delete_resource(struct wl_resource * resource) override;
+	/* zxdg_surface_v6_dispatch */
+	void zxdg_surface_v6_destroy(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_surface_v6_get_toplevel(struct wl_client * client, struct wl_resource * resource, uint32_t id);
+	void zxdg_surface_v6_get_popup(struct wl_client * client, struct wl_resource * resource, uint32_t id, struct wl_resource * parent, struct wl_resource * positioner);
+	void zxdg_surface_v6_set_window_geometry(struct wl_client * client, struct wl_resource * resource, int32_t x, int32_t y, int32_t width, int32_t height);
+	void zxdg_surface_v6_ack_configure(struct wl_client * client, struct wl_resource * resource, uint32_t serial);
+	void zxdg_surface_v6_delete_resource(struct wl_resource * resource);
 
 };
 
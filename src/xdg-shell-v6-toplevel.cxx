@@ -39,7 +39,7 @@ xdg_toplevel_v6_t::xdg_toplevel_v6_t(
 {
 	weston_log("call %s %p\n", __PRETTY_FUNCTION__, this);
 	self_resource = wl_resource_create(client, &zxdg_toplevel_v6_interface, 1, id);
-	zxdg_toplevel_v6_vtable::set_implementation(self_resource);
+	zxdg_toplevel_v6_dispatch::set_implementation(self_resource);
 	connect(_base->destroy, this, &xdg_toplevel_v6_t::surface_destroyed);
 	connect(_base->commited, this, &xdg_toplevel_v6_t::surface_first_commited);
 }
@@ -107,11 +107,12 @@ void xdg_toplevel_v6_t::surface_commited(xdg_surface_v6_t * s) {
 		}
 	}
 
+	_current = _pending;
+
 	if(not _master_view.expired()) {
 		_master_view.lock()->update_view();
+		_master_view.lock()->configure_commited();
 	}
-
-	_current = _pending;
 }
 
 edge_e xdg_toplevel_v6_t::edge_map(uint32_t edge) {
@@ -124,7 +125,7 @@ edge_e xdg_toplevel_v6_t::edge_map(uint32_t edge) {
 }
 
 auto xdg_toplevel_v6_t::get(struct wl_resource * r) -> xdg_toplevel_v6_t * {
-	return dynamic_cast<xdg_toplevel_v6_t*>(resource_get<zxdg_toplevel_v6_vtable>(r));
+	return zxdg_toplevel_v6_dispatch::get(r);
 }
 
 void xdg_toplevel_v6_t::zxdg_toplevel_v6_destroy(struct wl_client * client, struct wl_resource * resource)
@@ -280,5 +281,9 @@ void xdg_toplevel_v6_t::send_configure_popup(int32_t x, int32_t y, int32_t width
 	/* should not be called */
 }
 
+bool xdg_toplevel_v6_t::has_pending_configure() const {
+	return _base->_ack_config != 0;
+}
+
 }
 
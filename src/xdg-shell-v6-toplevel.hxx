@@ -17,7 +17,7 @@ namespace page {
 using namespace std;
 using namespace wcxx;
 
-struct xdg_toplevel_v6_t : public connectable_t, public zxdg_toplevel_v6_vtable, public surface_t {
+struct xdg_toplevel_v6_t : public connectable_t, public zxdg_toplevel_v6_dispatch<xdg_toplevel_v6_t>, public surface_t {
 	xdg_surface_v6_t *     _base;
 
 	page_context_t *       _ctx;
@@ -69,22 +69,22 @@ struct xdg_toplevel_v6_t : public connectable_t, public zxdg_toplevel_v6_vtable,
 
 	virtual ~xdg_toplevel_v6_t();
 
-	/* zxdg_toplevel_v6_vtable */
-	virtual void zxdg_toplevel_v6_destroy(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_toplevel_v6_set_parent(struct wl_client * client, struct wl_resource * resource, struct wl_resource * parent) override;
-	virtual void zxdg_toplevel_v6_set_title(struct wl_client * client, struct wl_resource * resource, const char * title) override;
-	virtual void zxdg_toplevel_v6_set_app_id(struct wl_client * client, struct wl_resource * resource, const char * app_id) override;
-	virtual void zxdg_toplevel_v6_show_window_menu(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, int32_t x, int32_t y) override;
-	virtual void zxdg_toplevel_v6_move(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial) override;
-	virtual void zxdg_toplevel_v6_resize(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, uint32_t edges) override;
-	virtual void zxdg_toplevel_v6_set_max_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height) override;
-	virtual void zxdg_toplevel_v6_set_min_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height) override;
-	virtual void zxdg_toplevel_v6_set_maximized(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_toplevel_v6_unset_maximized(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_toplevel_v6_set_fullscreen(struct wl_client * client, struct wl_resource * resource, struct wl_resource * output) override;
-	virtual void zxdg_toplevel_v6_unset_fullscreen(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_toplevel_v6_set_minimized(struct wl_client * client, struct wl_resource * resource) override;
-	virtual void zxdg_toplevel_v6_delete_resource(struct wl_resource * resource) override;
+	/* zxdg_toplevel_v6_dispatch */
+	void zxdg_toplevel_v6_destroy(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_toplevel_v6_set_parent(struct wl_client * client, struct wl_resource * resource, struct wl_resource * parent);
+	void zxdg_toplevel_v6_set_title(struct wl_client * client, struct wl_resource * resource, const char * title);
+	void zxdg_toplevel_v6_set_app_id(struct wl_client * client, struct wl_resource * resource, const char * app_id);
+	void zxdg_toplevel_v6_show_window_menu(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, int32_t x, int32_t y);
+	void zxdg_toplevel_v6_move(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial);
+	void zxdg_toplevel_v6_resize(struct wl_client * client, struct wl_resource * resource, struct wl_resource * seat, uint32_t serial, uint32_t edges);
+	void zxdg_toplevel_v6_set_max_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height);
+	void zxdg_toplevel_v6_set_min_size(struct wl_client * client, struct wl_resource * resource, int32_t width, int32_t height);
+	void zxdg_toplevel_v6_set_maximized(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_toplevel_v6_unset_maximized(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_toplevel_v6_set_fullscreen(struct wl_client * client, struct wl_resource * resource, struct wl_resource * output);
+	void zxdg_toplevel_v6_unset_fullscreen(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_toplevel_v6_set_minimized(struct wl_client * client, struct wl_resource * resource);
+	void zxdg_toplevel_v6_delete_resource(struct wl_resource * resource);
 
 	/* page_surface_interface */
 	virtual weston_surface * surface() const override;
@@ -95,6 +95,7 @@ struct xdg_toplevel_v6_t : public connectable_t, public zxdg_toplevel_v6_vtable,
 	virtual void send_configure(int32_t width, int32_t height, set<uint32_t> const & states) override;
 	virtual void send_close() override;
 	virtual void send_configure_popup(int32_t x, int32_t y, int32_t width, int32_t height) override;
+	virtual bool has_pending_configure() const override;
 
 };
 
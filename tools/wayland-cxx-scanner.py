@@ -48,7 +48,44 @@ maptype = {
  'object': None
 }
 
-def gen_header(fi_name, fo):
+def gen_static_dispatch(interface, fo):
+ interface_name = interface.attrib['name']
+ requests = interface.findall('request')
+ fo.write("""
+/**
+ * Static dispatch for {0}: derive T from {0}_dispatch<T> instead of
+ * {0}_vtable, request handlers are called directly on T without
+ * virtual call, and get() does not need dynamic_cast.
+ **/
+template<typename T>
+struct {0}_dispatch {{
+	static auto get(struct wl_resource * resource) -> T * {{
+		return static_cast<T *>(static_cast<{0}_dispatch *>(wl_resource_get_user_data(resource)));
+	}}
+
+""".format(interface_name))
+ for request in requests:
+  args = request.findall('arg')
+  args_with_type = gen_args_with_type(args, ['struct wl_client * client', 'struct wl_resource * resource'])
+  args_no_type = gen_args(args, ['client', 'resource'])
+  fo.write('\tstatic void _{1}({2}) {{\n'.format(interface_name, request.attrib['name'], args_with_type))
+  fo.write('\t\tget(resource)->{0}_{1}({2});\n'.format(interface_name, request.attrib['name'], args_no_type))
+  fo.write('\t}\n\n')
+ fo.write('\tstatic void _delete_resource(struct wl_resource * resource) {\n')
+ fo.write('\t\tget(resource)->{0}_delete_resource(resource);\n'.format(interface_name))
+ fo.write('\t}\n\n')
+ fo.write('\tvoid set_implementation(struct wl_resource * resource) {\n')
+ fo.write('\t\tstatic struct {0}_interface const implementation = {{\n'.format(interface_name))
+ fo.write(',\n'.join(['\t\t\t&_{0}'.format(r.attrib['name']) for r in requests]))
+ if len(requests) > 0:
+  fo.write('\n')
+ fo.write('\t\t};\n')
+ fo.write('\t\twl_resource_set_implementation(resource, &implementation,\n')
+ fo.write('\t\t\t\tthis, &_delete_resource);\n')
+ fo.write('\t}\n')
+ fo.write('};\n')
+
+def gen_header(fi_name, fo, static_dispatch = False):
  fi_xname = os.path.basename(fi_name)[:-4]
  fi_uname = r_invalid.sub('_', fi_xname).upper()
  tree = ET.parse(fi_name)
@@ -81,9 +118,14 @@ def gen_header(fi_name, fo):
 #define WCXX_{UNAME}_HXX_
 
 #include <libweston-2/compositor.h>
-
-namespace wcxx {{
 """.format(UNAME = fi_uname))
+
+ if static_dispatch:
+  fo.write('#include "{XNAME}-server-protocol.h"\n'.format(XNAME = fi_xname))
+
+ fo.write("""
+namespace wcxx {
+""")
  
  for interface in root.findall('interface'):
   interface_name = interface.attrib['name']
@@ -98,6 +140,8 @@ namespace wcxx {{
   fo.write('\tvirtual void {0}_delete_resource(struct wl_resource * resource) = 0;\n'.format(interface_name))
   fo.write('\tvoid set_implementation(struct wl_resource * resource);\n')
   fo.write('};\n')
+  if static_dispatch:
+   gen_static_dispatch(interface, fo)
  fo.write("}}\n#endif /* WCXX_{UNAME}_HXX_ */\n".format(UNAME = fi_uname))
 
 def gen_impl(fi_name, fo):
@@ -175,12 +219,16 @@ wl_resource_set_implementation(resource,
 """.format(interface_name))
  fo.write('}\n')
  
-fi_name = sys.argv[2]
-fi_xname = os.path.basename(fi_name)[:-4]
-
-if sys.argv[1] == 'header':
- gen_header(fi_name, sys.stdout)
+parser = argparse.ArgumentParser(description='Generate wayland API C++ to C wrapper')
+parser.add_argument('mode', choices=['header', 'code'])
+parser.add_argument('input')
+parser.add_argument('--static-dispatch', dest='static_dispatch', action='store_true',
+        help='also generate CRTP <interface>_dispatch<T> templates in header')
+args = parser.parse_args()
+
+if args.mode == 'header':
+ gen_header(args.input, sys.stdout, args.static_dispatch)
 else:
- gen_impl(fi_name, sys.stdout)
+ gen_impl(args.input, sys.stdout)
 
 